@@ -37,8 +37,10 @@ cmdline_parse_ctx_t modules_ctx[] = {
 	(cmdline_parse_inst_t *)&ethdev_rx_cmd_ctx,
 	(cmdline_parse_inst_t *)&ethdev_rx_help_cmd_ctx,
 	(cmdline_parse_inst_t *)&ipv4_lookup_cmd_ctx,
+	(cmdline_parse_inst_t *)&ipv4_lookup_mode_cmd_ctx,
 	(cmdline_parse_inst_t *)&ipv4_lookup_help_cmd_ctx,
 	(cmdline_parse_inst_t *)&ipv6_lookup_cmd_ctx,
+	(cmdline_parse_inst_t *)&ipv6_lookup_mode_cmd_ctx,
 	(cmdline_parse_inst_t *)&ipv6_lookup_help_cmd_ctx,
 	(cmdline_parse_inst_t *)&neigh_v4_cmd_ctx,
 	(cmdline_parse_inst_t *)&neigh_v6_cmd_ctx,
@@ -10,6 +10,7 @@
 #include <cmdline_parse_num.h>
 #include <cmdline_parse_string.h>
 #include <cmdline_socket.h>
+#include <rte_lcore.h>
 #include <rte_node_ip4_api.h>
 
 #include "module_api.h"
@@ -18,8 +19,16 @@
 static const char
 cmd_ipv4_lookup_help[] = "ipv4_lookup route add ipv4 <ip> netmask <mask> via <ip>";
 
+static const char
+cmd_ipv4_lookup_mode_help[] = "ipv4_lookup mode <lpm|fib>";
+
+#define IPV4_LOOKUP_FIB_MAX_ROUTES (1 << 20)
+#define IPV4_LOOKUP_FIB_NUM_TBL8 (1 << 15)
+
 struct ip4_route route4 = TAILQ_HEAD_INITIALIZER(route4);
 
+static enum ip4_lookup_mode ip4_lookup_mode = IP4_LOOKUP_MODE_LPM;
+
 
 void
 route_ip4_list_clean(void)
@@ -72,6 +81,10 @@ route4_rewirte_table_update(struct route_ipv4_config *ipv4route)
 
 	depth = convert_netmask_to_depth(ipv4route->netmask);
 
+	if (ip4_lookup_mode == IP4_LOOKUP_MODE_FIB)
+		return rte_node_ip4_fib_route_add(ipv4route->ip, depth, portid,
+				RTE_NODE_IP4_LOOKUP_NEXT_REWRITE);
+
 	return rte_node_ip4_route_add(ipv4route->ip, depth, portid,
 			RTE_NODE_IP4_LOOKUP_NEXT_REWRITE);
 }
@@ -127,6 +140,32 @@ route_ip4_add_to_lookup(void)
 	return 0;
 }
 
+int
+route_ip4_lookup_setup(void)
+{
+	struct rte_fib_conf conf;
+	uint32_t lcore_id;
+	int rc;
+
+	if (ip4_lookup_mode != IP4_LOOKUP_MODE_FIB)
+		return 0;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.type = RTE_FIB_DIR24_8;
+	conf.max_routes = IPV4_LOOKUP_FIB_MAX_ROUTES;
+	conf.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	conf.dir24_8.num_tbl8 = IPV4_LOOKUP_FIB_NUM_TBL8;
+
+	/* One FIB per socket having lcores to run graphs */
+	RTE_LCORE_FOREACH(lcore_id) {
+		rc = rte_node_ip4_fib_create(rte_lcore_to_socket_id(lcore_id), &conf);
+		if (rc < 0)
+			return rc;
+	}
+
+	return 0;
+}
+
 static void
 cli_ipv4_lookup_help(__rte_unused void *parsed_result, __rte_unused struct cmdline *cl,
 		     __rte_unused void *data)
@@ -135,9 +174,9 @@ cli_ipv4_lookup_help(__rte_unused void *parsed_result, __rte_unused struct cmdli
 
 	len = strlen(conn->msg_out);
 	conn->msg_out += len;
-	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n",
+	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n%s\n",
 		 "--------------------------- ipv4_lookup command help ---------------------------",
-		 cmd_ipv4_lookup_help);
+		 cmd_ipv4_lookup_help, cmd_ipv4_lookup_mode_help);
 
 	len = strlen(conn->msg_out);
 	conn->msg_out_len_max -= len;
@@ -170,6 +209,23 @@ cli_ipv4_lookup(void *parsed_result, __rte_unused struct cmdline *cl, void *data
 		printf(MSG_CMD_FAIL, res->cmd);
 }
 
+static void
+cli_ipv4_lookup_mode(void *parsed_result, __rte_unused struct cmdline *cl,
+		     void *data __rte_unused)
+{
+	struct ip4_lookup_mode_cmd_tokens *res = parsed_result;
+
+	if (graph_status_get()) {
+		printf(MSG_CMD_FAIL, res->cmd);
+		return;
+	}
+
+	if (strcmp(res->lkup_mode, "fib") == 0)
+		ip4_lookup_mode = IP4_LOOKUP_MODE_FIB;
+	else
+		ip4_lookup_mode = IP4_LOOKUP_MODE_LPM;
+}
+
 cmdline_parse_token_string_t ip4_lookup_cmd =
 	TOKEN_STRING_INITIALIZER(struct ip4_lookup_cmd_tokens, cmd, "ipv4_lookup");
 cmdline_parse_token_string_t ip4_lookup_route =
@@ -207,6 +263,25 @@ cmdline_parse_inst_t ipv4_lookup_cmd_ctx = {
 	},
 };
 
+cmdline_parse_token_string_t ip4_lookup_mode_cmd =
+	TOKEN_STRING_INITIALIZER(struct ip4_lookup_mode_cmd_tokens, cmd, "ipv4_lookup");
+cmdline_parse_token_string_t ip4_lookup_mode_mode =
+	TOKEN_STRING_INITIALIZER(struct ip4_lookup_mode_cmd_tokens, mode, "mode");
+cmdline_parse_token_string_t ip4_lookup_mode_name =
+	TOKEN_STRING_INITIALIZER(struct ip4_lookup_mode_cmd_tokens, lkup_mode, "lpm#fib");
+
+cmdline_parse_inst_t ipv4_lookup_mode_cmd_ctx = {
+	.f = cli_ipv4_lookup_mode,
+	.data = NULL,
+	.help_str = cmd_ipv4_lookup_mode_help,
+	.tokens = {
+		(void *)&ip4_lookup_mode_cmd,
+		(void *)&ip4_lookup_mode_mode,
+		(void *)&ip4_lookup_mode_name,
+		NULL,
+	},
+};
+
 cmdline_parse_token_string_t ipv4_lookup_help_cmd =
 	TOKEN_STRING_INITIALIZER(struct ipv4_lookup_help_cmd_tokens, cmd, "help");
 cmdline_parse_token_string_t ipv4_lookup_help_module =
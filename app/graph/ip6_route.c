@@ -10,6 +10,7 @@
 #include <cmdline_parse_string.h>
 #include <cmdline_socket.h>
 
+#include <rte_lcore.h>
 #include <rte_node_ip6_api.h>
 
 #include "module_api.h"
@@ -18,8 +19,16 @@
 static const char
 cmd_ipv6_lookup_help[] = "ipv6_lookup route add ipv6 <ip> netmask <mask> via <ip>";
 
+static const char
+cmd_ipv6_lookup_mode_help[] = "ipv6_lookup mode <lpm|fib>";
+
+#define IPV6_LOOKUP_FIB_MAX_ROUTES (1 << 18)
+#define IPV6_LOOKUP_FIB_NUM_TBL8 (1 << 16)
+
 struct ip6_route route6 = TAILQ_HEAD_INITIALIZER(route6);
 
+static enum ip6_lookup_mode ip6_lookup_mode = IP6_LOOKUP_MODE_LPM;
+
 void
 route_ip6_list_clean(void)
 {
@@ -74,6 +83,10 @@ route6_rewirte_table_update(struct route_ipv6_config *ipv6route)
 	}
 	depth = convert_ip6_netmask_to_depth(ipv6route->mask);
 
+	if (ip6_lookup_mode == IP6_LOOKUP_MODE_FIB)
+		return rte_node_ip6_fib_route_add(ipv6route->ip, depth, portid,
+				RTE_NODE_IP6_LOOKUP_NEXT_REWRITE);
+
 	return rte_node_ip6_route_add(ipv6route->ip, depth, portid,
 			RTE_NODE_IP6_LOOKUP_NEXT_REWRITE);
 
@@ -132,6 +145,32 @@ route_ip6_add_to_lookup(void)
 	return 0;
 }
 
+int
+route_ip6_lookup_setup(void)
+{
+	struct rte_fib6_conf conf;
+	uint32_t lcore_id;
+	int rc;
+
+	if (ip6_lookup_mode != IP6_LOOKUP_MODE_FIB)
+		return 0;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.type = RTE_FIB6_TRIE;
+	conf.max_routes = IPV6_LOOKUP_FIB_MAX_ROUTES;
+	conf.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	conf.trie.num_tbl8 = IPV6_LOOKUP_FIB_NUM_TBL8;
+
+	/* One FIB per socket having lcores to run graphs */
+	RTE_LCORE_FOREACH(lcore_id) {
+		rc = rte_node_ip6_fib_create(rte_lcore_to_socket_id(lcore_id), &conf);
+		if (rc < 0)
+			return rc;
+	}
+
+	return 0;
+}
+
 static void
 cli_ipv6_lookup_help(__rte_unused void *parsed_result, __rte_unused struct cmdline *cl,
 		     __rte_unused void *data)
@@ -140,9 +179,9 @@ cli_ipv6_lookup_help(__rte_unused void *parsed_result, __rte_unused struct cmdli
 
 	len = strlen(conn->msg_out);
 	conn->msg_out += len;
-	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n",
+	snprintf(conn->msg_out, conn->msg_out_len_max, "\n%s\n%s\n%s\n",
 		 "--------------------------- ipv6_lookup command help ---------------------------",
-		 cmd_ipv6_lookup_help);
+		 cmd_ipv6_lookup_help, cmd_ipv6_lookup_mode_help);
 
 	len = strlen(conn->msg_out);
 	conn->msg_out_len_max -= len;
@@ -175,6 +214,23 @@ cli_ipv6_lookup(void *parsed_result, __rte_unused struct cmdline *cl, void *data
 		printf(MSG_CMD_FAIL, res->cmd);
 }
 
+static void
+cli_ipv6_lookup_mode(void *parsed_result, __rte_unused struct cmdline *cl,
+		     void *data __rte_unused)
+{
+	struct ip6_lookup_mode_cmd_tokens *res = parsed_result;
+
+	if (graph_status_get()) {
+		printf(MSG_CMD_FAIL, res->cmd);
+		return;
+	}
+
+	if (strcmp(res->lkup_mode, "fib") == 0)
+		ip6_lookup_mode = IP6_LOOKUP_MODE_FIB;
+	else
+		ip6_lookup_mode = IP6_LOOKUP_MODE_LPM;
+}
+
 cmdline_parse_token_string_t ip6_lookup_cmd =
 	TOKEN_STRING_INITIALIZER(struct ip6_lookup_cmd_tokens, cmd, "ipv6_lookup");
 cmdline_parse_token_string_t ip6_lookup_route =
@@ -212,6 +268,25 @@ cmdline_parse_inst_t ipv6_lookup_cmd_ctx = {
 	},
 };
 
+cmdline_parse_token_string_t ip6_lookup_mode_cmd =
+	TOKEN_STRING_INITIALIZER(struct ip6_lookup_mode_cmd_tokens, cmd, "ipv6_lookup");
+cmdline_parse_token_string_t ip6_lookup_mode_mode =
+	TOKEN_STRING_INITIALIZER(struct ip6_lookup_mode_cmd_tokens, mode, "mode");
+cmdline_parse_token_string_t ip6_lookup_mode_name =
+	TOKEN_STRING_INITIALIZER(struct ip6_lookup_mode_cmd_tokens, lkup_mode, "lpm#fib");
+
+cmdline_parse_inst_t ipv6_lookup_mode_cmd_ctx = {
+	.f = cli_ipv6_lookup_mode,
+	.data = NULL,
+	.help_str = cmd_ipv6_lookup_mode_help,
+	.tokens = {
+		(void *)&ip6_lookup_mode_cmd,
+		(void *)&ip6_lookup_mode_mode,
+		(void *)&ip6_lookup_mode_name,
+		NULL,
+	},
+};
+
 cmdline_parse_token_string_t ipv6_lookup_help_cmd =
 	TOKEN_STRING_INITIALIZER(struct ipv6_lookup_help_cmd_tokens, cmd, "help");
 cmdline_parse_token_string_t ipv6_lookup_help_module =
@@ -53,6 +53,15 @@ l3fwd_pattern_configure(void)
 	graph_conf.num_pkt_to_capture = pcap_pkts_count;
 	graph_conf.pcap_filename = strdup(pcap_file);
 
+	/* Lookup tables must exist before graph nodes are initialized */
+	rc = route_ip4_lookup_setup();
+	if (rc < 0)
+		rte_exit(EXIT_FAILURE, "Unable to setup v4 lookup table\n");
+
+	rc = route_ip6_lookup_setup();
+	if (rc < 0)
+		rte_exit(EXIT_FAILURE, "Unable to setup v6 lookup table\n");
+
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
 		rte_graph_t graph_id;
 		rte_edge_t i;
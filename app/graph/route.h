@@ -8,7 +8,9 @@
 #define MAX_ROUTE_ENTRIES 32
 
 extern cmdline_parse_inst_t ipv4_lookup_cmd_ctx;
+extern cmdline_parse_inst_t ipv4_lookup_mode_cmd_ctx;
 extern cmdline_parse_inst_t ipv6_lookup_cmd_ctx;
+extern cmdline_parse_inst_t ipv6_lookup_mode_cmd_ctx;
 extern cmdline_parse_inst_t ipv4_lookup_help_cmd_ctx;
 extern cmdline_parse_inst_t ipv6_lookup_help_cmd_ctx;
 
@@ -32,7 +34,9 @@ struct route_ipv6_config {
 
 TAILQ_HEAD(ip6_route, route_ipv6_config);
 
+int route_ip4_lookup_setup(void);
 int route_ip4_add_to_lookup(void);
+int route_ip6_lookup_setup(void);
 int route_ip6_add_to_lookup(void);
 void route_ip4_list_clean(void);
 void route_ip6_list_clean(void);
@@ -19,6 +19,17 @@ struct ip4_lookup_cmd_tokens {
 	cmdline_fixed_string_t via_ip;
 };
 
+struct ip4_lookup_mode_cmd_tokens {
+	cmdline_fixed_string_t cmd;
+	cmdline_fixed_string_t mode;
+	cmdline_fixed_string_t lkup_mode;
+};
+
+enum ip4_lookup_mode {
+	IP4_LOOKUP_MODE_LPM,
+	IP4_LOOKUP_MODE_FIB,
+};
+
 struct ip6_lookup_cmd_tokens {
 	cmdline_fixed_string_t cmd;
 	cmdline_fixed_string_t route;
@@ -31,6 +42,17 @@ struct ip6_lookup_cmd_tokens {
 	cmdline_fixed_string_t via_ip;
 };
 
+struct ip6_lookup_mode_cmd_tokens {
+	cmdline_fixed_string_t cmd;
+	cmdline_fixed_string_t mode;
+	cmdline_fixed_string_t lkup_mode;
+};
+
+enum ip6_lookup_mode {
+	IP6_LOOKUP_MODE_LPM,
+	IP6_LOOKUP_MODE_FIB,
+};
+
 struct ipv4_lookup_help_cmd_tokens {
 	cmdline_fixed_string_t cmd;
 	cmdline_fixed_string_t module;
@@ -695,6 +695,280 @@ test_graph_clone(void)
 	return ret;
 }
 
+static int
+test_graph_model_work_steal(void)
+{
+	rte_graph_t cloned_graph_id[2] = {RTE_GRAPH_ID_INVALID, RTE_GRAPH_ID_INVALID};
+	struct rte_graph_param graph_conf = {0};
+	rte_node_t nid = RTE_NODE_ID_INVALID;
+	char node_name[64] = "test_node00";
+	struct rte_graph *graph, *peer;
+	unsigned int nb_peers;
+	struct rte_node *node;
+	int ret, i;
+
+	if (rte_graph_model_work_steal_node_enable("test_node_source1", NULL) == 0) {
+		printf("Source node must not be stolen\n");
+		return -1;
+	}
+
+	ret = rte_graph_model_work_steal_node_enable(node_name, NULL);
+	if (ret != 0) {
+		printf("Enable steal on node %s failed\n", node_name);
+		return -1;
+	}
+
+	ret = rte_graph_worker_model_set(RTE_GRAPH_MODEL_WORK_STEAL);
+	if (ret != 0) {
+		printf("Set graph work steal model failed\n");
+		return -1;
+	}
+
+	graph_conf.steal.thresh = 16;
+	graph_conf.steal.max_batch = 2;
+	cloned_graph_id[0] = rte_graph_clone(graph_id, "cloned-steal0", &graph_conf);
+	cloned_graph_id[1] = rte_graph_clone(graph_id, "cloned-steal1", &graph_conf);
+	if (cloned_graph_id[0] == RTE_GRAPH_ID_INVALID ||
+	    cloned_graph_id[1] == RTE_GRAPH_ID_INVALID) {
+		printf("Graph clone failed with error = %d\n", rte_errno);
+		ret = -1;
+		goto fail;
+	}
+
+	nid = rte_node_from_name(node_name);
+	for (i = 0; i < 2; i++) {
+		node = rte_graph_node_get(cloned_graph_id[i], nid);
+		if (node == NULL || !__rte_node_ext(node)->steal.enable) {
+			printf("Node %s not stealable in cloned graph\n", node_name);
+			ret = -1;
+			goto fail;
+		}
+
+		graph = rte_graph_lookup(rte_graph_id_to_name(cloned_graph_id[i]));
+		if (graph->steal.wq == NULL || graph->steal.thresh != 16 ||
+		    graph->steal.max_batch != 2) {
+			printf("Graph %s steal queue not configured\n", graph->name);
+			ret = -1;
+			goto fail;
+		}
+
+		nb_peers = 0;
+		SLIST_FOREACH(peer, graph->steal.rq, next)
+			nb_peers++;
+		if (nb_peers != 2) {
+			printf("Graph %s steal group has %u graphs\n", graph->name, nb_peers);
+			ret = -1;
+			goto fail;
+		}
+	}
+
+fail:
+	for (i = 0; i < 2; i++)
+		if (cloned_graph_id[i] != RTE_GRAPH_ID_INVALID)
+			rte_graph_destroy(cloned_graph_id[i]);
+	rte_graph_worker_model_set(RTE_GRAPH_MODEL_DEFAULT);
+
+	return ret;
+}
+
+#define STEAL_NB_KEYS 8
+#define STEAL_MAX_OBJS 64
+#define STEAL_OBJ(seq) ((void *)(uintptr_t)(seq))
+#define STEAL_OBJ_SEQ(obj) ((uint32_t)(uintptr_t)(obj))
+#define STEAL_OBJ_KEY(obj) ((STEAL_OBJ_SEQ(obj) - 1) % STEAL_NB_KEYS)
+
+static uint32_t steal_src_nb, steal_src_seq;
+static void *steal_sink_objs[STEAL_MAX_OBJS];
+static uint32_t steal_sink_nb;
+
+static uint16_t
+test_steal_source_worker(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t nb_objs)
+{
+	void **next_stream;
+	uint32_t i;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	if (steal_src_nb == 0)
+		return 0;
+
+	next_stream = rte_node_next_stream_get(graph, node, 0, steal_src_nb);
+	for (i = 0; i < steal_src_nb; i++)
+		next_stream[i] = STEAL_OBJ(++steal_src_seq);
+	rte_node_next_stream_put(graph, node, 0, steal_src_nb);
+
+	nb_objs = steal_src_nb;
+	steal_src_nb = 0;
+
+	return nb_objs;
+}
+
+static uint16_t
+test_steal_node_worker(struct rte_graph *graph, struct rte_node *node,
+		       void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+
+	rte_node_next_stream_move(graph, node, 0);
+
+	return nb_objs;
+}
+
+static uint16_t
+test_steal_sink_worker(struct rte_graph *graph, struct rte_node *node,
+		       void **objs, uint16_t nb_objs)
+{
+	uint16_t i;
+
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	for (i = 0; i < nb_objs && steal_sink_nb < STEAL_MAX_OBJS; i++)
+		steal_sink_objs[steal_sink_nb++] = objs[i];
+
+	return nb_objs;
+}
+
+static uint32_t
+test_steal_key(void *obj)
+{
+	return STEAL_OBJ_KEY(obj);
+}
+
+static struct rte_node_register test_steal_source = {
+	.name = "test_steal_source",
+	.process = test_steal_source_worker,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_steal_node"},
+};
+RTE_NODE_REGISTER(test_steal_source);
+
+static struct rte_node_register test_steal_node = {
+	.name = "test_steal_node",
+	.process = test_steal_node_worker,
+	.nb_edges = 1,
+	.next_nodes = {"test_steal_sink"},
+};
+RTE_NODE_REGISTER(test_steal_node);
+
+static struct rte_node_register test_steal_sink = {
+	.name = "test_steal_sink",
+	.process = test_steal_sink_worker,
+};
+RTE_NODE_REGISTER(test_steal_sink);
+
+static int
+test_graph_model_work_steal_order(void)
+{
+	const char *patterns[] = {"test_steal_source", "test_steal_node",
+				  "test_steal_sink"};
+	rte_graph_t cloned_graph_id[2] = {RTE_GRAPH_ID_INVALID, RTE_GRAPH_ID_INVALID};
+	rte_graph_t parent_id = RTE_GRAPH_ID_INVALID;
+	uint32_t last_seq[STEAL_NB_KEYS] = {0};
+	struct rte_graph_param graph_conf = {0};
+	struct rte_graph *graph[2];
+	struct rte_node *node;
+	uint32_t i, key, seq;
+	int ret = -1;
+
+	steal_src_nb = 0;
+	steal_src_seq = 0;
+	steal_sink_nb = 0;
+
+	if (rte_graph_model_work_steal_node_enable("test_steal_node", test_steal_key)) {
+		printf("Enable steal on node test_steal_node failed\n");
+		return -1;
+	}
+
+	graph_conf.socket_id = SOCKET_ID_ANY;
+	graph_conf.nb_node_patterns = RTE_DIM(patterns);
+	graph_conf.node_patterns = patterns;
+	parent_id = rte_graph_create("steal_parent", &graph_conf);
+	if (parent_id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph create failed with error = %d\n", rte_errno);
+		return -1;
+	}
+
+	if (rte_graph_worker_model_set(RTE_GRAPH_MODEL_WORK_STEAL)) {
+		printf("Set graph work steal model failed\n");
+		goto fail;
+	}
+
+	/* Keep 4 objects locally, the lanes of the following flows are offered */
+	graph_conf.steal.thresh = 4;
+	graph_conf.steal.max_batch = 2;
+	cloned_graph_id[0] = rte_graph_clone(parent_id, "a", &graph_conf);
+	cloned_graph_id[1] = rte_graph_clone(parent_id, "b", &graph_conf);
+	if (cloned_graph_id[0] == RTE_GRAPH_ID_INVALID ||
+	    cloned_graph_id[1] == RTE_GRAPH_ID_INVALID) {
+		printf("Graph clone failed with error = %d\n", rte_errno);
+		goto fail;
+	}
+
+	for (i = 0; i < 2; i++)
+		graph[i] = rte_graph_lookup(rte_graph_id_to_name(cloned_graph_id[i]));
+
+	/* Flows 0 to 3 run locally, flows 4 to 7 are offered */
+	steal_src_nb = 36;
+	rte_graph_walk(graph[0]);
+
+	/*
+	 * With a thief holding the queue of graph a, the objects of flows in
+	 * flight must be queued behind, even for a stream below the threshold.
+	 */
+	rte_spinlock_lock(&graph[0]->steal.lock);
+	steal_src_nb = 4;
+	rte_graph_walk(graph[0]);
+	rte_spinlock_unlock(&graph[0]->steal.lock);
+
+	for (i = 0; i < steal_sink_nb; i++) {
+		if (STEAL_OBJ_KEY(steal_sink_objs[i]) >= STEAL_NB_KEYS / 2) {
+			printf("Object %u of a flow in flight processed locally\n",
+			       STEAL_OBJ_SEQ(steal_sink_objs[i]));
+			goto fail;
+		}
+	}
+
+	/* Idle graph b steals the offered streams of graph a */
+	rte_graph_walk(graph[1]);
+
+	if (steal_sink_nb != steal_src_seq) {
+		printf("Got %u objects out of %u\n", steal_sink_nb, steal_src_seq);
+		goto fail;
+	}
+
+	for (i = 0; i < steal_sink_nb; i++) {
+		key = STEAL_OBJ_KEY(steal_sink_objs[i]);
+		seq = STEAL_OBJ_SEQ(steal_sink_objs[i]);
+		if (seq <= last_seq[key]) {
+			printf("Object %u of flow %u after object %u\n", seq, key,
+			       last_seq[key]);
+			goto fail;
+		}
+		last_seq[key] = seq;
+	}
+
+	node = rte_graph_node_get(cloned_graph_id[1], rte_node_from_name("test_steal_node"));
+	if (__rte_node_ext(node)->steal.total_stolen_objs != 20) {
+		printf("Stolen %" PRIu64 " objects, expected 20\n",
+		       __rte_node_ext(node)->steal.total_stolen_objs);
+		goto fail;
+	}
+
+	ret = 0;
+fail:
+	for (i = 0; i < 2; i++)
+		if (cloned_graph_id[i] != RTE_GRAPH_ID_INVALID)
+			rte_graph_destroy(cloned_graph_id[i]);
+	rte_graph_destroy(parent_id);
+	rte_graph_worker_model_set(RTE_GRAPH_MODEL_DEFAULT);
+
+	return ret;
+}
+
 static int
 test_graph_model_mcore_dispatch_node_lcore_affinity_set(void)
 {
@@ -814,6 +1088,180 @@ test_graph_walk(void)
 	return 0;
 }
 
+static int
+test_graph_model_rtc_coalesce(void)
+{
+	struct rte_graph *graph = rte_graph_lookup("worker0");
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+	int i;
+
+	if (!graph) {
+		printf("Graph lookup failed\n");
+		return -1;
+	}
+
+	if (rte_graph_worker_model_set(RTE_GRAPH_MODEL_RTC)) {
+		printf("Set graph rtc model failed\n");
+		return -1;
+	}
+
+	if (rte_graph_model_rtc_coalesce_set(graph_id, 16, 0, 0) == 0) {
+		printf("Unbounded coalescing must be rejected\n");
+		return -1;
+	}
+
+	if (rte_graph_model_rtc_coalesce_set(graph_id, 16, 1, 0)) {
+		printf("Coalescing set failed\n");
+		return -1;
+	}
+
+	if (graph->coalesce.thresh != 16 || graph->coalesce.max_walks != 1) {
+		printf("Coalescing policy not applied to graph %s\n", graph->name);
+		return -1;
+	}
+
+	for (i = 0; i < 5; i++)
+		rte_graph_walk(graph);
+
+	/* Deferred streams are flushed by the first walk without coalescing */
+	rte_graph_model_rtc_coalesce_set(graph_id, 0, 0, 0);
+	rte_graph_walk(graph);
+
+	rte_graph_foreach_node(count, off, graph, node) {
+		if (node->idx != 0) {
+			printf("Node %s still holds %u objs\n", node->name, node->idx);
+			return -1;
+		}
+	}
+
+	/* Re-enabling starts without the deferrals of the last policy */
+	if (rte_graph_model_rtc_coalesce_set(graph_id, 16, 1, 0)) {
+		printf("Coalescing re-enable failed\n");
+		return -1;
+	}
+	rte_graph_foreach_node(count, off, graph, node) {
+		if (__rte_node_ext(node)->coalesce.walks != 0) {
+			printf("Node %s kept its deferral state\n", node->name);
+			return -1;
+		}
+	}
+	rte_graph_model_rtc_coalesce_set(graph_id, 0, 0, 0);
+
+	return 0;
+}
+
+static int
+test_graph_model_rtc_coalesce_model_change(void)
+{
+	rte_graph_t cloned_graph_id = RTE_GRAPH_ID_INVALID;
+	struct rte_graph *graph = rte_graph_lookup("worker0");
+	struct rte_graph_param graph_conf = {0};
+	struct rte_graph *cloned_graph;
+	int ret = -1;
+
+	if (!graph) {
+		printf("Graph lookup failed\n");
+		return -1;
+	}
+
+	if (rte_graph_worker_model_set(RTE_GRAPH_MODEL_RTC) ||
+	    rte_graph_model_rtc_coalesce_set(graph_id, 16, 4, 0)) {
+		printf("Coalescing set failed\n");
+		return -1;
+	}
+
+	/* The policy left by rtc model must not be seen as dispatch state */
+	if (rte_graph_worker_model_set(RTE_GRAPH_MODEL_MCORE_DISPATCH)) {
+		printf("Set graph mcore dispatch model failed\n");
+		goto fail;
+	}
+
+	graph_conf.dispatch.mp_capacity = 1024;
+	graph_conf.dispatch.wq_size_max = 32;
+	cloned_graph_id = rte_graph_clone(graph_id, "cloned-coalesce", &graph_conf);
+	if (cloned_graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph clone failed with error = %d\n", rte_errno);
+		goto fail;
+	}
+
+	cloned_graph = rte_graph_lookup(rte_graph_id_to_name(cloned_graph_id));
+	if (graph->dispatch.rq != &graph->dispatch.rq_head ||
+	    cloned_graph->dispatch.rq != graph->dispatch.rq ||
+	    SLIST_FIRST(graph->dispatch.rq) != cloned_graph) {
+		printf("Graph %s run-queue not set up\n", cloned_graph->name);
+		goto fail;
+	}
+
+	if (graph->coalesce.thresh != 0 || graph->coalesce.max_walks != 0) {
+		printf("Coalescing policy of graph %s not reset\n", graph->name);
+		goto fail;
+	}
+
+	ret = 0;
+fail:
+	if (cloned_graph_id != RTE_GRAPH_ID_INVALID)
+		rte_graph_destroy(cloned_graph_id);
+	rte_graph_worker_model_set(RTE_GRAPH_MODEL_RTC);
+	rte_graph_model_rtc_coalesce_set(graph_id, 0, 0, 0);
+
+	return ret;
+}
+
+static uint64_t
+graph_hist_sum(const uint64_t *hist)
+{
+	uint64_t sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++)
+		sum += hist[i];
+
+	return sum;
+}
+
+static int
+test_graph_stats_hist(void)
+{
+	struct rte_graph *graph = rte_graph_lookup("worker0");
+	uint64_t calls, hist_objs, hist_cycles;
+	struct rte_node_ext *ext;
+	struct rte_node *node;
+	int i;
+
+	if (!rte_graph_has_stats_feature())
+		return 0;
+
+	if (!graph) {
+		printf("Graph lookup failed\n");
+		return -1;
+	}
+
+	node = rte_graph_node_get(graph_id, rte_node_from_name("test_node_source1"));
+	ext = __rte_node_ext(node);
+	calls = node->total_calls;
+	hist_objs = ext->hist ? graph_hist_sum(ext->hist->objs) : 0;
+	hist_cycles = ext->hist ? graph_hist_sum(ext->hist->cycles) : 0;
+
+	if (rte_graph_stats_hist_enable(graph_id, true)) {
+		printf("Histogram enable failed\n");
+		return -1;
+	}
+	for (i = 0; i < 5; i++)
+		rte_graph_walk(graph);
+	rte_graph_stats_hist_enable(graph_id, false);
+
+	if (ext->hist == NULL ||
+	    graph_hist_sum(ext->hist->objs) - hist_objs != node->total_calls - calls ||
+	    graph_hist_sum(ext->hist->cycles) - hist_cycles != node->total_calls - calls) {
+		printf("Histogram of node %s doesn't match its calls\n", node->name);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_graph_lookup_functions(void)
 {
@@ -976,11 +1424,16 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_lookup_functions),
 		TEST_CASE(test_create_graph),
 		TEST_CASE(test_graph_clone),
+		TEST_CASE(test_graph_model_work_steal),
+		TEST_CASE(test_graph_model_work_steal_order),
 		TEST_CASE(test_graph_model_mcore_dispatch_node_lcore_affinity_set),
 		TEST_CASE(test_graph_model_mcore_dispatch_core_bind_unbind),
 		TEST_CASE(test_graph_worker_model_set_get),
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
+		TEST_CASE(test_graph_stats_hist),
+		TEST_CASE(test_graph_model_rtc_coalesce),
+		TEST_CASE(test_graph_model_rtc_coalesce_model_change),
 		TEST_CASE(test_print_stats),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
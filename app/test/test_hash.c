@@ -1001,6 +1001,413 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * Add, lookup and delete many more keys than the initial size of a resizable
+ * hash table, so that the bucket table grows and then shrinks back while the
+ * keys are migrated. A lock free table starts full, shrinks once RCU QSBR is
+ * attached, then grows with the keys.
+ */
+#define RESIZE_ENTRIES 4096
+static int test_hash_resize(uint32_t extra_flag)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resize",
+		/* Room for the keys without relying on a 100% cuckoo load */
+		.entries = RESIZE_ENTRIES * 2,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZE | extra_flag,
+	};
+	uint32_t rand_keys[RESIZE_ENTRIES];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv = NULL;
+	struct rte_hash *handle;
+	const void *next_key;
+	void *next_data;
+	uint64_t hit_mask;
+	uint32_t iter = 0;
+	unsigned int i, j;
+	int32_t pos;
+
+	for (i = 0; i < RESIZE_ENTRIES; i++)
+		rand_keys[i] = i * 2654435761U + 1;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) {
+		qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(1),
+				  RTE_CACHE_LINE_SIZE);
+		RETURN_IF_ERROR(qsv == NULL, "RCU QSBR variable creation failed");
+		rte_rcu_qsbr_init(qsv, 1);
+		rcu_cfg.v = qsv;
+		rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC;
+		RETURN_IF_ERROR(rte_hash_rcu_qsbr_add(handle, &rcu_cfg) != 0,
+				"attach RCU QSBR to hash table failed");
+	}
+
+	/* Fill the table well above its initial size */
+	for (i = 0; i < RESIZE_ENTRIES; i++) {
+		pos = rte_hash_add_key_data(handle, &rand_keys[i],
+				(void *)(uintptr_t)rand_keys[i]);
+		RETURN_IF_ERROR(pos != 0, "failed to add key %u (%d)", i, pos);
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != RESIZE_ENTRIES,
+			"wrong key count %d", rte_hash_count(handle));
+
+	/* Bulk lookup */
+	for (i = 0; i < RESIZE_ENTRIES; i += RTE_HASH_LOOKUP_BULK_MAX) {
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			key_ptrs[j] = &rand_keys[i + j];
+		RETURN_IF_ERROR(rte_hash_lookup_bulk_data(handle, key_ptrs,
+				RTE_HASH_LOOKUP_BULK_MAX, &hit_mask, data) !=
+				RTE_HASH_LOOKUP_BULK_MAX,
+				"failed to find keys from %u", i);
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			RETURN_IF_ERROR((uintptr_t)data[j] != rand_keys[i + j],
+					"wrong data for key %u", i + j);
+	}
+
+	/* Iterate */
+	i = 0;
+	while (rte_hash_iterate(handle, &next_key, &next_data, &iter) >= 0) {
+		RETURN_IF_ERROR((uintptr_t)next_data != *(const uint32_t *)next_key,
+				"wrong data for iterated key");
+		i++;
+	}
+	RETURN_IF_ERROR(i != RESIZE_ENTRIES, "iterated %u keys", i);
+
+	/* Delete, the remaining keys must be found while the table shrinks */
+	for (i = 0; i < RESIZE_ENTRIES; i++) {
+		pos = rte_hash_del_key(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(pos < 0, "failed to delete key %u (%d)", i, pos);
+		if (i + 1 < RESIZE_ENTRIES) {
+			pos = rte_hash_lookup(handle, &rand_keys[i + 1]);
+			RETURN_IF_ERROR(pos < 0, "failed to find key %u (%d)",
+					i + 1, pos);
+		}
+	}
+
+	for (i = 0; i < RESIZE_ENTRIES; i++) {
+		pos = rte_hash_lookup(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(pos != -ENOENT, "found deleted key %u (%d)",
+				i, pos);
+	}
+
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+}
+
+/*
+ * Add keys to an aging hash table, hit half of them after the clock moved on,
+ * then expire the table a few buckets at a time: only the keys that were not
+ * hit must be removed.
+ */
+#define AGING_ENTRIES 1024
+#define AGING_BURST 16
+static int test_hash_aging(uint32_t extra_flag)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_aging",
+		.entries = AGING_ENTRIES * 2,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_AGING | extra_flag,
+	};
+	uint32_t keys[AGING_ENTRIES];
+	const void *expired[AGING_BURST];
+	void *data[AGING_BURST];
+	struct rte_hash *handle;
+	uint32_t next = 0;
+	unsigned int i, j, nb_expired = 0;
+	int32_t pos, ret;
+
+	for (i = 0; i < AGING_ENTRIES; i++)
+		keys[i] = i * 2654435761U + 1;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* Keys are added at time 10 */
+	ret = rte_hash_expire(handle, 10, 100, 0, &next, NULL, NULL, NULL, 0);
+	RETURN_IF_ERROR(ret != 0, "failed to set the aging clock (%d)", ret);
+	for (i = 0; i < AGING_ENTRIES; i++) {
+		pos = rte_hash_add_key_data(handle, &keys[i],
+				(void *)(uintptr_t)i);
+		RETURN_IF_ERROR(pos < 0, "failed to add key %u (%d)", i, pos);
+	}
+
+	/* Nothing is aged yet */
+	ret = rte_hash_expire(handle, 50, 100, UINT32_MAX, &next, expired,
+			data, NULL, AGING_BURST);
+	RETURN_IF_ERROR(ret != 0, "expired %d keys too early", ret);
+
+	/* Odd keys are hit at time 80 */
+	ret = rte_hash_expire(handle, 80, 100, 0, &next, NULL, NULL, NULL, 0);
+	RETURN_IF_ERROR(ret != 0, "failed to set the aging clock (%d)", ret);
+	for (i = 1; i < AGING_ENTRIES; i += 2) {
+		pos = rte_hash_lookup(handle, &keys[i]);
+		RETURN_IF_ERROR(pos < 0, "failed to find key %u (%d)", i, pos);
+	}
+
+	/* At time 150, only the even keys are older than the timeout */
+	next = 0;
+	for (i = 0; i < AGING_ENTRIES; i++) {
+		ret = rte_hash_expire(handle, 150, 100, 4, &next, expired,
+				data, NULL, AGING_BURST);
+		RETURN_IF_ERROR(ret < 0, "expire failed (%d)", ret);
+		for (j = 0; j < (unsigned int)ret; j++) {
+			RETURN_IF_ERROR(*(const uint32_t *)expired[j] !=
+					keys[(uintptr_t)data[j]],
+					"wrong data for expired key");
+			RETURN_IF_ERROR((uintptr_t)data[j] % 2 != 0,
+					"expired key %u that was hit",
+					(unsigned int)(uintptr_t)data[j]);
+		}
+		nb_expired += ret;
+		if (nb_expired == AGING_ENTRIES / 2)
+			break;
+	}
+	RETURN_IF_ERROR(nb_expired != AGING_ENTRIES / 2,
+			"expired %u keys", nb_expired);
+	RETURN_IF_ERROR(rte_hash_count(handle) != AGING_ENTRIES / 2,
+			"wrong key count %d", rte_hash_count(handle));
+
+	for (i = 0; i < AGING_ENTRIES; i++) {
+		pos = rte_hash_lookup(handle, &keys[i]);
+		RETURN_IF_ERROR((i % 2 == 0) != (pos == -ENOENT),
+				"wrong lookup result for key %u (%d)", i, pos);
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+/*
+ * Expire aged keys on the main lcore while a worker lcore deletes the same
+ * keys, in the order of the table scan, and adds fresh ones reusing the freed
+ * key slots. Only aged keys may be expired, each of them once, and no fresh
+ * key may be lost.
+ */
+#define AGING_MT_ENTRIES 4096
+static uint32_t aging_mt_keys[AGING_MT_ENTRIES * 2];
+static uint32_t aging_mt_order[AGING_MT_ENTRIES];
+static volatile uint8_t aging_mt_done;
+
+static int
+test_hash_aging_mt_writer(void *arg)
+{
+	struct rte_hash *handle = arg;
+	unsigned int i, k;
+	int32_t pos;
+	int ret = 0;
+
+	for (i = 0; i < AGING_MT_ENTRIES; i++) {
+		/* The aged key may already have been expired */
+		k = aging_mt_order[i];
+		pos = rte_hash_del_key(handle, &aging_mt_keys[k]);
+		if (pos < 0 && pos != -ENOENT) {
+			printf("failed to delete key %u (%d)\n", k, pos);
+			ret = -1;
+			break;
+		}
+		k += AGING_MT_ENTRIES;
+		pos = rte_hash_add_key_data(handle, &aging_mt_keys[k],
+				(void *)(uintptr_t)k);
+		if (pos < 0) {
+			printf("failed to add key %u (%d)\n", k, pos);
+			ret = -1;
+			break;
+		}
+	}
+
+	aging_mt_done = 1;
+	return ret;
+}
+
+static int
+test_hash_aging_mt_check(void **data, int32_t nb, uint8_t *expired)
+{
+	unsigned int k;
+	int32_t j;
+
+	for (j = 0; j < nb; j++) {
+		k = (uintptr_t)data[j];
+		if (k >= AGING_MT_ENTRIES) {
+			printf("expired fresh key %u\n", k);
+			return -1;
+		}
+		if (expired[k]++ != 0) {
+			printf("expired key %u twice\n", k);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int test_hash_aging_mt(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_aging_mt",
+		.entries = AGING_MT_ENTRIES * 2,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_AGING |
+			RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD |
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY,
+	};
+	uint8_t expired[AGING_MT_ENTRIES] = {0};
+	void *data[AGING_BURST];
+	struct rte_hash *handle;
+	unsigned int worker, i;
+	const void *key;
+	uint32_t next = 0;
+	int32_t pos, ret;
+	void *value;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for aging concurrency test, skipping\n");
+		return 0;
+	}
+
+	for (i = 0; i < RTE_DIM(aging_mt_keys); i++)
+		aging_mt_keys[i] = i * 2654435761U + 1;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* The first half of the keys is added at time 10 */
+	ret = rte_hash_expire(handle, 10, 100, 0, &next, NULL, NULL, NULL, 0);
+	RETURN_IF_ERROR(ret != 0, "failed to set the aging clock (%d)", ret);
+	for (i = 0; i < AGING_MT_ENTRIES; i++) {
+		pos = rte_hash_add_key_data(handle, &aging_mt_keys[i],
+				(void *)(uintptr_t)i);
+		RETURN_IF_ERROR(pos < 0, "failed to add key %u (%d)", i, pos);
+	}
+	i = 0;
+	while (rte_hash_iterate(handle, &key, &value, &next) >= 0)
+		aging_mt_order[i++] = (uintptr_t)value;
+	next = 0;
+
+	/* The worker adds the second half at time 1000, they never age */
+	ret = rte_hash_expire(handle, 1000, 100, 0, &next, NULL, NULL, NULL, 0);
+	RETURN_IF_ERROR(ret != 0, "failed to set the aging clock (%d)", ret);
+	aging_mt_done = 0;
+	worker = rte_get_next_lcore(-1, 1, 0);
+	ret = rte_eal_remote_launch(test_hash_aging_mt_writer, handle, worker);
+	RETURN_IF_ERROR(ret != 0, "failed to launch writer (%d)", ret);
+
+	do {
+		ret = rte_hash_expire(handle, 1000, 100, 8, &next, NULL, data,
+				NULL, AGING_BURST);
+		if (ret >= 0)
+			ret = test_hash_aging_mt_check(data, ret, expired);
+	} while (ret >= 0 && !aging_mt_done);
+	pos = rte_eal_wait_lcore(worker);
+	RETURN_IF_ERROR(ret < 0, "concurrent expire failed (%d)", ret);
+	RETURN_IF_ERROR(pos != 0, "writer failed");
+
+	RETURN_IF_ERROR(rte_hash_count(handle) != AGING_MT_ENTRIES,
+			"wrong key count %d", rte_hash_count(handle));
+	for (i = 0; i < RTE_DIM(aging_mt_keys); i++) {
+		pos = rte_hash_lookup_data(handle, &aging_mt_keys[i], &value);
+		RETURN_IF_ERROR((i < AGING_MT_ENTRIES) != (pos == -ENOENT),
+				"wrong lookup result for key %u (%d)", i, pos);
+		RETURN_IF_ERROR(pos >= 0 && (uintptr_t)value != i,
+				"wrong data for key %u", i);
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+/*
+ * Look up the same bursts of keys, half of them missing, with a staged lookup
+ * and with rte_hash_lookup_bulk_data(), and compare the results.
+ */
+#define STAGE_ENTRIES 1024
+static int test_hash_lookup_stage(uint32_t extra_flag)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_lookup_stage",
+		.entries = STAGE_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = extra_flag,
+	};
+	struct rte_hash_lookup_stage stage;
+	uint32_t keys[STAGE_ENTRIES];
+	hash_sig_t sigs[RTE_HASH_LOOKUP_BULK_MAX];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	void *stage_data[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t positions[RTE_HASH_LOOKUP_BULK_MAX];
+	uint64_t hit_mask, stage_hit_mask;
+	struct rte_hash *handle;
+	unsigned int i, j;
+	int32_t pos, ret;
+
+	for (i = 0; i < STAGE_ENTRIES; i++)
+		keys[i] = i * 2654435761U + 1;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < STAGE_ENTRIES; i += 2) {
+		pos = rte_hash_add_key_data(handle, &keys[i],
+				(void *)(uintptr_t)i);
+		RETURN_IF_ERROR(pos < 0, "failed to add key %u (%d)", i, pos);
+	}
+
+	for (i = 0; i < STAGE_ENTRIES; i += RTE_HASH_LOOKUP_BULK_MAX) {
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++) {
+			key_ptrs[j] = &keys[i + j];
+			sigs[j] = rte_hash_hash(handle, key_ptrs[j]);
+		}
+		ret = rte_hash_lookup_bulk_data(handle, key_ptrs,
+				RTE_HASH_LOOKUP_BULK_MAX, &hit_mask, data);
+		RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX / 2,
+				"bulk lookup found %d keys", ret);
+
+		/* Precomputed hash values are used for odd bursts */
+		ret = rte_hash_lookup_stage_bkt(handle, key_ptrs,
+				(i / RTE_HASH_LOOKUP_BULK_MAX) % 2 ? sigs : NULL,
+				RTE_HASH_LOOKUP_BULK_MAX, &stage);
+		RETURN_IF_ERROR(ret != 0, "failed bucket stage (%d)", ret);
+		ret = rte_hash_lookup_stage_sig(handle, &stage);
+		RETURN_IF_ERROR(ret != 0, "failed signature stage (%d)", ret);
+		ret = rte_hash_lookup_stage_key(handle, &stage, positions,
+				&stage_hit_mask, stage_data);
+		RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX / 2,
+				"staged lookup found %d keys", ret);
+		RETURN_IF_ERROR(stage_hit_mask != hit_mask,
+				"hit masks differ from key %u", i);
+
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++) {
+			pos = rte_hash_lookup(handle, key_ptrs[j]);
+			RETURN_IF_ERROR(positions[j] != pos,
+					"wrong position for key %u", i + j);
+			if (pos >= 0)
+				RETURN_IF_ERROR(stage_data[j] != data[j],
+						"wrong data for key %u", i + j);
+		}
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -1387,6 +1794,28 @@ static int test_hash_creation_with_bad_parameters(void)
 		return -1;
 	}
 
+	memcpy(&params, &ut_params, sizeof(params));
+	params.name = "creation_with_bad_parameters_5";
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZE |
+			    RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	if (handle != NULL) {
+		rte_hash_free(handle);
+		printf("Impossible creating resizable hash successfully with ext table\n");
+		return -1;
+	}
+
+	memcpy(&params, &ut_params, sizeof(params));
+	params.name = "creation_with_bad_parameters_6";
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_AGING |
+			    RTE_HASH_EXTRA_FLAGS_RESIZE;
+	handle = rte_hash_create(&params);
+	if (handle != NULL) {
+		rte_hash_free(handle);
+		printf("Impossible creating resizable hash successfully with aging\n");
+		return -1;
+	}
+
 	/* test with same name should fail */
 	memcpy(&params, &ut_params, sizeof(params));
 	params.name = "same_name";
@@ -2219,6 +2648,24 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_hash_resize(0) < 0)
+		return -1;
+	if (test_hash_resize(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY) < 0)
+		return -1;
+	if (test_hash_resize(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (test_hash_aging(0) < 0)
+		return -1;
+	if (test_hash_aging(RTE_HASH_EXTRA_FLAGS_EXT_TABLE) < 0)
+		return -1;
+	if (test_hash_aging_mt() < 0)
+		return -1;
+	if (test_hash_lookup_stage(0) < 0)
+		return -1;
+	if (test_hash_lookup_stage(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (test_hash_lookup_stage(RTE_HASH_EXTRA_FLAGS_RESIZE) < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
@@ -14,6 +14,7 @@
 #include <rte_fbk_hash.h>
 #include <rte_random.h>
 #include <rte_string_fns.h>
+#include <rte_vect.h>
 
 #include "test.h"
 
@@ -723,6 +724,210 @@ fbk_hash_perf_test(void)
 	return 0;
 }
 
+/* Control operation of 64-key burst lookups per SIMD bitwidth. */
+#define SIMD_ENTRIES (1 << 16)	/* How many entries. */
+#define SIMD_KEY_LEN 16		/* Size of the keys. */
+#define SIMD_ITERATIONS 64	/* How many times to look up all keys. */
+
+static int
+bulk_lookup_simd_perf_test(void)
+{
+	static const uint16_t bitwidths[] = {
+		RTE_VECT_SIMD_128, RTE_VECT_SIMD_256, RTE_VECT_SIMD_512
+	};
+	const uint16_t max_bitwidth = rte_vect_get_max_simd_bitwidth();
+	struct rte_hash_parameters params = {
+		.name = "simd_perf",
+		.entries = SIMD_ENTRIES,
+		.key_len = SIMD_KEY_LEN,
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	const void *keys_burst[RTE_HASH_LOOKUP_BULK_MAX];
+	void *ret_data[RTE_HASH_LOOKUP_BULK_MAX];
+	unsigned int i, j, k, w, added;
+	uint64_t begin, cycles, hits;
+	struct rte_hash *handle;
+	uint64_t hit_mask;
+
+	printf("\n\n *** 64-key burst lookups per SIMD bitwidth ***\n");
+	printf("%-18s%-18s\n", "Bitwidth", "Lookup_bulk");
+
+	for (w = 0; w < RTE_DIM(bitwidths); w++) {
+		/* Signature compare is selected at table creation */
+		if (rte_vect_set_max_simd_bitwidth(bitwidths[w]) != 0) {
+			printf("%-18u%-18s\n", bitwidths[w], "skipped");
+			continue;
+		}
+		handle = rte_hash_create(&params);
+		if (handle == NULL) {
+			printf("Error creating table\n");
+			rte_vect_set_max_simd_bitwidth(max_bitwidth);
+			return -1;
+		}
+
+		/* Fill 75% of the table with random keys */
+		for (added = 0; added < SIMD_ENTRIES * ADD_PERCENT; added++) {
+			for (k = 0; k < SIMD_KEY_LEN; k++)
+				keys[added][k] = rte_rand();
+			if (rte_hash_add_key_data(handle, keys[added],
+					(void *)(uintptr_t)added) < 0)
+				break;
+		}
+		added = RTE_ALIGN_FLOOR(added, RTE_HASH_LOOKUP_BULK_MAX);
+
+		hits = 0;
+		begin = rte_rdtsc();
+		for (i = 0; i < SIMD_ITERATIONS; i++) {
+			for (j = 0; j < added; j += RTE_HASH_LOOKUP_BULK_MAX) {
+				for (k = 0; k < RTE_HASH_LOOKUP_BULK_MAX; k++)
+					keys_burst[k] = keys[j + k];
+				hits += rte_hash_lookup_bulk_data(handle,
+						keys_burst,
+						RTE_HASH_LOOKUP_BULK_MAX,
+						&hit_mask, ret_data);
+			}
+		}
+		cycles = rte_rdtsc() - begin;
+		rte_hash_free(handle);
+
+		if (hits != (uint64_t)added * SIMD_ITERATIONS) {
+			printf("Only %"PRIu64" hits out of %"PRIu64" lookups\n",
+				hits, (uint64_t)added * SIMD_ITERATIONS);
+			rte_vect_set_max_simd_bitwidth(max_bitwidth);
+			return -1;
+		}
+		printf("%-18u%-18"PRIu64"\n", bitwidths[w],
+			cycles / ((uint64_t)added * SIMD_ITERATIONS));
+	}
+
+	rte_vect_set_max_simd_bitwidth(max_bitwidth);
+
+	return 0;
+}
+
+/* Control operation of staged lookups in tables larger than the LLC. */
+#define STAGED_TABLES 2		/* How many tables are looked up per burst. */
+#define STAGED_ENTRIES (1 << 20)	/* How many entries per table. */
+#define STAGED_KEY_LEN 16	/* Size of the keys. */
+#define STAGED_STRIDE 7919	/* Odd step to visit the keys out of order. */
+
+/*
+ * Look up bursts of keys in several tables, either one table after the other
+ * with rte_hash_lookup_bulk_data(), or interleaving the stages of the lookups
+ * in all tables, so that the buckets and keys of one table are loaded while
+ * the other tables are searched.
+ */
+static int
+staged_lookup_perf_test(void)
+{
+	static const unsigned int bursts[] = {8, 16, 32, RTE_HASH_LOOKUP_BULK_MAX};
+	struct rte_hash_parameters params = {
+		.entries = STAGED_ENTRIES,
+		.key_len = STAGED_KEY_LEN,
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	struct rte_hash_lookup_stage stage[STAGED_TABLES];
+	const void *keys_burst[STAGED_TABLES][RTE_HASH_LOOKUP_BULK_MAX];
+	void *ret_data[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash *handle[STAGED_TABLES] = {NULL};
+	const unsigned int added = STAGED_ENTRIES * ADD_PERCENT;
+	uint64_t begin, cycles_bulk, cycles_staged, hits, hit_mask;
+	uint8_t (*staged_keys)[STAGED_KEY_LEN] = NULL;
+	char name[RTE_HASH_NAMESIZE];
+	unsigned int b, i, j, k, t, n;
+	int ret = -1;
+
+	staged_keys = rte_malloc(NULL, sizeof(*staged_keys) * STAGED_TABLES *
+				 added, 0);
+	if (staged_keys == NULL) {
+		printf("Error allocating keys\n");
+		return -1;
+	}
+
+	for (t = 0; t < STAGED_TABLES; t++) {
+		snprintf(name, sizeof(name), "staged_perf_%u", t);
+		params.name = name;
+		handle[t] = rte_hash_create(&params);
+		if (handle[t] == NULL) {
+			printf("Error creating table\n");
+			goto exit;
+		}
+		for (i = 0; i < added; i++) {
+			for (k = 0; k < STAGED_KEY_LEN; k++)
+				staged_keys[t * added + i][k] = rte_rand();
+			if (rte_hash_add_key(handle[t],
+					staged_keys[t * added + i]) < 0) {
+				printf("Error adding key %u to table %u\n",
+					i, t);
+				goto exit;
+			}
+		}
+	}
+
+	printf("\n\n *** Lookups in %u tables of %u entries ***\n",
+		STAGED_TABLES, STAGED_ENTRIES);
+	printf("%-18s%-18s%-18s\n", "Burst", "Lookup_bulk", "Lookup_staged");
+
+	for (b = 0; b < RTE_DIM(bursts); b++) {
+		n = RTE_ALIGN_FLOOR(added, bursts[b]);
+
+		hits = 0;
+		begin = rte_rdtsc();
+		for (i = 0; i < n; i += bursts[b]) {
+			for (t = 0; t < STAGED_TABLES; t++) {
+				for (j = 0; j < bursts[b]; j++)
+					keys_burst[t][j] = staged_keys[t * added +
+						(uint64_t)(i + j) * STAGED_STRIDE % n];
+				hits += rte_hash_lookup_bulk_data(handle[t],
+						keys_burst[t], bursts[b],
+						&hit_mask, ret_data);
+			}
+		}
+		cycles_bulk = rte_rdtsc() - begin;
+
+		begin = rte_rdtsc();
+		for (i = 0; i < n; i += bursts[b]) {
+			for (t = 0; t < STAGED_TABLES; t++) {
+				for (j = 0; j < bursts[b]; j++)
+					keys_burst[t][j] = staged_keys[t * added +
+						(uint64_t)(i + j) * STAGED_STRIDE % n];
+				rte_hash_lookup_stage_bkt(handle[t],
+						keys_burst[t], NULL, bursts[b],
+						&stage[t]);
+			}
+			for (t = 0; t < STAGED_TABLES; t++)
+				rte_hash_lookup_stage_sig(handle[t], &stage[t]);
+			for (t = 0; t < STAGED_TABLES; t++)
+				hits += rte_hash_lookup_stage_key(handle[t],
+						&stage[t], NULL, &hit_mask,
+						ret_data);
+		}
+		cycles_staged = rte_rdtsc() - begin;
+
+		/* All keys are looked up once per method */
+		if (hits != (uint64_t)2 * STAGED_TABLES * n) {
+			printf("Only %"PRIu64" hits out of %"PRIu64" lookups\n",
+				hits, (uint64_t)2 * STAGED_TABLES * n);
+			goto exit;
+		}
+		printf("%-18u%-18"PRIu64"%-18"PRIu64"\n", bursts[b],
+			cycles_bulk / ((uint64_t)STAGED_TABLES * n),
+			cycles_staged / ((uint64_t)STAGED_TABLES * n));
+	}
+	ret = 0;
+
+exit:
+	for (t = 0; t < STAGED_TABLES; t++)
+		rte_hash_free(handle[t]);
+	rte_free(staged_keys);
+
+	return ret;
+}
+
 static int
 test_hash_perf(void)
 {
@@ -751,6 +956,12 @@ test_hash_perf(void)
 	if (run_all_tbl_perf_tests(1, 0, 1) < 0)
 		return -1;
 
+	if (bulk_lookup_simd_perf_test() < 0)
+		return -1;
+
+	if (staged_lookup_perf_test() < 0)
+		return -1;
+
 	if (fbk_hash_perf_test() < 0)
 		return -1;
 
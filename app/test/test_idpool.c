@@ -0,0 +1,306 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_idpool.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+/* Not a multiple of the bitmap word size, to check the last partial word */
+#define IDPOOL_SIZE 4133
+#define CACHE_SIZE 64
+#define MAX_BULK 32
+
+/* Check that the n IDs are valid and not already taken, then mark them. */
+static int
+test_idpool_take(uint8_t *taken, const uint32_t *ids, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		if (ids[i] >= IDPOOL_SIZE) {
+			printf("[%s():%u] ID %u out of range\n",
+			       __func__, __LINE__, ids[i]);
+			return -1;
+		}
+		if (taken[ids[i]]) {
+			printf("[%s():%u] ID %u allocated twice\n",
+			       __func__, __LINE__, ids[i]);
+			return -1;
+		}
+		taken[ids[i]] = 1;
+	}
+
+	return 0;
+}
+
+static int
+test_idpool_get_put(struct rte_idpool *p, uint32_t *ids, unsigned int bulk_sz)
+{
+	uint8_t taken[IDPOOL_SIZE] = {0};
+	unsigned int i, n;
+
+	for (i = 0; i < IDPOOL_SIZE; i += n) {
+		n = RTE_MIN(bulk_sz, IDPOOL_SIZE - i);
+		TEST_ASSERT_SUCCESS(rte_idpool_get_bulk(p, &ids[i], n),
+				    "Failed to get %u IDs after %u", n, i);
+		TEST_ASSERT_SUCCESS(test_idpool_take(taken, &ids[i], n),
+				    "Invalid IDs");
+		TEST_ASSERT_EQUAL(rte_idpool_avail_count(p), IDPOOL_SIZE - i - n,
+				  "Wrong free count %u after %u IDs",
+				  rte_idpool_avail_count(p), i + n);
+	}
+
+	TEST_ASSERT_EQUAL(rte_idpool_get_bulk(p, ids, 1), -ENOENT,
+			  "Got an ID from an empty pool");
+
+	for (i = 0; i < IDPOOL_SIZE; i += n) {
+		n = RTE_MIN(bulk_sz, IDPOOL_SIZE - i);
+		rte_idpool_put_bulk(p, &ids[i], n);
+		TEST_ASSERT_EQUAL(rte_idpool_avail_count(p), i + n,
+				  "Wrong free count %u after %u IDs",
+				  rte_idpool_avail_count(p), i + n);
+	}
+
+	return 0;
+}
+
+static int
+test_idpool_basic(uint32_t cache_size, uint32_t flags)
+{
+	struct rte_idpool *p;
+	uint32_t *ids;
+	uint32_t id;
+	int ret = -1;
+
+	/* Room for a bulk past the last free ID, see the excess get below */
+	ids = rte_calloc(NULL, IDPOOL_SIZE + MAX_BULK, sizeof(*ids), 0);
+	TEST_ASSERT_NOT_NULL(ids, "Failed to allocate IDs");
+
+	p = rte_idpool_create(__func__, IDPOOL_SIZE, cache_size,
+			      rte_socket_id(), flags);
+	if (p == NULL) {
+		printf("[%s():%u] Failed to create an ID pool\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	if (rte_idpool_lookup(__func__) != p) {
+		printf("[%s():%u] Failed to lookup an ID pool\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	if (rte_idpool_avail_count(p) != IDPOOL_SIZE) {
+		printf("[%s():%u] Free count: %u (expected %u)\n",
+		       __func__, __LINE__, rte_idpool_avail_count(p),
+		       IDPOOL_SIZE);
+		goto fail_test;
+	}
+
+	if (test_idpool_get_put(p, ids, 1) < 0 ||
+	    test_idpool_get_put(p, ids, MAX_BULK) < 0)
+		goto fail_test;
+
+	/* Bulks larger than the cache cannot get the IDs of the cache */
+	rte_idpool_reset(p);
+	if (test_idpool_get_put(p, ids, 2 * CACHE_SIZE + 1) < 0)
+		goto fail_test;
+
+	/* A bulk larger than the free IDs must not take any of them */
+	rte_idpool_reset(p);
+	if (rte_idpool_get_bulk(p, ids, IDPOOL_SIZE - 1) != 0 ||
+	    rte_idpool_get_bulk(p, &ids[IDPOOL_SIZE - 1], MAX_BULK) !=
+	    -ENOENT || rte_idpool_avail_count(p) != 1) {
+		printf("[%s():%u] Excess IDs get succeeded\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	if (rte_idpool_get(p, &id) != 0 || rte_idpool_get(p, &id) != -ENOENT) {
+		printf("[%s():%u] Failed to get the last ID\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	rte_idpool_reset(p);
+	if (rte_idpool_avail_count(p) != IDPOOL_SIZE) {
+		printf("[%s():%u] Free count after reset: %u (expected %u)\n",
+		       __func__, __LINE__, rte_idpool_avail_count(p),
+		       IDPOOL_SIZE);
+		goto fail_test;
+	}
+
+	ret = 0;
+
+fail_test:
+	rte_idpool_free(p);
+	rte_free(ids);
+
+	return ret;
+}
+
+static int
+test_idpool_invalid(void)
+{
+	char name[RTE_IDPOOL_NAMESIZE + 1];
+	struct rte_idpool *p;
+
+	p = rte_idpool_create("test", 0, 0, rte_socket_id(), 0);
+	TEST_ASSERT(p == NULL && rte_errno == EINVAL,
+		    "Created an ID pool without IDs");
+	p = rte_idpool_create("test", IDPOOL_SIZE,
+			      RTE_IDPOOL_CACHE_MAX_SIZE + 1, rte_socket_id(), 0);
+	TEST_ASSERT(p == NULL && rte_errno == EINVAL,
+		    "Created an ID pool with a too large cache");
+	p = rte_idpool_create("test", IDPOOL_SIZE, 0, rte_socket_id(),
+			      RTE_IDPOOL_F_NUMA << 1);
+	TEST_ASSERT(p == NULL && rte_errno == EINVAL,
+		    "Created an ID pool with unknown flags");
+
+	memset(name, 's', sizeof(name));
+	name[RTE_IDPOOL_NAMESIZE] = '\0';
+	p = rte_idpool_create(name, IDPOOL_SIZE, 0, rte_socket_id(), 0);
+	TEST_ASSERT(p == NULL && rte_errno == ENAMETOOLONG,
+		    "Failed to prevent long name");
+
+	p = rte_idpool_create("test", IDPOOL_SIZE, 0, rte_socket_id(), 0);
+	TEST_ASSERT_NOT_NULL(p, "Failed to create an ID pool");
+	if (rte_idpool_create("test", IDPOOL_SIZE, 0, rte_socket_id(), 0)) {
+		rte_idpool_free(p);
+		TEST_ASSERT(0, "Failed to detect re-used name");
+	}
+	rte_idpool_free(p);
+
+	TEST_ASSERT(rte_idpool_lookup("idpool_not_found") == NULL &&
+		    rte_errno == ENOENT, "Found a non-existent ID pool");
+	TEST_ASSERT(rte_idpool_lookup(NULL) == NULL && rte_errno == EINVAL,
+		    "Found a NULL ID pool");
+
+	/* Check whether the library proper handles a NULL pointer */
+	rte_idpool_free(NULL);
+
+	return 0;
+}
+
+#define NUM_ITERS_PER_THREAD 100000
+
+static struct rte_idpool *thread_idpool;
+static RTE_ATOMIC(uint8_t) *thread_owned;
+
+static int
+idpool_thread_get_put(__rte_unused void *args)
+{
+	uint32_t ids[MAX_BULK];
+	unsigned int i, j, n;
+
+	for (i = 0; i < NUM_ITERS_PER_THREAD; i++) {
+		n = rte_rand_max(MAX_BULK) + 1;
+
+		if (rte_idpool_get_bulk(thread_idpool, ids, n) != 0) {
+			printf("[%s():%u] Failed to get %u IDs\n",
+			       __func__, __LINE__, n);
+			return -1;
+		}
+
+		for (j = 0; j < n; j++) {
+			if (rte_atomic_exchange_explicit(&thread_owned[ids[j]],
+					1, rte_memory_order_relaxed) != 0) {
+				printf("[%s():%u] ID %u allocated twice\n",
+				       __func__, __LINE__, ids[j]);
+				return -1;
+			}
+		}
+		for (j = 0; j < n; j++)
+			rte_atomic_store_explicit(&thread_owned[ids[j]], 0,
+						  rte_memory_order_relaxed);
+
+		rte_idpool_put_bulk(thread_idpool, ids, n);
+	}
+
+	return 0;
+}
+
+static int
+test_idpool_multithreaded(uint32_t cache_size, uint32_t flags)
+{
+	unsigned int lcore_id, nb_ids;
+	int result = 0;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for test_idpool_multithreaded, expecting at least 2\n");
+		return TEST_SKIPPED;
+	}
+
+	/*
+	 * Few IDs for every lcore, to make them contend, with some margin as
+	 * a get may miss the IDs put behind its bitmap scan.
+	 */
+	nb_ids = 2 * (MAX_BULK + cache_size) * rte_lcore_count();
+	thread_owned = rte_zmalloc(NULL, nb_ids, 0);
+	TEST_ASSERT_NOT_NULL(thread_owned, "Failed to allocate ID owners");
+	thread_idpool = rte_idpool_create("test", nb_ids, cache_size,
+					  rte_socket_id(), flags);
+	if (thread_idpool == NULL) {
+		rte_free((void *)(uintptr_t)thread_owned);
+		TEST_ASSERT(0, "Failed to create an ID pool");
+	}
+
+	if (rte_eal_mp_remote_launch(idpool_thread_get_put, NULL, CALL_MAIN))
+		rte_panic("Failed to launch tests\n");
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			result = -1;
+	}
+
+	if (result == 0 && rte_idpool_avail_count(thread_idpool) != nb_ids) {
+		printf("[%s():%u] Free count: %u (expected %u)\n",
+		       __func__, __LINE__,
+		       rte_idpool_avail_count(thread_idpool), nb_ids);
+		result = -1;
+	}
+
+	rte_idpool_free(thread_idpool);
+	rte_free((void *)(uintptr_t)thread_owned);
+
+	return result;
+}
+
+static int
+__test_idpool(uint32_t cache_size, uint32_t flags)
+{
+	if (test_idpool_basic(cache_size, flags) < 0)
+		return -1;
+
+	if (test_idpool_multithreaded(cache_size, flags) < 0)
+		return -1;
+
+	return 0;
+}
+
+static int
+test_idpool(void)
+{
+	if (test_idpool_invalid() < 0)
+		return -1;
+
+	if (__test_idpool(0, 0) < 0)
+		return -1;
+
+	if (__test_idpool(CACHE_SIZE, 0) < 0)
+		return -1;
+
+	if (__test_idpool(0, RTE_IDPOOL_F_NUMA) < 0)
+		return -1;
+
+	return __test_idpool(CACHE_SIZE, RTE_IDPOOL_F_NUMA);
+}
+
+REGISTER_FAST_TEST(idpool_autotest, false, true, test_idpool);
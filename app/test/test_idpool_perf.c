@@ -0,0 +1,298 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_idpool.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_ring_elem.h>
+
+#include "test.h"
+
+/*
+ * Compare the cycles per ID of the ID pool with the scheme it replaces in
+ * rte_hash: the free IDs in a ring, with or without a per-lcore cache of
+ * IDs in front of it.
+ */
+
+#define IDPOOL_PERF_SIZE (1 << 16)
+#define IDPOOL_PERF_CACHE 64
+#define MAX_BURST 32
+#define ITERATIONS 1000000
+
+/*
+ * Get/put bulk sizes, marked volatile so they aren't treated as compile-time
+ * constants.
+ */
+static volatile unsigned int bulk_sizes[] = {1, 8, MAX_BURST};
+
+enum idpool_perf_scheme {
+	SCHEME_RING,
+	SCHEME_RING_CACHE,
+	SCHEME_IDPOOL,
+	SCHEME_IDPOOL_CACHE,
+};
+
+static const char * const scheme_names[] = {
+	[SCHEME_RING] = "ring",
+	[SCHEME_RING_CACHE] = "ring + lcore cache",
+	[SCHEME_IDPOOL] = "idpool",
+	[SCHEME_IDPOOL_CACHE] = "idpool + lcore cache",
+};
+
+/* Per-lcore cache in front of the ring, as rte_hash used to have */
+struct ring_cache {
+	unsigned int len;
+	uint32_t objs[IDPOOL_PERF_CACHE + MAX_BURST];
+} __rte_cache_aligned;
+
+static struct rte_ring *perf_ring;
+static struct ring_cache ring_caches[RTE_MAX_LCORE];
+static struct rte_idpool *perf_idpool;
+static struct rte_idpool *perf_idpool_cache;
+
+static RTE_ATOMIC(uint32_t) lcore_barrier;
+
+struct thread_args {
+	enum idpool_perf_scheme scheme;
+	unsigned int sz;
+	double avg;
+};
+
+static __rte_always_inline int
+ring_cache_get(struct ring_cache *c, uint32_t *ids, unsigned int n)
+{
+	if (c->len < n) {
+		c->len += rte_ring_mc_dequeue_burst_elem(perf_ring,
+				&c->objs[c->len], sizeof(uint32_t),
+				IDPOOL_PERF_CACHE - c->len, NULL);
+		if (c->len < n)
+			return -ENOENT;
+	}
+	c->len -= n;
+	memcpy(ids, &c->objs[c->len], n * sizeof(*ids));
+	return 0;
+}
+
+static __rte_always_inline void
+ring_cache_put(struct ring_cache *c, const uint32_t *ids, unsigned int n)
+{
+	if (c->len + n > IDPOOL_PERF_CACHE)
+		c->len -= rte_ring_mp_enqueue_burst_elem(perf_ring, c->objs,
+				sizeof(uint32_t), c->len, NULL);
+	memcpy(&c->objs[c->len], ids, n * sizeof(*ids));
+	c->len += n;
+}
+
+static __rte_always_inline int
+ids_get(enum idpool_perf_scheme scheme, uint32_t *ids, unsigned int n)
+{
+	switch (scheme) {
+	case SCHEME_RING:
+		return rte_ring_mc_dequeue_bulk_elem(perf_ring, ids,
+				sizeof(uint32_t), n, NULL) == n ? 0 : -ENOENT;
+	case SCHEME_RING_CACHE:
+		return ring_cache_get(&ring_caches[rte_lcore_id()], ids, n);
+	case SCHEME_IDPOOL:
+		return rte_idpool_get_bulk(perf_idpool, ids, n);
+	case SCHEME_IDPOOL_CACHE:
+		return rte_idpool_get_bulk(perf_idpool_cache, ids, n);
+	}
+	return -EINVAL;
+}
+
+static __rte_always_inline void
+ids_put(enum idpool_perf_scheme scheme, const uint32_t *ids, unsigned int n)
+{
+	switch (scheme) {
+	case SCHEME_RING:
+		rte_ring_mp_enqueue_bulk_elem(perf_ring, ids,
+				sizeof(uint32_t), n, NULL);
+		break;
+	case SCHEME_RING_CACHE:
+		ring_cache_put(&ring_caches[rte_lcore_id()], ids, n);
+		break;
+	case SCHEME_IDPOOL:
+		rte_idpool_put_bulk(perf_idpool, ids, n);
+		break;
+	case SCHEME_IDPOOL_CACHE:
+		rte_idpool_put_bulk(perf_idpool_cache, ids, n);
+		break;
+	}
+}
+
+/*
+ * Get the IDs twice before putting them back, so that the caches run
+ * empty and full as well.
+ */
+static __rte_always_inline int
+get_put_loop(enum idpool_perf_scheme scheme, unsigned int size, double *avg)
+{
+	uint32_t ids[2 * MAX_BURST];
+	uint64_t start, end;
+	unsigned int i;
+
+	rte_atomic_fetch_sub_explicit(&lcore_barrier, 1,
+				      rte_memory_order_relaxed);
+	rte_wait_until_equal_32((uint32_t *)(uintptr_t)&lcore_barrier, 0,
+				rte_memory_order_relaxed);
+
+	start = rte_rdtsc();
+
+	for (i = 0; i < ITERATIONS; i++) {
+		if (ids_get(scheme, ids, size) != 0 ||
+		    ids_get(scheme, &ids[size], size) != 0) {
+			printf("[%s():%u] Failed to get %u IDs\n",
+			       __func__, __LINE__, size);
+			return -1;
+		}
+		ids_put(scheme, &ids[size], size);
+		ids_put(scheme, ids, size);
+	}
+
+	end = rte_rdtsc();
+
+	*avg = ((double)(end - start)) / (ITERATIONS * 2 * size);
+
+	return 0;
+}
+
+/* Measure the average per-ID cycle cost of getting and putting IDs */
+static int
+bulk_get_put(void *p)
+{
+	struct thread_args *args = p;
+
+	switch (args->scheme) {
+	case SCHEME_RING:
+		return get_put_loop(SCHEME_RING, args->sz, &args->avg);
+	case SCHEME_RING_CACHE:
+		return get_put_loop(SCHEME_RING_CACHE, args->sz, &args->avg);
+	case SCHEME_IDPOOL:
+		return get_put_loop(SCHEME_IDPOOL, args->sz, &args->avg);
+	case SCHEME_IDPOOL_CACHE:
+		return get_put_loop(SCHEME_IDPOOL_CACHE, args->sz, &args->avg);
+	}
+	return -1;
+}
+
+/* Run bulk_get_put() simultaneously on n lcores, for every scheme. */
+static int
+run_on_n_cores(unsigned int n)
+{
+	struct thread_args args[RTE_MAX_LCORE];
+	enum idpool_perf_scheme scheme;
+	unsigned int i, lcore_id, cnt;
+	int ret = 0;
+	double avg;
+
+	for (i = 0; i < RTE_DIM(bulk_sizes); i++) {
+		printf("Average cycles per ID get/put (bulk size: %u):",
+		       bulk_sizes[i]);
+
+		for (scheme = SCHEME_RING; scheme <= SCHEME_IDPOOL_CACHE;
+		     scheme++) {
+			rte_atomic_store_explicit(&lcore_barrier, n,
+						  rte_memory_order_relaxed);
+
+			/* The main lcore and the n - 1 first workers */
+			cnt = 0;
+			RTE_LCORE_FOREACH_WORKER(lcore_id) {
+				if (++cnt >= n)
+					break;
+				args[lcore_id].scheme = scheme;
+				args[lcore_id].sz = bulk_sizes[i];
+				if (rte_eal_remote_launch(bulk_get_put,
+						&args[lcore_id], lcore_id))
+					rte_panic("Failed to launch lcore %u\n",
+						  lcore_id);
+			}
+
+			lcore_id = rte_lcore_id();
+			args[lcore_id].scheme = scheme;
+			args[lcore_id].sz = bulk_sizes[i];
+			if (bulk_get_put(&args[lcore_id]) != 0)
+				ret = -1;
+
+			cnt = 0;
+			RTE_LCORE_FOREACH_WORKER(lcore_id) {
+				if (++cnt >= n)
+					break;
+				if (rte_eal_wait_lcore(lcore_id) != 0)
+					ret = -1;
+			}
+
+			avg = args[rte_lcore_id()].avg;
+			cnt = 0;
+			RTE_LCORE_FOREACH_WORKER(lcore_id) {
+				if (++cnt >= n)
+					break;
+				avg += args[lcore_id].avg;
+			}
+
+			printf(" %s %.2F%s", scheme_names[scheme], avg / n,
+			       scheme == SCHEME_IDPOOL_CACHE ? "\n" : ",");
+		}
+	}
+
+	return ret;
+}
+
+static int
+test_idpool_perf(void)
+{
+	uint32_t ids[MAX_BURST];
+	unsigned int i, j;
+	int ret = -1;
+
+	perf_ring = rte_ring_create_elem("IDPOOL_PERF", sizeof(uint32_t),
+			IDPOOL_PERF_SIZE, rte_socket_id(), RING_F_EXACT_SZ);
+	perf_idpool = rte_idpool_create("IDPOOL_PERF", IDPOOL_PERF_SIZE, 0,
+					rte_socket_id(), 0);
+	perf_idpool_cache = rte_idpool_create("IDPOOL_PERF_CACHE",
+					      IDPOOL_PERF_SIZE,
+					      IDPOOL_PERF_CACHE,
+					      rte_socket_id(), 0);
+	if (perf_ring == NULL || perf_idpool == NULL ||
+	    perf_idpool_cache == NULL) {
+		printf("[%s():%u] Failed to create the ID pools\n",
+		       __func__, __LINE__);
+		goto end;
+	}
+
+	for (i = 0; i < IDPOOL_PERF_SIZE; i += MAX_BURST) {
+		for (j = 0; j < MAX_BURST; j++)
+			ids[j] = i + j;
+		rte_ring_enqueue_bulk_elem(perf_ring, ids, sizeof(uint32_t),
+					   MAX_BURST, NULL);
+	}
+	memset(ring_caches, 0, sizeof(ring_caches));
+
+	printf("### Testing using a single lcore ###\n");
+	if (run_on_n_cores(1) < 0)
+		goto end;
+
+	if (rte_lcore_count() > 1) {
+		printf("\n### Testing on all %u lcores ###\n",
+		       rte_lcore_count());
+		if (run_on_n_cores(rte_lcore_count()) < 0)
+			goto end;
+	}
+
+	ret = 0;
+
+end:
+	rte_idpool_free(perf_idpool_cache);
+	rte_idpool_free(perf_idpool);
+	rte_ring_free(perf_ring);
+
+	return ret;
+}
+
+REGISTER_PERF_TEST(idpool_perf_autotest, test_idpool_perf);
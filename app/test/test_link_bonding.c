@@ -2701,6 +2701,14 @@ test_balance_xmit_policy_configuration(void)
 			BALANCE_XMIT_POLICY_LAYER34,
 			"balance xmit policy not as expected.");
 
+	TEST_ASSERT_SUCCESS(rte_eth_bond_xmit_policy_set(
+			test_params->bonding_port_id, BALANCE_XMIT_POLICY_RSS),
+			"Failed to set balance xmit policy.");
+
+	TEST_ASSERT_EQUAL(rte_eth_bond_xmit_policy_get(test_params->bonding_port_id),
+			BALANCE_XMIT_POLICY_RSS,
+			"balance xmit policy not as expected.");
+
 	/* Invalid port id */
 	TEST_ASSERT_FAIL(rte_eth_bond_xmit_policy_get(INVALID_PORT_ID),
 			"Expected call to failed as invalid port specified.");
@@ -3031,6 +3039,79 @@ test_balance_l34_tx_burst_ipv6_toggle_udp_port(void)
 	return balance_l34_tx_burst(0, 0, 0, 0, 1);
 }
 
+static int
+test_balance_rss_tx_burst(void)
+{
+	int i, burst_size_1, burst_size_2, nb_tx_1, nb_tx_2;
+
+	struct rte_mbuf *pkts_burst_1[MAX_PKT_BURST];
+	struct rte_mbuf *pkts_burst_2[MAX_PKT_BURST];
+
+	struct rte_eth_stats port_stats;
+
+	TEST_ASSERT_SUCCESS(initialize_bonding_device_with_members(
+			BONDING_MODE_BALANCE, 0, 2, 1),
+			"Failed to initialize_bonding_device_with_members.");
+
+	TEST_ASSERT_SUCCESS(rte_eth_bond_xmit_policy_set(
+			test_params->bonding_port_id, BALANCE_XMIT_POLICY_RSS),
+			"Failed to set balance xmit policy.");
+
+	burst_size_1 = 20;
+	burst_size_2 = 10;
+
+	/* Generate test bursts of packets of a same flow */
+	TEST_ASSERT_EQUAL(generate_test_burst(
+			pkts_burst_1, burst_size_1, 0, 1, 0, 0, 0),
+			burst_size_1, "failed to generate burst");
+
+	TEST_ASSERT_EQUAL(generate_test_burst(
+			pkts_burst_2, burst_size_2, 0, 1, 0, 0, 0),
+			burst_size_2, "failed to generate burst");
+
+	/*
+	 * Burst 1 has no RSS hash and is balanced on its layer 3+4 headers,
+	 * burst 2 carries an RSS hash which selects the other member.
+	 */
+	for (i = 0; i < burst_size_2; i++) {
+		pkts_burst_2[i]->ol_flags |= RTE_MBUF_F_RX_RSS_HASH;
+		pkts_burst_2[i]->hash.rss = UINT32_MAX;
+	}
+
+	/* Send burst 1 on bonding port */
+	nb_tx_1 = rte_eth_tx_burst(test_params->bonding_port_id, 0, pkts_burst_1,
+			burst_size_1);
+	TEST_ASSERT_EQUAL(nb_tx_1, burst_size_1, "tx burst failed");
+
+	/* Send burst 2 on bonding port */
+	nb_tx_2 = rte_eth_tx_burst(test_params->bonding_port_id, 0, pkts_burst_2,
+			burst_size_2);
+	TEST_ASSERT_EQUAL(nb_tx_2, burst_size_2, "tx burst failed");
+
+	/* Verify bonding port tx stats */
+	rte_eth_stats_get(test_params->bonding_port_id, &port_stats);
+	TEST_ASSERT_EQUAL(port_stats.opackets, (uint64_t)(nb_tx_1 + nb_tx_2),
+			"Bonding Port (%d) opackets value (%u) not as expected (%d)",
+			test_params->bonding_port_id, (unsigned int)port_stats.opackets,
+			nb_tx_1 + nb_tx_2);
+
+	/* Verify member ports tx stats */
+	rte_eth_stats_get(test_params->member_port_ids[0], &port_stats);
+	TEST_ASSERT_EQUAL(port_stats.opackets, (uint64_t)nb_tx_1,
+			"Member Port (%d) opackets value (%u) not as expected (%d)",
+			test_params->member_port_ids[0], (unsigned int)port_stats.opackets,
+			nb_tx_1);
+
+	rte_eth_stats_get(test_params->member_port_ids[1], &port_stats);
+	TEST_ASSERT_EQUAL(port_stats.opackets, (uint64_t)nb_tx_2,
+			"Member Port (%d) opackets value (%u) not as expected (%d)",
+			test_params->member_port_ids[1], (unsigned int)port_stats.opackets,
+			nb_tx_2);
+
+	/* Clean up and remove members from bonding device */
+	return remove_members_and_stop_bonding_device();
+}
+
 #define TEST_BAL_MEMBER_TX_FAIL_MEMBER_COUNT			(2)
 #define TEST_BAL_MEMBER_TX_FAIL_BURST_SIZE_1			(40)
 #define TEST_BAL_MEMBER_TX_FAIL_BURST_SIZE_2			(20)
@@ -5192,6 +5273,7 @@ static struct unit_test_suite link_bonding_test_suite  = {
 		TEST_CASE(test_balance_l34_tx_burst_ipv6_toggle_ip_addr),
 		TEST_CASE(test_balance_l34_tx_burst_vlan_ipv6_toggle_ip_addr),
 		TEST_CASE(test_balance_l34_tx_burst_ipv6_toggle_udp_port),
+		TEST_CASE(test_balance_rss_tx_burst),
 		TEST_CASE(test_balance_tx_burst_member_tx_fail),
 		TEST_CASE(test_balance_rx_burst),
 		TEST_CASE(test_balance_verify_promiscuous_enable_disable),
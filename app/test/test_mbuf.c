@@ -1897,6 +1897,71 @@ test_neg_pktmbuf_alloc_bulk(struct rte_mempool *pktmbuf_pool)
 	return 0;
 }
 
+/*
+ * Test for allocating a bulk of mbufs with a rearm template
+ */
+static int
+test_pktmbuf_alloc_bulk_rearm(struct rte_mempool *pktmbuf_pool)
+{
+	struct rte_mbuf_rearm_template tmpl;
+	struct rte_mbuf *mbufs[MEMPOOL_CACHE_SIZE];
+	struct rte_mbuf *m;
+	unsigned int i;
+	const uint16_t port = 3;
+
+	if (rte_pktmbuf_rearm_template_init(NULL, pktmbuf_pool, port) !=
+			-EINVAL) {
+		printf("%s: template init with NULL must fail\n", __func__);
+		return -1;
+	}
+	if (rte_pktmbuf_rearm_template_init(&tmpl, pktmbuf_pool, port) != 0) {
+		printf("%s: template init failed\n", __func__);
+		return -1;
+	}
+
+	/* Return dirty mbufs to the pool, to check they are all reset */
+	if (rte_pktmbuf_alloc_bulk(pktmbuf_pool, mbufs, RTE_DIM(mbufs)) != 0) {
+		printf("%s: bulk alloc failed\n", __func__);
+		return -1;
+	}
+	for (i = 0; i < RTE_DIM(mbufs); i++) {
+		m = mbufs[i];
+		m->data_off = 0;
+		m->port = 0;
+		m->ol_flags = RTE_MBUF_F_RX_VLAN | RTE_MBUF_F_RX_RSS_HASH;
+		m->packet_type = RTE_PTYPE_L2_ETHER;
+		m->pkt_len = MBUF_TEST_DATA_LEN;
+		m->data_len = MBUF_TEST_DATA_LEN;
+		m->vlan_tci = 1;
+		m->hash.rss = 1;
+	}
+	rte_pktmbuf_free_bulk(mbufs, RTE_DIM(mbufs));
+
+	if (rte_pktmbuf_alloc_bulk_rearm(pktmbuf_pool, mbufs, RTE_DIM(mbufs),
+			&tmpl) != 0) {
+		printf("%s: bulk alloc with rearm template failed\n", __func__);
+		return -1;
+	}
+	for (i = 0; i < RTE_DIM(mbufs); i++) {
+		m = mbufs[i];
+		if (m->data_off != RTE_PKTMBUF_HEADROOM ||
+				rte_mbuf_refcnt_read(m) != 1 ||
+				m->nb_segs != 1 || m->next != NULL ||
+				m->port != port || m->ol_flags != 0 ||
+				m->packet_type != 0 || m->pkt_len != 0 ||
+				m->data_len != 0 || m->vlan_tci != 0 ||
+				m->hash.rss != 0) {
+			printf("%s: mbuf %u not reset\n", __func__, i);
+			rte_pktmbuf_dump(stdout, m, 0);
+			rte_pktmbuf_free_bulk(mbufs, RTE_DIM(mbufs));
+			return -1;
+		}
+	}
+	rte_pktmbuf_free_bulk(mbufs, RTE_DIM(mbufs));
+
+	return 0;
+}
+
 /*
  * Test to read mbuf packet using rte_pktmbuf_read
  */
@@ -2908,6 +2973,12 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test for allocating a bulk of mbufs with a rearm template */
+	if (test_pktmbuf_alloc_bulk_rearm(pktmbuf_pool) < 0) {
+		printf("test_pktmbuf_alloc_bulk_rearm() failed\n");
+		goto err;
+	}
+
 	/* test to read mbuf packet */
 	if (test_pktmbuf_read(pktmbuf_pool) < 0) {
 		printf("test_rte_pktmbuf_read() failed\n");
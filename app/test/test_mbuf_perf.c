@@ -0,0 +1,107 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#include "test.h"
+
+/*
+ * Measures the cycles per mbuf of the bulk allocations used on the receive
+ * path of the software drivers: rte_pktmbuf_alloc_bulk(), which resets the
+ * mbufs one field at a time, and rte_pktmbuf_alloc_bulk_rearm(), which
+ * stores a rearm template. The mbufs go back to the mempool with
+ * rte_mempool_put_bulk(), the same for both, so that the difference is the
+ * cost of the allocation.
+ */
+
+#define MBUF_PERF_NB_MBUFS	8191
+#define MBUF_PERF_ITERATIONS	(1 << 18)
+
+static const unsigned int bulk_sizes[] = { 8, 32, 64 };
+
+static double
+mbuf_perf_alloc_bulk(struct rte_mempool *mp, unsigned int n)
+{
+	struct rte_mbuf *mbufs[64];
+	uint64_t start;
+	unsigned int i;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < MBUF_PERF_ITERATIONS; i++) {
+		if (rte_pktmbuf_alloc_bulk(mp, mbufs, n) != 0)
+			return -1;
+		rte_mempool_put_bulk(mp, (void **)mbufs, n);
+	}
+
+	return (double)(rte_rdtsc_precise() - start) /
+		((uint64_t)MBUF_PERF_ITERATIONS * n);
+}
+
+static double
+mbuf_perf_alloc_bulk_rearm(struct rte_mempool *mp, unsigned int n,
+		const struct rte_mbuf_rearm_template *tmpl)
+{
+	struct rte_mbuf *mbufs[64];
+	uint64_t start;
+	unsigned int i;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < MBUF_PERF_ITERATIONS; i++) {
+		if (rte_pktmbuf_alloc_bulk_rearm(mp, mbufs, n, tmpl) != 0)
+			return -1;
+		rte_mempool_put_bulk(mp, (void **)mbufs, n);
+	}
+
+	return (double)(rte_rdtsc_precise() - start) /
+		((uint64_t)MBUF_PERF_ITERATIONS * n);
+}
+
+static int
+test_mbuf_perf(void)
+{
+	struct rte_mbuf_rearm_template tmpl;
+	struct rte_mempool *mp;
+	double bulk, rearm;
+	unsigned int i;
+	int ret = -1;
+
+	mp = rte_pktmbuf_pool_create("mbuf_perf_pool", MBUF_PERF_NB_MBUFS,
+				     RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+				     RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	if (mp == NULL) {
+		printf("Failed to create mempool\n");
+		return -1;
+	}
+	if (rte_pktmbuf_rearm_template_init(&tmpl, mp, 0) != 0) {
+		printf("Failed to initialize rearm template\n");
+		goto out;
+	}
+
+	printf("\n### Testing mbuf bulk allocation ###\n");
+	for (i = 0; i < RTE_DIM(bulk_sizes); i++) {
+		bulk = mbuf_perf_alloc_bulk(mp, bulk_sizes[i]);
+		rearm = mbuf_perf_alloc_bulk_rearm(mp, bulk_sizes[i], &tmpl);
+		if (bulk < 0 || rearm < 0) {
+			printf("Failed to allocate %u mbufs\n", bulk_sizes[i]);
+			goto out;
+		}
+		printf("bulk %2u: alloc_bulk %.2f cycles/mbuf, "
+		       "alloc_bulk_rearm %.2f cycles/mbuf\n",
+		       bulk_sizes[i], bulk, rearm);
+	}
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	return ret;
+}
+
+REGISTER_PERF_TEST(mbuf_perf_autotest, test_mbuf_perf);
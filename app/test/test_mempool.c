@@ -835,6 +835,114 @@ test_mempool_flag_non_io_unset_when_populated_with_valid_iova(void)
 	return ret;
 }
 
+static int
+test_mempool_numa(void)
+{
+	struct rte_mempool *mp = NULL, *sub;
+	void **objtable = NULL;
+	unsigned int i, n;
+	int ret;
+
+	mp = rte_mempool_create_empty("test_numa_empty", MEMPOOL_SIZE,
+				      MEMPOOL_ELT_SIZE, 0, 0,
+				      SOCKET_ID_ANY, RTE_MEMPOOL_F_NUMA);
+	RTE_TEST_ASSERT(mp == NULL && rte_errno == EINVAL,
+			"NUMA flag is accepted by rte_mempool_create_empty()");
+
+	mp = rte_mempool_create("test_numa", MEMPOOL_SIZE, MEMPOOL_ELT_SIZE,
+				32, 0, NULL, NULL, my_obj_init, NULL,
+				SOCKET_ID_ANY, RTE_MEMPOOL_F_NUMA);
+	RTE_TEST_ASSERT_NOT_NULL(mp, "Cannot create NUMA mempool: %s",
+				 rte_strerror(rte_errno));
+	RTE_TEST_ASSERT(mp->flags & RTE_MEMPOOL_F_NUMA,
+			"NUMA flag is not set on the mempool");
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), MEMPOOL_SIZE,
+			      "Wrong count of available objects");
+
+	RTE_TEST_ASSERT_SUCCESS(test_mempool_basic(mp, 0),
+				"Basic test failed on NUMA mempool");
+	RTE_TEST_ASSERT_SUCCESS(test_mempool_basic(mp, 1),
+				"Basic test failed on NUMA mempool with user cache");
+
+	/* Every object lives in the sub-pool of one of the sockets */
+	objtable = malloc(MEMPOOL_SIZE * sizeof(void *));
+	RTE_TEST_ASSERT_NOT_NULL(objtable, "Cannot allocate object table");
+	n = MEMPOOL_SIZE;
+	RTE_TEST_ASSERT_SUCCESS(rte_mempool_get_bulk(mp, objtable, n),
+				"Cannot get all objects from NUMA mempool");
+	for (i = 0; i < n; i++) {
+		sub = rte_mempool_from_obj(objtable[i]);
+		if (sub == mp || sub == NULL ||
+		    (unsigned int)sub->socket_id >= RTE_MAX_NUMA_NODES)
+			break;
+	}
+	rte_mempool_put_bulk(mp, objtable, n);
+	RTE_TEST_ASSERT_EQUAL(i, n, "Object %u is not from a socket sub-pool",
+			      i);
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), MEMPOOL_SIZE,
+			      "Objects are missing after put");
+
+	rte_mempool_dump(stdout, mp);
+	ret = TEST_SUCCESS;
+
+exit:
+	free(objtable);
+	rte_mempool_free(mp);
+	return ret;
+}
+
+static int
+test_mempool_cache_adaptive(void)
+{
+	struct rte_mempool_cache *cache;
+	struct rte_mempool *mp = NULL;
+	void *objs[16 * 32];
+	unsigned int i, k;
+	int ret;
+
+	mp = rte_mempool_create("test_cache_adaptive", 8191, MEMPOOL_ELT_SIZE,
+				RTE_MEMPOOL_CACHE_MAX_SIZE, 0, NULL, NULL,
+				my_obj_init, NULL, SOCKET_ID_ANY,
+				RTE_MEMPOOL_F_CACHE_ADAPTIVE);
+	RTE_TEST_ASSERT_NOT_NULL(mp, "Cannot create adaptive mempool: %s",
+				 rte_strerror(rte_errno));
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	RTE_TEST_ASSERT_NOT_NULL(cache, "No default cache");
+	RTE_TEST_ASSERT(cache->size < RTE_MEMPOOL_CACHE_MAX_SIZE,
+			"Adaptive cache does not start small");
+
+	/* Bursts larger than the cache make it grow to its maximum */
+	for (i = 0; i < 8 * RTE_MEMPOOL_CACHE_ADAPT_WINDOW / 32; i++) {
+		for (k = 0; k < 16; k++)
+			RTE_TEST_ASSERT_SUCCESS(rte_mempool_get_bulk(mp,
+					&objs[k * 32], 32), "Cannot get objects");
+		for (k = 0; k < 16; k++)
+			rte_mempool_put_bulk(mp, &objs[k * 32], 32);
+	}
+	rte_mempool_dump(stdout, mp);
+	RTE_TEST_ASSERT_EQUAL(cache->size, RTE_MEMPOOL_CACHE_MAX_SIZE,
+			      "Adaptive cache did not grow: %u", cache->size);
+
+	/* Single object requests leave most of it unused, it shrinks back */
+	for (i = 0; i < 8 * RTE_MEMPOOL_CACHE_ADAPT_WINDOW; i++) {
+		RTE_TEST_ASSERT_SUCCESS(rte_mempool_get(mp, &objs[0]),
+					"Cannot get an object");
+		rte_mempool_put(mp, objs[0]);
+	}
+	rte_mempool_dump(stdout, mp);
+	RTE_TEST_ASSERT(cache->size < RTE_MEMPOOL_CACHE_MAX_SIZE / 4,
+			"Adaptive cache did not shrink: %u", cache->size);
+	RTE_TEST_ASSERT(cache->len <= cache->flushthresh,
+			"Objects stranded in the cache: %u", cache->len);
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_avail_count(mp), 8191,
+			      "Objects are missing after adaptation");
+	ret = TEST_SUCCESS;
+
+exit:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 #pragma pop_macro("RTE_TEST_TRACE_FAILURE")
 
 static int
@@ -1028,6 +1136,14 @@ test_mempool(void)
 	if (test_mempool_flag_non_io_unset_when_populated_with_valid_iova() < 0)
 		GOTO_ERR(ret, err);
 
+	/* test mempool backed by per-socket sub-pools */
+	if (test_mempool_numa() < 0)
+		GOTO_ERR(ret, err);
+
+	/* test per-lcore caches resizing themselves */
+	if (test_mempool_cache_adaptive() < 0)
+		GOTO_ERR(ret, err);
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -0,0 +1,193 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include "test.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_node_ethdev_rx_perf(void)
+{
+	printf("node_ethdev_rx_perf not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <rte_bus_vdev.h>
+#include <rte_ethdev.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_mbuf.h>
+#include <rte_node_eth_api.h>
+
+#define RX_PERF_VDEV	   "net_null_node_rx_perf"
+#define RX_PERF_NB_QUEUES  8
+#define RX_PERF_NB_MBUFS   8191
+#define RX_PERF_NB_DESC	   512
+#define RX_PERF_WALKS	   (1 << 18)
+
+static uint16_t rx_perf_port = RTE_MAX_ETHPORTS;
+static struct rte_mempool *rx_perf_mp;
+
+static int
+rx_perf_port_setup(void)
+{
+	struct rte_node_ethdev_rx_queue queues[RX_PERF_NB_QUEUES];
+	struct rte_node_ethdev_config cfg;
+	struct rte_eth_conf port_conf;
+	uint16_t q;
+	int rc;
+
+	rx_perf_mp = rte_pktmbuf_pool_create("node_rx_perf_pool", RX_PERF_NB_MBUFS,
+					     RTE_MEMPOOL_CACHE_MAX_SIZE,
+					     RTE_CACHE_LINE_SIZE,
+					     RTE_MBUF_DEFAULT_BUF_SIZE,
+					     rte_socket_id());
+	TEST_ASSERT_NOT_NULL(rx_perf_mp, "Failed to create mempool");
+
+	rc = rte_vdev_init(RX_PERF_VDEV, NULL);
+	TEST_ASSERT_SUCCESS(rc, "Failed to create %s", RX_PERF_VDEV);
+	rc = rte_eth_dev_get_port_by_name(RX_PERF_VDEV, &rx_perf_port);
+	TEST_ASSERT_SUCCESS(rc, "Failed to find %s", RX_PERF_VDEV);
+
+	memset(&port_conf, 0, sizeof(port_conf));
+	rc = rte_eth_dev_configure(rx_perf_port, RX_PERF_NB_QUEUES, 1, &port_conf);
+	TEST_ASSERT_SUCCESS(rc, "Failed to configure port %u", rx_perf_port);
+	for (q = 0; q < RX_PERF_NB_QUEUES; q++) {
+		rc = rte_eth_rx_queue_setup(rx_perf_port, q, RX_PERF_NB_DESC,
+					    rte_socket_id(), NULL, rx_perf_mp);
+		TEST_ASSERT_SUCCESS(rc, "Failed to setup rxq %u", q);
+	}
+	rc = rte_eth_tx_queue_setup(rx_perf_port, 0, RX_PERF_NB_DESC,
+				    rte_socket_id(), NULL);
+	TEST_ASSERT_SUCCESS(rc, "Failed to setup txq");
+	rc = rte_eth_dev_start(rx_perf_port);
+	TEST_ASSERT_SUCCESS(rc, "Failed to start port %u", rx_perf_port);
+
+	/* Nodes can't be unregistered, keep the ones of a previous run */
+	if (rte_node_from_name("ethdev_rx_mq-perf") != RTE_NODE_ID_INVALID)
+		return 0;
+
+	/* One ethdev_rx-<port>-<queue> node per queue */
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.port_id = rx_perf_port;
+	cfg.num_rx_queues = RX_PERF_NB_QUEUES;
+	cfg.num_tx_queues = 1;
+	cfg.mp = &rx_perf_mp;
+	cfg.mp_count = 1;
+	rc = rte_node_eth_config(&cfg, 1, 1);
+	TEST_ASSERT_SUCCESS(rc, "Failed to configure ethdev nodes");
+
+	/* A single ethdev_rx_mq-perf node for all the queues */
+	for (q = 0; q < RX_PERF_NB_QUEUES; q++) {
+		queues[q].port_id = rx_perf_port;
+		queues[q].queue_id = q;
+		queues[q].weight = 1;
+	}
+	rc = rte_node_eth_rx_mq_config("perf", queues, RX_PERF_NB_QUEUES);
+	TEST_ASSERT_SUCCESS(rc, "Failed to configure multi-queue rx node");
+
+	return 0;
+}
+
+static void
+rx_perf_port_teardown(void)
+{
+	if (rx_perf_port != RTE_MAX_ETHPORTS) {
+		rte_eth_dev_stop(rx_perf_port);
+		rte_eth_dev_close(rx_perf_port);
+		rte_vdev_uninit(RX_PERF_VDEV);
+		rx_perf_port = RTE_MAX_ETHPORTS;
+	}
+	rte_mempool_free(rx_perf_mp);
+	rx_perf_mp = NULL;
+}
+
+static rte_graph_t
+rx_perf_graph_create(const char *name, const char *pattern)
+{
+	const char *patterns[] = {pattern, "pkt_cls", "pkt_drop"};
+	struct rte_graph_param prm;
+
+	memset(&prm, 0, sizeof(prm));
+	prm.socket_id = rte_socket_id();
+	prm.nb_node_patterns = RTE_DIM(patterns);
+	prm.node_patterns = patterns;
+
+	return rte_graph_create(name, &prm);
+}
+
+static int
+rx_perf_measure(rte_graph_t id, const char *desc)
+{
+	struct rte_graph *graph = rte_graph_lookup(rte_graph_id_to_name(id));
+	struct rte_eth_stats stats;
+	uint64_t start, cycles;
+	uint32_t i;
+
+	TEST_ASSERT_NOT_NULL(graph, "Failed to lookup graph %u", id);
+
+	rte_eth_stats_reset(rx_perf_port);
+	start = rte_rdtsc_precise();
+	for (i = 0; i < RX_PERF_WALKS; i++)
+		rte_graph_walk(graph);
+	cycles = rte_rdtsc_precise() - start;
+	rte_eth_stats_get(rx_perf_port, &stats);
+
+	TEST_ASSERT(stats.ipackets != 0, "No packet received by %s", desc);
+	printf("%-28s: %" PRIu64 " pkts, %.2f cycles/pkt\n", desc,
+	       stats.ipackets, (double)cycles / stats.ipackets);
+
+	return 0;
+}
+
+static int
+test_node_ethdev_rx_perf(void)
+{
+	rte_graph_t single, multi;
+	char pattern[RTE_NODE_NAMESIZE];
+	int rc;
+
+	rc = rx_perf_port_setup();
+	if (rc != 0)
+		goto teardown;
+
+	/*
+	 * Both graphs exist while measuring, so that every queue carries the
+	 * same soft ptype callbacks for both runs.
+	 */
+	rc = TEST_FAILED;
+	snprintf(pattern, sizeof(pattern), "ethdev_rx-%u-*", rx_perf_port);
+	single = rx_perf_graph_create("rx_perf_single", pattern);
+	if (single == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create graph\n");
+		goto teardown;
+	}
+	multi = rx_perf_graph_create("rx_perf_multi", "ethdev_rx_mq-perf");
+	if (multi == RTE_GRAPH_ID_INVALID) {
+		printf("Failed to create multi-queue graph\n");
+		goto destroy_single;
+	}
+
+	rc = rx_perf_measure(single, "ethdev_rx, node per queue");
+	if (rc == 0)
+		rc = rx_perf_measure(multi, "ethdev_rx_mq, one node");
+
+	rte_graph_destroy(multi);
+destroy_single:
+	rte_graph_destroy(single);
+teardown:
+	rx_perf_port_teardown();
+
+	return rc;
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_PERF_TEST(node_ethdev_rx_perf_autotest, test_node_ethdev_rx_perf);
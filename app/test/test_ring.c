@@ -24,6 +24,7 @@
 #include <rte_malloc.h>
 #include <rte_ring.h>
 #include <rte_ring_elem.h>
+#include <rte_ring_set.h>
 #include <rte_random.h>
 #include <rte_errno.h>
 #include <rte_hexdump.h>
@@ -1190,6 +1191,173 @@ test_ring_with_exact_size(void)
 	return -1;
 }
 
+/*
+ * Test the ring set: weighted round-robin between the rings with objects,
+ * per ring ordering, and rings found empty being polled again once their
+ * producer moved.
+ */
+static int
+test_ring_set(void)
+{
+	static const unsigned int flags[] = {
+		RING_F_SP_ENQ | RING_F_SC_DEQ,
+		RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ,
+		RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ,
+	};
+	struct rte_ring *r[RTE_DIM(flags)] = { NULL };
+	unsigned int next[RTE_DIM(flags)] = { 0 };
+	struct rte_ring_set set;
+	char name[RTE_RING_NAMESIZE];
+	void *objs[64];
+	unsigned int i, n, ring;
+	uintptr_t v;
+
+	printf("Test ring set\n");
+
+	if (rte_ring_set_init(&set) != 0) {
+		printf("%s: error, can't init ring set\n", __func__);
+		return -1;
+	}
+	for (i = 0; i != RTE_DIM(flags); i++) {
+		snprintf(name, sizeof(name), "test_ring_set_%u", i);
+		r[i] = rte_ring_create(name, 256, SOCKET_ID_ANY, flags[i]);
+		if (r[i] == NULL) {
+			printf("%s: error, can't create ring\n", __func__);
+			goto test_fail;
+		}
+		/* Ring 0 gives twice as many objects per round */
+		TEST_RING_VERIFY(rte_ring_set_add(&set, r[i],
+				i == 0 ? 16 : 8) == (int)i, r[i],
+				goto test_fail);
+	}
+	TEST_RING_VERIFY(rte_ring_set_add(&set, r[0], 0) == -EEXIST, r[0],
+			goto test_fail);
+	TEST_RING_VERIFY(rte_ring_set_add(&set, NULL, 0) == -EINVAL, r[0],
+			goto test_fail);
+	TEST_RING_VERIFY(rte_ring_set_dequeue_burst(&set, objs, 32) == 0,
+			r[0], goto test_fail);
+
+	/* Objects carry their ring index and their position in the ring */
+	for (i = 0; i != RTE_DIM(flags); i++)
+		for (v = 0; v < 100; v++)
+			TEST_RING_VERIFY(rte_ring_enqueue(r[i],
+				(void *)((v << 8) | i)) == 0, r[i],
+				goto test_fail);
+
+	/* 16 + 8 + 8 objects per round */
+	n = rte_ring_set_dequeue_burst(&set, objs, 64);
+	TEST_RING_VERIFY(n == 64, r[0], goto test_fail);
+	for (i = 0; i != n; i++)
+		next[(uintptr_t)objs[i] & 0xff]++;
+	TEST_RING_VERIFY(next[0] == 32 && next[1] == 16 && next[2] == 16,
+			r[0], goto test_fail);
+
+	/* Drain, checking the order in each ring */
+	memset(next, 0, sizeof(next));
+	for (v = 0; v != 64; v++) {
+		ring = (uintptr_t)objs[v] & 0xff;
+		TEST_RING_VERIFY(((uintptr_t)objs[v] >> 8) == next[ring]++,
+				r[ring], goto test_fail);
+	}
+	while ((n = rte_ring_set_dequeue_burst(&set, objs, 20)) != 0) {
+		for (i = 0; i != n; i++) {
+			ring = (uintptr_t)objs[i] & 0xff;
+			TEST_RING_VERIFY(((uintptr_t)objs[i] >> 8) ==
+					next[ring]++, r[ring], goto test_fail);
+		}
+	}
+	for (i = 0; i != RTE_DIM(flags); i++)
+		TEST_RING_VERIFY(next[i] == 100 && rte_ring_empty(r[i]), r[i],
+				goto test_fail);
+
+	/* A ring found empty is polled again when its producer moves */
+	TEST_RING_VERIFY(rte_ring_enqueue(r[2], objs[0]) == 0, r[2],
+			goto test_fail);
+	TEST_RING_VERIFY(rte_ring_set_dequeue_burst(&set, objs, 32) == 1,
+			r[2], goto test_fail);
+
+	for (i = 0; i != RTE_DIM(flags); i++)
+		rte_ring_free(r[i]);
+	return 0;
+
+test_fail:
+	for (i = 0; i != RTE_DIM(flags); i++)
+		rte_ring_free(r[i]);
+	return -1;
+}
+
+static int
+test_ring_wait_producer(void *arg)
+{
+	struct rte_ring *r = arg;
+
+	rte_delay_ms(10);
+	return rte_ring_enqueue(r, r);
+}
+
+/*
+ * Test waiting for entries: timeout on an empty ring, and wakeup on
+ * an enqueue from another lcore when one is available.
+ */
+static int
+test_ring_wait(void)
+{
+	const uint64_t timeout = rte_get_tsc_hz() / 100;
+	struct rte_ring *r;
+	unsigned int lcore_id;
+	uint64_t start, elapsed;
+	void *obj;
+
+	printf("Test ring wait\n");
+
+	r = rte_ring_create("test_ring_wait", 16, SOCKET_ID_ANY, 0);
+	if (r == NULL) {
+		printf("%s: error, can't create ring\n", __func__);
+		return -1;
+	}
+
+	TEST_RING_VERIFY(rte_ring_wait(r, 0, timeout) == -EINVAL, r,
+			goto test_fail);
+	TEST_RING_VERIFY(rte_ring_wait(r, rte_ring_get_capacity(r) + 1,
+			timeout) == -EINVAL, r, goto test_fail);
+
+	start = rte_get_tsc_cycles();
+	TEST_RING_VERIFY(rte_ring_wait(r, 1, timeout) == -ETIMEDOUT, r,
+			goto test_fail);
+	elapsed = rte_get_tsc_cycles() - start;
+	TEST_RING_VERIFY(elapsed >= timeout, r, goto test_fail);
+
+	TEST_RING_VERIFY(rte_ring_enqueue(r, r) == 0, r, goto test_fail);
+	TEST_RING_VERIFY(rte_ring_wait(r, 1, 0) == 0, r, goto test_fail);
+	TEST_RING_VERIFY(rte_ring_wait(r, 2, 0) == -ETIMEDOUT, r,
+			goto test_fail);
+	TEST_RING_VERIFY(rte_ring_dequeue(r, &obj) == 0, r, goto test_fail);
+
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	if (lcore_id < RTE_MAX_LCORE) {
+		if (rte_eal_remote_launch(test_ring_wait_producer, r,
+				lcore_id) != 0)
+			goto test_fail;
+		start = rte_get_tsc_cycles();
+		TEST_RING_VERIFY(rte_ring_wait(r, 1, 100 * timeout) == 0, r,
+				goto test_wait_fail);
+		elapsed = rte_get_tsc_cycles() - start;
+		TEST_RING_VERIFY(rte_eal_wait_lcore(lcore_id) == 0, r,
+				goto test_fail);
+		printf("Waited %"PRIu64" us for an enqueue delayed by 10 ms\n",
+			elapsed * 1000000 / rte_get_tsc_hz());
+	}
+
+	rte_ring_free(r);
+	return 0;
+
+test_wait_fail:
+	rte_eal_wait_lcore(lcore_id);
+test_fail:
+	rte_ring_free(r);
+	return -1;
+}
+
 static int
 test_ring(void)
 {
@@ -1207,6 +1375,12 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	if (test_ring_set() < 0)
+		goto test_fail;
+
+	if (test_ring_wait() < 0)
+		goto test_fail;
+
 	/* Burst and bulk operations with sp/sc, mp/mc and default.
 	 * The test cases are split into smaller test cases to
 	 * help clang compile faster.
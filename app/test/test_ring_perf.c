@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <inttypes.h>
 #include <rte_ring.h>
+#include <rte_ring_set.h>
 #include <rte_cycles.h>
 #include <rte_launch.h>
 #include <rte_pause.h>
@@ -566,6 +567,94 @@ test_ring_perf_esize(const int esize)
 	return -1;
 }
 
+/*
+ * Compare polling a set of rings with rte_ring_set_dequeue_burst() to a
+ * loop calling rte_ring_dequeue_burst() on each ring, with all the rings
+ * empty, then with a burst produced in one of the rings before each poll.
+ */
+#define RING_SET_PERF_MAX_RINGS 64
+#define RING_SET_PERF_ITER (1 << 20)
+
+static unsigned int
+ring_set_perf_naive_poll(struct rte_ring **r, unsigned int nb_rings,
+		void **burst)
+{
+	unsigned int i, n = 0;
+
+	for (i = 0; i < nb_rings && n < MAX_BURST; i++)
+		n += rte_ring_dequeue_burst(r[i], &burst[n], MAX_BURST - n,
+				NULL);
+	return n;
+}
+
+static int
+test_ring_set_perf(void)
+{
+	static const unsigned int nb_rings_list[] = { 16, 64 };
+	struct rte_ring *r[RING_SET_PERF_MAX_RINGS] = { NULL };
+	struct rte_ring_set set;
+	char name[RTE_RING_NAMESIZE];
+	void *burst[MAX_BURST] = { NULL };
+	uint64_t start, naive_empty, set_empty, naive_busy, set_busy;
+	unsigned int i, j, nb_rings;
+	int ret = -1;
+
+	for (i = 0; i < RING_SET_PERF_MAX_RINGS; i++) {
+		snprintf(name, sizeof(name), RING_NAME "_SET_%u", i);
+		r[i] = rte_ring_create(name, RING_SIZE, rte_socket_id(),
+				RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (r[i] == NULL)
+			goto out;
+	}
+
+	for (j = 0; j < RTE_DIM(nb_rings_list); j++) {
+		nb_rings = nb_rings_list[j];
+		rte_ring_set_init(&set);
+		for (i = 0; i < nb_rings; i++)
+			rte_ring_set_add(&set, r[i], MAX_BURST);
+
+		start = rte_rdtsc();
+		for (i = 0; i < RING_SET_PERF_ITER; i++)
+			ring_set_perf_naive_poll(r, nb_rings, burst);
+		naive_empty = rte_rdtsc() - start;
+
+		start = rte_rdtsc();
+		for (i = 0; i < RING_SET_PERF_ITER; i++)
+			rte_ring_set_dequeue_burst(&set, burst, MAX_BURST);
+		set_empty = rte_rdtsc() - start;
+
+		start = rte_rdtsc();
+		for (i = 0; i < RING_SET_PERF_ITER; i++) {
+			rte_ring_enqueue_burst(r[i % nb_rings], burst,
+					bulk_sizes[0], NULL);
+			ring_set_perf_naive_poll(r, nb_rings, burst);
+		}
+		naive_busy = rte_rdtsc() - start;
+
+		start = rte_rdtsc();
+		for (i = 0; i < RING_SET_PERF_ITER; i++) {
+			rte_ring_enqueue_burst(r[i % nb_rings], burst,
+					bulk_sizes[0], NULL);
+			rte_ring_set_dequeue_burst(&set, burst, MAX_BURST);
+		}
+		set_busy = rte_rdtsc() - start;
+
+		printf("%u rings, all empty: naive poll %.2f, ring set %.2f cycles/poll\n",
+			nb_rings, (double)naive_empty / RING_SET_PERF_ITER,
+			(double)set_empty / RING_SET_PERF_ITER);
+		printf("%u rings, one burst of %u: naive poll %.2f, ring set %.2f cycles/poll\n",
+			nb_rings, bulk_sizes[0],
+			(double)naive_busy / RING_SET_PERF_ITER,
+			(double)set_busy / RING_SET_PERF_ITER);
+	}
+	ret = 0;
+
+out:
+	for (i = 0; i < RING_SET_PERF_MAX_RINGS; i++)
+		rte_ring_free(r[i]);
+	return ret;
+}
+
 static int
 test_ring_perf(void)
 {
@@ -576,6 +665,10 @@ test_ring_perf(void)
 	if (test_ring_perf_esize(16) == -1)
 		return -1;
 
+	printf("\n### Testing ring set dequeue ###\n");
+	if (test_ring_set_perf() == -1)
+		return -1;
+
 	return 0;
 }
 
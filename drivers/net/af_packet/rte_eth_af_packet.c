@@ -23,6 +23,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
@@ -35,24 +36,36 @@
 #define ETH_AF_PACKET_FRAMESIZE_ARG	"framesz"
 #define ETH_AF_PACKET_FRAMECOUNT_ARG	"framecnt"
 #define ETH_AF_PACKET_QDISC_BYPASS_ARG	"qdisc_bypass"
+#define ETH_AF_PACKET_TPACKET_V3_ARG	"tpacket_v3"
+#define ETH_AF_PACKET_BLOCK_TOV_ARG	"blocktov"
 
 #define DFLT_FRAME_SIZE		(1 << 11)
 #define DFLT_FRAME_COUNT	(1 << 9)
+#define DFLT_V3_BLOCK_SIZE	(1 << 16)
+#define DFLT_BLOCK_TOV		1
 
 struct pkt_rx_queue {
 	int sockfd;
 
-	struct iovec *rd;
+	struct iovec *rd; /* frames, or blocks in TPACKET_V3 mode */
 	uint8_t *map;
 	unsigned int framecount;
 	unsigned int framenum;
 
+	/* TPACKET_V3 mode */
+	unsigned int blockcount;
+	unsigned int blocknum;
+	unsigned int pkts_left; /* packets left in the current block */
+	struct tpacket3_hdr *ppd; /* next packet of the current block */
+
 	struct rte_mempool *mb_pool;
+	struct rte_mbuf_rearm_template mbuf_initializer;
 	uint16_t in_port;
 	uint8_t vlan_strip;
 
 	volatile unsigned long rx_pkts;
 	volatile unsigned long rx_bytes;
+	volatile unsigned long err_pkts;
 };
 
 struct pkt_tx_queue {
@@ -77,6 +90,7 @@ struct pmd_internals {
 	struct rte_ether_addr eth_addr;
 
 	struct tpacket_req req;
+	unsigned int tpacket_v3;
 
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
@@ -90,6 +104,8 @@ static const char *valid_arguments[] = {
 	ETH_AF_PACKET_FRAMESIZE_ARG,
 	ETH_AF_PACKET_FRAMECOUNT_ARG,
 	ETH_AF_PACKET_QDISC_BYPASS_ARG,
+	ETH_AF_PACKET_TPACKET_V3_ARG,
+	ETH_AF_PACKET_BLOCK_TOV_ARG,
 	NULL
 };
 
@@ -110,6 +126,29 @@ RTE_LOG_REGISTER_DEFAULT(af_packet_logtype, NOTICE);
 	rte_log(RTE_LOG_ ## level, af_packet_logtype, \
 		"%s(): " fmt ":%s\n", __func__, ##args, strerror(errno))
 
+/*
+ * Allocate the mbufs for nb_rx packets at once. When the pool runs short,
+ * allocate them one by one to receive as many packets as the pool still
+ * has mbufs for.
+ */
+static inline unsigned int
+rx_alloc_mbufs(struct pkt_rx_queue *pkt_q, struct rte_mbuf **bufs,
+	       unsigned int nb_rx)
+{
+	unsigned int i;
+
+	if (likely(rte_pktmbuf_alloc_bulk_rearm(pkt_q->mb_pool, bufs, nb_rx,
+			&pkt_q->mbuf_initializer) == 0))
+		return nb_rx;
+
+	for (i = 0; i < nb_rx; i++) {
+		if (rte_pktmbuf_alloc_bulk_rearm(pkt_q->mb_pool, &bufs[i], 1,
+				&pkt_q->mbuf_initializer) != 0)
+			break;
+	}
+	return i;
+}
+
 static uint16_t
 eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -120,27 +159,35 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	struct pkt_rx_queue *pkt_q = queue;
 	uint16_t num_rx = 0;
 	unsigned long num_rx_bytes = 0;
-	unsigned int framecount, framenum;
+	unsigned int framecount, framenum, nb_rx;
 
 	if (unlikely(nb_pkts == 0))
 		return 0;
 
 	/*
-	 * Reads the given number of packets from the AF_PACKET socket one by
-	 * one and copies the packet data into a newly allocated mbuf.
+	 * Counts the packets ready in the AF_PACKET socket ring, allocates
+	 * their mbufs at once, then copies the packet data one by one. When
+	 * the pool runs short, only the packets that got an mbuf are read.
 	 */
 	framecount = pkt_q->framecount;
 	framenum = pkt_q->framenum;
-	for (i = 0; i < nb_pkts; i++) {
-		/* point at the next incoming frame */
+	for (nb_rx = 0; nb_rx < nb_pkts; nb_rx++) {
 		ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
 		if ((ppd->tp_status & TP_STATUS_USER) == 0)
 			break;
+		if (++framenum >= framecount)
+			framenum = 0;
+	}
+	if (nb_rx != 0)
+		nb_rx = rx_alloc_mbufs(pkt_q, bufs, nb_rx);
+	if (nb_rx == 0)
+		return 0;
 
-		/* allocate the next mbuf */
-		mbuf = rte_pktmbuf_alloc(pkt_q->mb_pool);
-		if (unlikely(mbuf == NULL))
-			break;
+	framenum = pkt_q->framenum;
+	for (i = 0; i < nb_rx; i++) {
+		/* point at the next incoming frame */
+		ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
+		mbuf = bufs[i];
 
 		/* packet will fit in the mbuf, go ahead and receive it */
 		rte_pktmbuf_pkt_len(mbuf) = rte_pktmbuf_data_len(mbuf) = ppd->tp_snaplen;
@@ -160,7 +207,6 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		ppd->tp_status = TP_STATUS_KERNEL;
 		if (++framenum >= framecount)
 			framenum = 0;
-		mbuf->port = pkt_q->in_port;
 
 		/* account for the receive frame */
 		bufs[i] = mbuf;
@@ -173,6 +219,150 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Give consumed blocks back to the kernel, once all their packets are copied.
+ */
+static inline void
+rx_v3_release_blocks(struct pkt_rx_queue *pkt_q, unsigned int blocknum,
+		     unsigned int nb_blocks)
+{
+	struct tpacket_block_desc *pbd;
+
+	rte_atomic_thread_fence(rte_memory_order_release);
+	while (nb_blocks-- != 0) {
+		pbd = (struct tpacket_block_desc *) pkt_q->rd[blocknum].iov_base;
+		pbd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+		if (++blocknum >= pkt_q->blockcount)
+			blocknum = 0;
+	}
+}
+
+/*
+ * Receive from a TPACKET_V3 ring, where the kernel fills whole blocks of
+ * packets and hands them over when full or when the block timeout expires.
+ */
+static uint16_t
+eth_af_packet_rx_v3(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct tpacket_block_desc *pbd;
+	struct tpacket3_hdr *ppd;
+	struct rte_mbuf *mbuf;
+	uint8_t *pbuf;
+	struct pkt_rx_queue *pkt_q = queue;
+	unsigned long num_rx_bytes = 0;
+	unsigned int blockcount, blocknum, first_block, nb_blocks;
+	unsigned int i, nb_rx, num_rx, pkts_left;
+
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	/*
+	 * Counts the packets left in the current block and in the next
+	 * blocks handed over by the kernel.
+	 */
+	blockcount = pkt_q->blockcount;
+	first_block = pkt_q->blocknum;
+	pkts_left = pkt_q->pkts_left;
+	nb_rx = pkts_left;
+	blocknum = first_block;
+	nb_blocks = 0;
+	if (pkts_left != 0) {
+		nb_blocks = 1;
+		if (++blocknum >= blockcount)
+			blocknum = 0;
+	}
+	while (nb_rx < nb_pkts && nb_blocks < blockcount) {
+		pbd = (struct tpacket_block_desc *) pkt_q->rd[blocknum].iov_base;
+		if ((pbd->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+			break;
+		/* read the block content after its status */
+		rte_atomic_thread_fence(rte_memory_order_acquire);
+		nb_rx += pbd->hdr.bh1.num_pkts;
+		nb_blocks++;
+		if (++blocknum >= blockcount)
+			blocknum = 0;
+	}
+	if (nb_rx == 0) {
+		/* Only empty blocks, give them back */
+		if (nb_blocks != 0) {
+			rx_v3_release_blocks(pkt_q, first_block, nb_blocks);
+			pkt_q->blocknum = blocknum;
+		}
+		return 0;
+	}
+
+	nb_rx = rx_alloc_mbufs(pkt_q, bufs,
+			RTE_MIN(nb_rx, (unsigned int)nb_pkts));
+	if (nb_rx == 0)
+		return 0;
+
+	blocknum = first_block;
+	nb_blocks = 0;
+	num_rx = 0;
+	ppd = pkt_q->ppd;
+	for (i = 0; i < nb_rx; i++) {
+		/* open the next block, skipping the empty ones */
+		while (pkts_left == 0) {
+			pbd = (struct tpacket_block_desc *) pkt_q->rd[blocknum].iov_base;
+			pkts_left = pbd->hdr.bh1.num_pkts;
+			ppd = (struct tpacket3_hdr *) ((uint8_t *) pbd +
+				pbd->hdr.bh1.offset_to_first_pkt);
+			if (pkts_left == 0) {
+				nb_blocks++;
+				if (++blocknum >= blockcount)
+					blocknum = 0;
+			}
+		}
+		mbuf = bufs[num_rx];
+
+		/*
+		 * Packets are only bounded by the block size, drop those that
+		 * do not fit in the mbuf and reuse it for the next one.
+		 */
+		if (unlikely(ppd->tp_snaplen > rte_pktmbuf_tailroom(mbuf))) {
+			pkt_q->err_pkts++;
+			goto next_pkt;
+		}
+
+		rte_pktmbuf_pkt_len(mbuf) = rte_pktmbuf_data_len(mbuf) = ppd->tp_snaplen;
+		pbuf = (uint8_t *) ppd + ppd->tp_mac;
+		memcpy(rte_pktmbuf_mtod(mbuf, void *), pbuf, rte_pktmbuf_data_len(mbuf));
+
+		/* check for vlan info */
+		if (ppd->tp_status & TP_STATUS_VLAN_VALID) {
+			mbuf->vlan_tci = ppd->hv1.tp_vlan_tci;
+			mbuf->ol_flags |= (RTE_MBUF_F_RX_VLAN | RTE_MBUF_F_RX_VLAN_STRIPPED);
+
+			if (!pkt_q->vlan_strip && rte_vlan_insert(&mbuf))
+				PMD_LOG(ERR, "Failed to reinsert VLAN tag");
+		}
+
+		/* account for the receive frame */
+		bufs[num_rx++] = mbuf;
+		num_rx_bytes += mbuf->pkt_len;
+
+next_pkt:
+		/* advance to the next packet, or past the finished block */
+		ppd = (struct tpacket3_hdr *) ((uint8_t *) ppd + ppd->tp_next_offset);
+		if (--pkts_left == 0) {
+			nb_blocks++;
+			if (++blocknum >= blockcount)
+				blocknum = 0;
+		}
+	}
+	if (unlikely(num_rx != nb_rx))
+		rte_pktmbuf_free_bulk(&bufs[num_rx], nb_rx - num_rx);
+
+	if (nb_blocks != 0)
+		rx_v3_release_blocks(pkt_q, first_block, nb_blocks);
+	pkt_q->blocknum = blocknum;
+	pkt_q->pkts_left = pkts_left;
+	pkt_q->ppd = ppd;
+	pkt_q->rx_pkts += num_rx;
+	pkt_q->rx_bytes += num_rx_bytes;
+	return num_rx;
+}
+
 /*
  * Check if there is an available frame in the ring
  */
@@ -389,7 +579,8 @@ static int
 eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 {
 	unsigned i, imax;
-	unsigned long rx_total = 0, tx_total = 0, tx_err_total = 0;
+	unsigned long rx_total = 0, rx_err_total = 0;
+	unsigned long tx_total = 0, tx_err_total = 0;
 	unsigned long rx_bytes_total = 0, tx_bytes_total = 0;
 	const struct pmd_internals *internal = dev->data->dev_private;
 
@@ -399,6 +590,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 		igb_stats->q_ipackets[i] = internal->rx_queue[i].rx_pkts;
 		igb_stats->q_ibytes[i] = internal->rx_queue[i].rx_bytes;
 		rx_total += igb_stats->q_ipackets[i];
+		rx_err_total += internal->rx_queue[i].err_pkts;
 		rx_bytes_total += igb_stats->q_ibytes[i];
 	}
 
@@ -413,6 +605,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 	}
 
 	igb_stats->ipackets = rx_total;
+	igb_stats->ierrors = rx_err_total;
 	igb_stats->ibytes = rx_bytes_total;
 	igb_stats->opackets = tx_total;
 	igb_stats->oerrors = tx_err_total;
@@ -428,6 +621,7 @@ eth_stats_reset(struct rte_eth_dev *dev)
 
 	for (i = 0; i < internal->nb_queues; i++) {
 		internal->rx_queue[i].rx_pkts = 0;
+		internal->rx_queue[i].err_pkts = 0;
 		internal->rx_queue[i].rx_bytes = 0;
 	}
 
@@ -440,11 +634,30 @@ eth_stats_reset(struct rte_eth_dev *dev)
 	return 0;
 }
 
+/*
+ * Unmap the rings of a queue pair. The Tx ring follows the Rx ring in a
+ * single mapping, except in TPACKET_V3 mode where each has its own socket.
+ */
+static void
+eth_af_packet_unmap(struct pmd_internals *internals, unsigned int q)
+{
+	size_t ring_size = (size_t)internals->req.tp_block_size *
+		internals->req.tp_block_nr;
+
+	if (internals->tpacket_v3) {
+		if (internals->tx_queue[q].map != MAP_FAILED)
+			munmap(internals->tx_queue[q].map, ring_size);
+	} else {
+		ring_size *= 2;
+	}
+	if (internals->rx_queue[q].map != MAP_FAILED)
+		munmap(internals->rx_queue[q].map, ring_size);
+}
+
 static int
 eth_dev_close(struct rte_eth_dev *dev)
 {
 	struct pmd_internals *internals;
-	struct tpacket_req *req;
 	unsigned int q;
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
@@ -454,10 +667,8 @@ eth_dev_close(struct rte_eth_dev *dev)
 		rte_socket_id());
 
 	internals = dev->data->dev_private;
-	req = &internals->req;
 	for (q = 0; q < internals->nb_queues; q++) {
-		munmap(internals->rx_queue[q].map,
-			2 * req->tp_block_size * req->tp_block_nr);
+		eth_af_packet_unmap(internals, q);
 		rte_free(internals->rx_queue[q].rd);
 		rte_free(internals->tx_queue[q].rd);
 	}
@@ -504,6 +715,12 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 		return -ENOMEM;
 	}
 
+	if (rte_pktmbuf_rearm_template_init(&pkt_q->mbuf_initializer, mb_pool,
+			dev->data->port_id) != 0) {
+		PMD_LOG(ERR, "%s: invalid mbuf pool", dev->device->name);
+		return -EINVAL;
+	}
+
 	dev->data->rx_queues[rx_queue_id] = pkt_q;
 	pkt_q->in_port = dev->data->port_id;
 	pkt_q->vlan_strip = internals->vlan_strip;
@@ -667,6 +884,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
                        unsigned int framesize,
                        unsigned int framecnt,
 		       unsigned int qdisc_bypass,
+		       unsigned int tpacket_v3,
+		       unsigned int block_tov,
                        struct pmd_internals **internals,
                        struct rte_eth_dev **eth_dev,
                        struct rte_kvargs *kvlist)
@@ -680,11 +899,14 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	unsigned k_idx;
 	struct sockaddr_ll sockaddr;
 	struct tpacket_req *req;
+	struct tpacket_req3 req3;
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
 	int rc, tpver, discard;
 	int qsockfd = -1;
+	int qtxsockfd = -1;
 	unsigned int i, q, rdsize;
+	size_t ring_size;
 #if defined(PACKET_FANOUT)
 	int fanout_arg;
 #endif
@@ -736,6 +958,17 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	req->tp_block_nr = blockcnt;
 	req->tp_frame_size = framesize;
 	req->tp_frame_nr = framecnt;
+	ring_size = (size_t)blocksize * blockcnt;
+
+	(*internals)->tpacket_v3 = tpacket_v3;
+	if (tpacket_v3) {
+		memset(&req3, 0, sizeof(req3));
+		req3.tp_block_size = blocksize;
+		req3.tp_block_nr = blockcnt;
+		req3.tp_frame_size = framesize;
+		req3.tp_frame_nr = framecnt;
+		req3.tp_retire_blk_tov = block_tov;
+	}
 
 	ifnamelen = strlen(pair->value);
 	if (ifnamelen < sizeof(ifr.ifr_name)) {
@@ -777,6 +1010,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 
 	for (q = 0; q < nb_queues; q++) {
 		/* Open an AF_PACKET socket for this queue... */
+		qtxsockfd = -1;
 		qsockfd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
 		if (qsockfd == -1) {
 			PMD_LOG_ERRNO(ERR,
@@ -785,8 +1019,34 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
+		/*
+		 * The TPACKET_V3 ring is Rx only, the Tx ring keeps the
+		 * TPACKET_V2 frames on a second socket, which receives nothing.
+		 */
+		if (tpacket_v3) {
+			qtxsockfd = socket(AF_PACKET, SOCK_RAW, 0);
+			if (qtxsockfd == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not open AF_PACKET Tx socket",
+					name);
+				goto error;
+			}
+
+			tpver = TPACKET_V3;
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
+					&tpver, sizeof(tpver));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not set PACKET_VERSION on AF_PACKET socket for %s",
+					name, pair->value);
+				goto error;
+			}
+		} else {
+			qtxsockfd = qsockfd;
+		}
+
 		tpver = TPACKET_V2;
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
+		rc = setsockopt(qtxsockfd, SOL_PACKET, PACKET_VERSION,
 				&tpver, sizeof(tpver));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
@@ -796,7 +1056,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		}
 
 		discard = 1;
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_LOSS,
+		rc = setsockopt(qtxsockfd, SOL_PACKET, PACKET_LOSS,
 				&discard, sizeof(discard));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
@@ -807,7 +1067,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 
 		if (qdisc_bypass) {
 #if defined(PACKET_QDISC_BYPASS)
-			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
+			rc = setsockopt(qtxsockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
 					&qdisc_bypass, sizeof(qdisc_bypass));
 			if (rc == -1) {
 				PMD_LOG_ERRNO(ERR,
@@ -818,7 +1078,12 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 #endif
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, sizeof(*req));
+		if (tpacket_v3)
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					&req3, sizeof(req3));
+		else
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					req, sizeof(*req));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
@@ -826,7 +1091,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
+		rc = setsockopt(qtxsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_TX_RING on AF_PACKET "
@@ -836,8 +1101,9 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 
 		rx_queue = &((*internals)->rx_queue[q]);
 		rx_queue->framecount = req->tp_frame_nr;
+		rx_queue->blockcount = req->tp_block_nr;
 
-		rx_queue->map = mmap(NULL, 2 * req->tp_block_size * req->tp_block_nr,
+		rx_queue->map = mmap(NULL, tpacket_v3 ? ring_size : 2 * ring_size,
 				    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
 				    qsockfd, 0);
 		if (rx_queue->map == MAP_FAILED) {
@@ -853,9 +1119,16 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (rx_queue->rd == NULL)
 			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
-			rx_queue->rd[i].iov_len = req->tp_frame_size;
+		if (tpacket_v3) {
+			for (i = 0; i < req->tp_block_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map + (i * blocksize);
+				rx_queue->rd[i].iov_len = req->tp_block_size;
+			}
+		} else {
+			for (i = 0; i < req->tp_frame_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
+				rx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
 		}
 		rx_queue->sockfd = qsockfd;
 
@@ -865,7 +1138,20 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		tx_queue->frame_data_size -= TPACKET2_HDRLEN -
 			sizeof(struct sockaddr_ll);
 
-		tx_queue->map = rx_queue->map + req->tp_block_size * req->tp_block_nr;
+		if (tpacket_v3) {
+			tx_queue->map = mmap(NULL, ring_size,
+					     PROT_READ | PROT_WRITE,
+					     MAP_SHARED | MAP_LOCKED,
+					     qtxsockfd, 0);
+			if (tx_queue->map == MAP_FAILED) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: call to mmap failed on AF_PACKET Tx socket for %s",
+					name, pair->value);
+				goto error;
+			}
+		} else {
+			tx_queue->map = rx_queue->map + ring_size;
+		}
 
 		tx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (tx_queue->rd == NULL)
@@ -874,7 +1160,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			tx_queue->rd[i].iov_base = tx_queue->map + (i * framesize);
 			tx_queue->rd[i].iov_len = req->tp_frame_size;
 		}
-		tx_queue->sockfd = qsockfd;
+		tx_queue->sockfd = qtxsockfd;
 
 		rc = bind(qsockfd, (const struct sockaddr*)&sockaddr, sizeof(sockaddr));
 		if (rc == -1) {
@@ -884,6 +1170,20 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
+		if (qtxsockfd != qsockfd) {
+			/* Bound to no protocol, the Tx socket receives nothing */
+			sockaddr.sll_protocol = 0;
+			rc = bind(qtxsockfd, (const struct sockaddr *)&sockaddr,
+				  sizeof(sockaddr));
+			sockaddr.sll_protocol = htons(ETH_P_ALL);
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not bind AF_PACKET Tx socket to %s",
+					name, pair->value);
+				goto error;
+			}
+		}
+
 #if defined(PACKET_FANOUT)
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_FANOUT,
 				&fanout_arg, sizeof(fanout_arg));
@@ -926,16 +1226,21 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 error:
 	if (qsockfd != -1)
 		close(qsockfd);
+	if (qtxsockfd != -1 && qtxsockfd != qsockfd)
+		close(qtxsockfd);
 	for (q = 0; q < nb_queues; q++) {
-		if ((*internals)->rx_queue[q].map != MAP_FAILED)
-			munmap((*internals)->rx_queue[q].map,
-			       2 * req->tp_block_size * req->tp_block_nr);
+		eth_af_packet_unmap(*internals, q);
 
 		rte_free((*internals)->rx_queue[q].rd);
 		rte_free((*internals)->tx_queue[q].rd);
 		if (((*internals)->rx_queue[q].sockfd >= 0) &&
 			((*internals)->rx_queue[q].sockfd != qsockfd))
 			close((*internals)->rx_queue[q].sockfd);
+		if (((*internals)->tx_queue[q].sockfd >= 0) &&
+			((*internals)->tx_queue[q].sockfd !=
+			 (*internals)->rx_queue[q].sockfd) &&
+			((*internals)->tx_queue[q].sockfd != qtxsockfd))
+			close((*internals)->tx_queue[q].sockfd);
 	}
 free_internals:
 	rte_free((*internals)->rx_queue);
@@ -956,18 +1261,20 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	struct rte_kvargs_pair *pair = NULL;
 	unsigned k_idx;
 	unsigned int blockcount;
-	unsigned int blocksize;
+	unsigned int blocksize = 0;
 	unsigned int framesize = DFLT_FRAME_SIZE;
 	unsigned int framecount = DFLT_FRAME_COUNT;
 	unsigned int qpairs = 1;
 	unsigned int qdisc_bypass = 1;
+	unsigned int tpacket_v3 = 0;
+	unsigned int block_tov = DFLT_BLOCK_TOV;
+	unsigned long val;
+	char *end;
 
 	/* do some parameter checking */
 	if (*sockfd < 0)
 		return -1;
 
-	blocksize = getpagesize();
-
 	/*
 	 * Walk arguments for configurable settings
 	 */
@@ -1023,8 +1330,35 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		if (strstr(pair->key, ETH_AF_PACKET_TPACKET_V3_ARG) != NULL) {
+			tpacket_v3 = atoi(pair->value);
+			if (tpacket_v3 > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid tpacket_v3 value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_BLOCK_TOV_ARG) != NULL) {
+			errno = 0;
+			val = strtoul(pair->value, &end, 10);
+			if (errno != 0 || end == pair->value || *end != '\0' ||
+			    val > UINT_MAX) {
+				PMD_LOG(ERR,
+					"%s: invalid blocktov value",
+					name);
+				return -1;
+			}
+			block_tov = val;
+			continue;
+		}
 	}
 
+	/* TPACKET_V3 packs the packets in blocks, better larger than a page */
+	if (!blocksize)
+		blocksize = tpacket_v3 ? DFLT_V3_BLOCK_SIZE : getpagesize();
+
 	if (framesize > blocksize) {
 		PMD_LOG(ERR,
 			"%s: AF_PACKET MMAP frame size exceeds block size!",
@@ -1044,16 +1378,22 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	PMD_LOG(INFO, "%s:\tblock count %d", name, blockcount);
 	PMD_LOG(INFO, "%s:\tframe size %d", name, framesize);
 	PMD_LOG(INFO, "%s:\tframe count %d", name, framecount);
+	if (tpacket_v3)
+		PMD_LOG(INFO, "%s:\tTPACKET_V3 block timeout %u ms",
+			name, block_tov);
 
 	if (rte_pmd_init_internals(dev, *sockfd, qpairs,
 				   blocksize, blockcount,
 				   framesize, framecount,
-				   qdisc_bypass,
+				   qdisc_bypass, tpacket_v3, block_tov,
 				   &internals, &eth_dev,
 				   kvlist) < 0)
 		return -1;
 
-	eth_dev->rx_pkt_burst = eth_af_packet_rx;
+	if (tpacket_v3)
+		eth_dev->rx_pkt_burst = eth_af_packet_rx_v3;
+	else
+		eth_dev->rx_pkt_burst = eth_af_packet_rx;
 	eth_dev->tx_pkt_burst = eth_af_packet_tx;
 
 	rte_eth_dev_probing_finish(eth_dev);
@@ -1145,4 +1485,6 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_packet,
 	"blocksz=<int> "
 	"framesz=<int> "
 	"framecnt=<int> "
-	"qdisc_bypass=<0|1>");
+	"qdisc_bypass=<0|1> "
+	"tpacket_v3=<0|1> "
+	"blocktov=<int>");
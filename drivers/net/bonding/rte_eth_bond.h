@@ -91,6 +91,8 @@ extern "C" {
 /**< Layer 2+3 (Ethernet MAC + IP Addresses) transmit load balancing */
 #define BALANCE_XMIT_POLICY_LAYER34		(2)
 /**< Layer 3+4 (IP Addresses + UDP Ports) transmit load balancing */
+#define BALANCE_XMIT_POLICY_RSS			(3)
+/**< Rx RSS hash of the mbufs, or Layer 3+4 when not set, transmit load balancing */
 
 /**
  * Create a bonding rte_eth_dev device
@@ -995,6 +995,10 @@ rte_eth_bond_xmit_policy_set(uint16_t bonding_port_id, uint8_t policy)
 		internals->balance_xmit_policy = policy;
 		internals->burst_xmit_hash = burst_xmit_l34_hash;
 		break;
+	case BALANCE_XMIT_POLICY_RSS:
+		internals->balance_xmit_policy = policy;
+		internals->burst_xmit_hash = burst_xmit_rss_hash;
+		break;
 
 	default:
 		return -1;
@@ -756,77 +756,99 @@ burst_xmit_l23_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
 	}
 }
 
-void
-burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
-		uint16_t member_count, uint16_t *members)
+static inline uint32_t
+l34_hash(struct rte_mbuf *buf)
 {
 	struct rte_ether_hdr *eth_hdr;
 	uint16_t proto;
 	size_t vlan_offset;
-	int i;
 
 	struct rte_udp_hdr *udp_hdr;
 	struct rte_tcp_hdr *tcp_hdr;
 	uint32_t hash, l3hash, l4hash;
 
-	for (i = 0; i < nb_pkts; i++) {
-		eth_hdr = rte_pktmbuf_mtod(buf[i], struct rte_ether_hdr *);
-		size_t pkt_end = (size_t)eth_hdr + rte_pktmbuf_data_len(buf[i]);
-		proto = eth_hdr->ether_type;
-		vlan_offset = get_vlan_offset(eth_hdr, &proto);
-		l3hash = 0;
-		l4hash = 0;
+	eth_hdr = rte_pktmbuf_mtod(buf, struct rte_ether_hdr *);
+	size_t pkt_end = (size_t)eth_hdr + rte_pktmbuf_data_len(buf);
+	proto = eth_hdr->ether_type;
+	vlan_offset = get_vlan_offset(eth_hdr, &proto);
+	l3hash = 0;
+	l4hash = 0;
+
+	if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) == proto) {
+		struct rte_ipv4_hdr *ipv4_hdr = (struct rte_ipv4_hdr *)
+				((char *)(eth_hdr + 1) + vlan_offset);
+		size_t ip_hdr_offset;
+
+		l3hash = ipv4_hash(ipv4_hdr);
+
+		/* there is no L4 header in fragmented packet */
+		if (likely(rte_ipv4_frag_pkt_is_fragmented(ipv4_hdr) == 0)) {
+			ip_hdr_offset = (ipv4_hdr->version_ihl
+				& RTE_IPV4_HDR_IHL_MASK) *
+				RTE_IPV4_IHL_MULTIPLIER;
+
+			if (ipv4_hdr->next_proto_id == IPPROTO_TCP) {
+				tcp_hdr = (struct rte_tcp_hdr *)
+					((char *)ipv4_hdr + ip_hdr_offset);
+				if ((size_t)tcp_hdr + sizeof(*tcp_hdr)
+						<= pkt_end)
+					l4hash = HASH_L4_PORTS(tcp_hdr);
+			} else if (ipv4_hdr->next_proto_id == IPPROTO_UDP) {
+				udp_hdr = (struct rte_udp_hdr *)
+					((char *)ipv4_hdr + ip_hdr_offset);
+				if ((size_t)udp_hdr + sizeof(*udp_hdr)
+						< pkt_end)
+					l4hash = HASH_L4_PORTS(udp_hdr);
+			}
+		}
+	} else if  (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) == proto) {
+		struct rte_ipv6_hdr *ipv6_hdr = (struct rte_ipv6_hdr *)
+				((char *)(eth_hdr + 1) + vlan_offset);
+		l3hash = ipv6_hash(ipv6_hdr);
+
+		if (ipv6_hdr->proto == IPPROTO_TCP) {
+			tcp_hdr = (struct rte_tcp_hdr *)(ipv6_hdr + 1);
+			l4hash = HASH_L4_PORTS(tcp_hdr);
+		} else if (ipv6_hdr->proto == IPPROTO_UDP) {
+			udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
+			l4hash = HASH_L4_PORTS(udp_hdr);
+		}
+	}
 
-		if (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) == proto) {
-			struct rte_ipv4_hdr *ipv4_hdr = (struct rte_ipv4_hdr *)
-					((char *)(eth_hdr + 1) + vlan_offset);
-			size_t ip_hdr_offset;
+	hash = l3hash ^ l4hash;
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
 
-			l3hash = ipv4_hash(ipv4_hdr);
+	return hash;
+}
 
-			/* there is no L4 header in fragmented packet */
-			if (likely(rte_ipv4_frag_pkt_is_fragmented(ipv4_hdr)
-								== 0)) {
-				ip_hdr_offset = (ipv4_hdr->version_ihl
-					& RTE_IPV4_HDR_IHL_MASK) *
-					RTE_IPV4_IHL_MULTIPLIER;
-
-				if (ipv4_hdr->next_proto_id == IPPROTO_TCP) {
-					tcp_hdr = (struct rte_tcp_hdr *)
-						((char *)ipv4_hdr +
-							ip_hdr_offset);
-					if ((size_t)tcp_hdr + sizeof(*tcp_hdr)
-							<= pkt_end)
-						l4hash = HASH_L4_PORTS(tcp_hdr);
-				} else if (ipv4_hdr->next_proto_id ==
-								IPPROTO_UDP) {
-					udp_hdr = (struct rte_udp_hdr *)
-						((char *)ipv4_hdr +
-							ip_hdr_offset);
-					if ((size_t)udp_hdr + sizeof(*udp_hdr)
-							< pkt_end)
-						l4hash = HASH_L4_PORTS(udp_hdr);
-				}
-			}
-		} else if  (rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) == proto) {
-			struct rte_ipv6_hdr *ipv6_hdr = (struct rte_ipv6_hdr *)
-					((char *)(eth_hdr + 1) + vlan_offset);
-			l3hash = ipv6_hash(ipv6_hdr);
+void
+burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t member_count, uint16_t *members)
+{
+	int i;
 
-			if (ipv6_hdr->proto == IPPROTO_TCP) {
-				tcp_hdr = (struct rte_tcp_hdr *)(ipv6_hdr + 1);
-				l4hash = HASH_L4_PORTS(tcp_hdr);
-			} else if (ipv6_hdr->proto == IPPROTO_UDP) {
-				udp_hdr = (struct rte_udp_hdr *)(ipv6_hdr + 1);
-				l4hash = HASH_L4_PORTS(udp_hdr);
-			}
-		}
+	for (i = 0; i < nb_pkts; i++)
+		members[i] = l34_hash(buf[i]) % member_count;
+}
 
-		hash = l3hash ^ l4hash;
-		hash ^= hash >> 16;
-		hash ^= hash >> 8;
+void
+burst_xmit_rss_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
+		uint16_t member_count, uint16_t *members)
+{
+	int i;
 
-		members[i] = hash % member_count;
+	for (i = 0; i < nb_pkts; i++) {
+		/*
+		 * The low bits of the RSS hash selected the Rx queue through
+		 * the RETA, so all the packets polled from a same queue share
+		 * them: map the hash onto the members with its high bits.
+		 */
+		if (buf[i]->ol_flags & RTE_MBUF_F_RX_RSS_HASH)
+			members[i] = ((uint64_t)buf[i]->hash.rss *
+					member_count) >> 32;
+		else
+			members[i] = l34_hash(buf[i]) % member_count;
 	}
 }
 
@@ -3396,6 +3418,9 @@ dump_basic(const struct rte_eth_dev *dev, FILE *f)
 		case BALANCE_XMIT_POLICY_LAYER34:
 			fprintf(f, "BALANCE_XMIT_POLICY_LAYER34");
 			break;
+		case BALANCE_XMIT_POLICY_RSS:
+			fprintf(f, "BALANCE_XMIT_POLICY_RSS");
+			break;
 		default:
 			fprintf(f, "Unknown");
 		}
@@ -4251,7 +4276,7 @@ RTE_PMD_REGISTER_PARAM_STRING(net_bonding,
 	"member=<ifc> "
 	"primary=<ifc> "
 	"mode=[0-6] "
-	"xmit_policy=[l2 | l23 | l34] "
+	"xmit_policy=[l2 | l23 | l34 | rss] "
 	"agg_mode=[count | stable | bandwidth] "
 	"socket_id=<int> "
 	"mac=<mac addr> "
@@ -349,7 +349,8 @@ eth_memif_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	if (likely(mbuf_size >= pmd->cfg.pkt_buffer_size)) {
 		struct rte_mbuf *mbufs[MAX_PKT_BURST];
 next_bulk:
-		ret = rte_pktmbuf_alloc_bulk(mq->mempool, mbufs, MAX_PKT_BURST);
+		ret = rte_pktmbuf_alloc_bulk_rearm(mq->mempool, mbufs,
+				MAX_PKT_BURST, &mq->mbuf_initializer);
 		if (unlikely(ret < 0))
 			goto no_free_bufs;
 
@@ -599,7 +600,8 @@ eth_memif_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	if (n_slots < 32)
 		goto no_free_mbufs;
 
-	ret = rte_pktmbuf_alloc_bulk(mq->mempool, &mq->buffers[head & mask], n_slots);
+	ret = rte_pktmbuf_alloc_bulk_rearm(mq->mempool, &mq->buffers[head & mask],
+			n_slots, &mq->mbuf_initializer);
 	if (unlikely(ret < 0))
 		goto no_free_mbufs;
 
@@ -1492,6 +1494,7 @@ memif_rx_queue_setup(struct rte_eth_dev *dev,
 {
 	struct pmd_internals *pmd = dev->data->dev_private;
 	struct memif_queue *mq;
+	int ret;
 
 	mq = rte_zmalloc("rx-queue", sizeof(struct memif_queue), 0);
 	if (mq == NULL) {
@@ -1503,24 +1506,36 @@ memif_rx_queue_setup(struct rte_eth_dev *dev,
 	mq->intr_handle = rte_intr_instance_alloc(RTE_INTR_INSTANCE_F_SHARED);
 	if (mq->intr_handle == NULL) {
 		MIF_LOG(ERR, "Failed to allocate intr handle");
-		return -ENOMEM;
+		ret = -ENOMEM;
+		goto error;
 	}
 
 	mq->type = (pmd->role == MEMIF_ROLE_CLIENT) ? MEMIF_RING_S2C : MEMIF_RING_C2S;
 	mq->n_pkts = 0;
 	mq->n_bytes = 0;
 
-	if (rte_intr_fd_set(mq->intr_handle, -1))
-		return -rte_errno;
-
-	if (rte_intr_type_set(mq->intr_handle, RTE_INTR_HANDLE_EXT))
-		return -rte_errno;
+	if (rte_intr_fd_set(mq->intr_handle, -1) ||
+	    rte_intr_type_set(mq->intr_handle, RTE_INTR_HANDLE_EXT)) {
+		ret = -rte_errno;
+		goto error;
+	}
 
 	mq->mempool = mb_pool;
 	mq->in_port = dev->data->port_id;
+	ret = rte_pktmbuf_rearm_template_init(&mq->mbuf_initializer, mb_pool,
+			mq->in_port);
+	if (ret < 0) {
+		MIF_LOG(ERR, "Invalid mempool for rx queue id: %u", qid);
+		goto error;
+	}
 	dev->data->rx_queues[qid] = mq;
 
 	return 0;
+
+error:
+	rte_intr_instance_free(mq->intr_handle);
+	rte_free(mq);
+	return ret;
 }
 
 static void
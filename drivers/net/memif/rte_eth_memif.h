@@ -48,6 +48,8 @@ struct memif_region {
 
 struct memif_queue {
 	struct rte_mempool *mempool;		/**< mempool for RX packets */
+	struct rte_mbuf_rearm_template mbuf_initializer;
+	/**< values of the RX mbufs fields on allocation */
 	struct pmd_internals *pmd;		/**< device internals */
 
 	memif_ring_type_t type;			/**< ring type */
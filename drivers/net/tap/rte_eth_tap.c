@@ -56,6 +56,9 @@
 #define ETH_TAP_MAC_ARG         "mac"
 #define ETH_TAP_MAC_FIXED       "fixed"
 #define ETH_TAP_PERSIST_ARG     "persist"
+#define ETH_TAP_VNET_HDR_ARG    "vnet_hdr"
+#define ETH_TAP_IO_URING_ARG    "io_uring"
+#define ETH_TAP_IO_URING_SQPOLL "sqpoll"
 
 #define ETH_TAP_USR_MAC_FMT     "xx:xx:xx:xx:xx:xx"
 #define ETH_TAP_CMP_MAC_FMT     "0123456789ABCDEFabcdef"
@@ -73,6 +76,12 @@
 
 #define TAP_IOV_DEFAULT_MAX 1024
 
+/* Most segments of a packet written through io_uring */
+#define TAP_URING_TX_MAX_SEGS 64
+
+/* Largest frame coalesced by the kernel GRO, without the virtio-net header */
+#define TAP_VNET_HDR_MAX_LRO_PKT_SIZE 65536
+
 #define TAP_RX_OFFLOAD (RTE_ETH_RX_OFFLOAD_SCATTER |	\
 			RTE_ETH_RX_OFFLOAD_IPV4_CKSUM |	\
 			RTE_ETH_RX_OFFLOAD_UDP_CKSUM |	\
@@ -95,6 +104,8 @@ static const char *valid_arguments[] = {
 	ETH_TAP_REMOTE_ARG,
 	ETH_TAP_MAC_ARG,
 	ETH_TAP_PERSIST_ARG,
+	ETH_TAP_VNET_HDR_ARG,
+	ETH_TAP_IO_URING_ARG,
 	NULL
 };
 
@@ -166,6 +177,12 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive, int persistent)
 	 */
 	ifr.ifr_flags = (pmd->type == ETH_TUNTAP_TYPE_TAP) ?
 		IFF_TAP : IFF_TUN | IFF_POINTOPOINT;
+	/*
+	 * A virtio-net header follows the packet information header to
+	 * exchange checksum and segmentation offloads with the kernel.
+	 */
+	if (pmd->vnet_hdr)
+		ifr.ifr_flags |= IFF_VNET_HDR;
 	strlcpy(ifr.ifr_name, pmd->name, IFNAMSIZ);
 
 	fd = open(TUN_TAP_DEV_PATH, O_RDWR);
@@ -200,6 +217,17 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive, int persistent)
 		goto error;
 	}
 
+	if (pmd->vnet_hdr) {
+		int hdr_sz = sizeof(struct virtio_net_hdr);
+
+		if (ioctl(fd, TUNSETVNETHDRSZ, &hdr_sz) < 0) {
+			TAP_LOG(WARNING,
+				"Unable to set vnet header size for %s: %s",
+				ifr.ifr_name, strerror(errno));
+			goto error;
+		}
+	}
+
 	/* Keep the device after application exit */
 	if (persistent && ioctl(fd, TUNSETPERSIST, 1) < 0) {
 		TAP_LOG(WARNING,
@@ -378,6 +406,9 @@ tap_verify_csum(struct rte_mbuf *mbuf)
 	if (l4 == RTE_PTYPE_L4_UDP || l4 == RTE_PTYPE_L4_TCP) {
 		int cksum_ok;
 
+		/* L4 checksum status already given in the vnet header */
+		if (mbuf->ol_flags & RTE_MBUF_F_RX_L4_CKSUM_MASK)
+			return;
 		l4_hdr = rte_pktmbuf_mtod_offset(mbuf, void *, l2_len + l3_len);
 		/* Don't verify checksum for multi-segment packets. */
 		if (mbuf->nb_segs > 1)
@@ -406,6 +437,27 @@ tap_verify_csum(struct rte_mbuf *mbuf)
 	}
 }
 
+/* Report the offloads given by the kernel in the virtio-net header */
+static void
+tap_rx_vnet_hdr(struct rte_mbuf *mbuf, const struct virtio_net_hdr *vh)
+{
+	/*
+	 * Packets from the local host stack are not checksummed: the data
+	 * is valid but the L4 checksum field only holds the pseudo-header
+	 * checksum.
+	 */
+	if (vh->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM)
+		mbuf->ol_flags |= RTE_MBUF_F_RX_L4_CKSUM_NONE;
+	else if (vh->flags & VIRTIO_NET_HDR_F_DATA_VALID)
+		mbuf->ol_flags |= RTE_MBUF_F_RX_L4_CKSUM_GOOD;
+
+	/* Super-frame coalesced by GRO or not yet segmented by TSO */
+	if (vh->gso_type != VIRTIO_NET_HDR_GSO_NONE) {
+		mbuf->ol_flags |= RTE_MBUF_F_RX_LRO;
+		mbuf->tso_segsz = vh->gso_size;
+	}
+}
+
 static void
 tap_rxq_pool_free(struct rte_mbuf *pool)
 {
@@ -450,16 +502,16 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			*rxq->iovecs,
 			1 + (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_SCATTER ?
 			     rxq->nb_rx_desc : 1));
-		if (len < (int)sizeof(struct tun_pi))
+		if (len < (int)(*rxq->iovecs)[0].iov_len)
 			break;
 
 		/* Packet couldn't fit in the provided mbuf */
-		if (unlikely(rxq->pi.flags & TUN_PKT_STRIP)) {
+		if (unlikely(rxq->hdr.pi.flags & TUN_PKT_STRIP)) {
 			rxq->stats.ierrors++;
 			continue;
 		}
 
-		len -= sizeof(struct tun_pi);
+		len -= (*rxq->iovecs)[0].iov_len;
 
 		mbuf->pkt_len = len;
 		mbuf->port = rxq->in_port;
@@ -485,7 +537,7 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			new_tail = buf;
 			new_tail->next = seg->next;
 
-			/* iovecs[0] is reserved for packet info (pi) */
+			/* iovecs[0] is reserved for packet headers (hdr) */
 			(*rxq->iovecs)[mbuf->nb_segs].iov_len =
 				buf->buf_len - data_off;
 			(*rxq->iovecs)[mbuf->nb_segs].iov_base =
@@ -504,6 +556,8 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		seg->next = NULL;
 		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
 						      RTE_PTYPE_ALL_MASK);
+		if (rxq->vnet_hdr)
+			tap_rx_vnet_hdr(mbuf, &rxq->hdr.vnet_hdr);
 		if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_CHECKSUM)
 			tap_verify_csum(mbuf);
 
@@ -521,6 +575,201 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/* Callback to handle the rx burst of packets read through io_uring, a
+ * packet per mbuf. The reads are queued in a burst once the Rx trigger
+ * changed, and their mbufs are returned by a later call if not completed.
+ */
+static uint16_t
+pmd_rx_burst_uring(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct rx_queue *rxq = queue;
+	struct pmd_process_private *process_private;
+	struct tap_uring *uring;
+	unsigned int hdr_len = (*rxq->iovecs)[0].iov_len;
+	unsigned long num_rx_bytes = 0;
+	uint32_t trigger = tap_trigger;
+	int drained = 0;
+	uint16_t num_rx = 0;
+	uint16_t n;
+	uint16_t i;
+	int res[nb_pkts];
+
+	process_private = rte_eth_devices[rxq->in_port].process_private;
+	uring = process_private->rxq_urings[rxq->queue_id];
+
+	if (trigger != rxq->trigger_seen && tap_uring_inflight(uring) == 0) {
+		if (tap_uring_read_burst(uring, rxq->mp, nb_pkts,
+					 hdr_len) == 0) {
+			rxq->stats.rx_nombuf++;
+			return 0;
+		}
+		rxq->trigger_read = trigger;
+		tap_uring_submit(uring);
+	}
+
+	n = tap_uring_complete(uring, bufs, res, nb_pkts);
+	for (i = 0; i < n; i++) {
+		struct rte_mbuf *mbuf = bufs[i];
+		struct tap_pkt_hdr *hdr;
+
+		/* -EAGAIN: no more packet in the queue */
+		if (res[i] < (int)hdr_len) {
+			drained = 1;
+			tap_uring_recycle(uring, mbuf);
+			continue;
+		}
+
+		/* Packet couldn't fit in the mbuf */
+		hdr = rte_pktmbuf_mtod_offset(mbuf, struct tap_pkt_hdr *,
+					      -(int)hdr_len);
+		if (unlikely(hdr->pi.flags & TUN_PKT_STRIP)) {
+			rxq->stats.ierrors++;
+			tap_uring_recycle(uring, mbuf);
+			continue;
+		}
+
+		mbuf->pkt_len = res[i] - hdr_len;
+		mbuf->data_len = mbuf->pkt_len;
+		mbuf->port = rxq->in_port;
+		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
+						      RTE_PTYPE_ALL_MASK);
+		if (rxq->vnet_hdr)
+			tap_rx_vnet_hdr(mbuf, &hdr->vnet_hdr);
+		if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_CHECKSUM)
+			tap_verify_csum(mbuf);
+
+		/* account for the receive frame */
+		bufs[num_rx++] = mbuf;
+		num_rx_bytes += mbuf->pkt_len;
+	}
+	rxq->stats.ipackets += num_rx;
+	rxq->stats.ibytes += num_rx_bytes;
+
+	if (rxq->trigger_read && drained)
+		rxq->trigger_seen = rxq->trigger_read;
+
+	return num_rx;
+}
+
+/*
+ * Leave the L4 checksum and the TCP segmentation of a packet to the kernel
+ * through its virtio-net header. As for a NIC, the L4 checksum field must
+ * hold the pseudo-header checksum, and the kernel also expects the length
+ * fields of the IP header to cover the whole packet to segment. The headers
+ * are copied in a new segment before being changed, the mbuf may be indirect.
+ */
+static int
+tap_tx_vnet_hdr(struct rte_mbuf **pmbuf, struct virtio_net_hdr *vh)
+{
+	struct rte_mbuf *mbuf = *pmbuf;
+	uint64_t ol_flags = mbuf->ol_flags;
+	uint64_t l4_ol_flags = ol_flags & RTE_MBUF_F_TX_L4_MASK;
+	unsigned int l4_off = mbuf->l2_len + mbuf->l3_len;
+	unsigned int hdrlens = l4_off;
+	struct rte_mbuf *seg;
+	uint16_t *l4_cksum;
+	uint16_t phdr_cksum;
+	void *l3_hdr;
+
+	if (ol_flags & RTE_MBUF_F_TX_TCP_SEG)
+		hdrlens += mbuf->l4_len;
+	else if (l4_ol_flags == RTE_MBUF_F_TX_UDP_CKSUM)
+		hdrlens += sizeof(struct rte_udp_hdr);
+	else if (l4_ol_flags == RTE_MBUF_F_TX_TCP_CKSUM)
+		hdrlens += sizeof(struct rte_tcp_hdr);
+	else if (l4_ol_flags != RTE_MBUF_F_TX_L4_NO_CKSUM)
+		return -1;
+
+	/* Support only packets with at least layer 4
+	 * header included in the first segment
+	 */
+	if (rte_pktmbuf_data_len(mbuf) < hdrlens)
+		return -1;
+
+	seg = rte_pktmbuf_copy(mbuf, mbuf->pool, 0, hdrlens);
+	if (seg == NULL)
+		return -1;
+	rte_pktmbuf_adj(mbuf, hdrlens);
+	rte_pktmbuf_chain(seg, mbuf);
+	*pmbuf = mbuf = seg;
+
+	l3_hdr = rte_pktmbuf_mtod_offset(mbuf, void *, mbuf->l2_len);
+	if (ol_flags & RTE_MBUF_F_TX_IPV4) {
+		struct rte_ipv4_hdr *iph = l3_hdr;
+
+		if (ol_flags & RTE_MBUF_F_TX_TCP_SEG)
+			iph->total_length = rte_cpu_to_be_16(
+				rte_pktmbuf_pkt_len(mbuf) - mbuf->l2_len);
+		if (ol_flags & (RTE_MBUF_F_TX_IP_CKSUM |
+				RTE_MBUF_F_TX_TCP_SEG)) {
+			iph->hdr_checksum = 0;
+			iph->hdr_checksum = rte_ipv4_cksum(iph);
+		}
+		phdr_cksum = rte_ipv4_phdr_cksum(iph, 0);
+	} else {
+		struct rte_ipv6_hdr *iph = l3_hdr;
+
+		if (ol_flags & RTE_MBUF_F_TX_TCP_SEG)
+			iph->payload_len = rte_cpu_to_be_16(
+				rte_pktmbuf_pkt_len(mbuf) - mbuf->l2_len -
+				sizeof(*iph));
+		phdr_cksum = rte_ipv6_phdr_cksum(iph, 0);
+	}
+
+	if (l4_ol_flags == RTE_MBUF_F_TX_UDP_CKSUM) {
+		struct rte_udp_hdr *udp_hdr;
+
+		udp_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_udp_hdr *,
+						  l4_off);
+		l4_cksum = &udp_hdr->dgram_cksum;
+		vh->csum_offset = offsetof(struct rte_udp_hdr, dgram_cksum);
+	} else if (l4_ol_flags == RTE_MBUF_F_TX_TCP_CKSUM) {
+		struct rte_tcp_hdr *tcp_hdr;
+
+		tcp_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_tcp_hdr *,
+						  l4_off);
+		l4_cksum = &tcp_hdr->cksum;
+		vh->csum_offset = offsetof(struct rte_tcp_hdr, cksum);
+	} else {
+		return 0;
+	}
+	*l4_cksum = phdr_cksum;
+	vh->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+	vh->csum_start = l4_off;
+
+	if (ol_flags & RTE_MBUF_F_TX_TCP_SEG) {
+		vh->gso_type = (ol_flags & RTE_MBUF_F_TX_IPV4) ?
+			VIRTIO_NET_HDR_GSO_TCPV4 : VIRTIO_NET_HDR_GSO_TCPV6;
+		vh->gso_size = mbuf->tso_segsz;
+		vh->hdr_len = hdrlens;
+	}
+
+	return 0;
+}
+
+/* Account for the packets written through io_uring and free them */
+static void
+tap_tx_complete_uring(struct tx_queue *txq, struct tap_uring *uring)
+{
+	struct rte_mbuf *mbufs[MAX_GSO_MBUFS];
+	int res[RTE_DIM(mbufs)];
+	unsigned int n;
+	unsigned int i;
+
+	do {
+		n = tap_uring_complete(uring, mbufs, res, RTE_DIM(mbufs));
+		for (i = 0; i < n; i++) {
+			if (res[i] < 0) {
+				txq->stats.errs++;
+				continue;
+			}
+			txq->stats.opackets++;
+			txq->stats.obytes += rte_pktmbuf_pkt_len(mbufs[i]);
+		}
+		rte_pktmbuf_free_bulk(mbufs, n);
+	} while (n == RTE_DIM(mbufs));
+}
+
 static inline int
 tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			struct rte_mbuf **pmbufs,
@@ -534,8 +783,9 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 	for (i = 0; i < num_mbufs; i++) {
 		struct rte_mbuf *mbuf = pmbufs[i];
 		struct iovec iovecs[mbuf->nb_segs + 2];
-		struct tun_pi pi = { .flags = 0, .proto = 0x00 };
+		struct tap_pkt_hdr hdr = { .pi = { .flags = 0, .proto = 0x00 } };
 		struct rte_mbuf *seg = mbuf;
+		struct tap_uring *uring;
 		uint64_t l4_ol_flags;
 		int proto;
 		int n;
@@ -555,7 +805,7 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			 */
 			char *buff_data = rte_pktmbuf_mtod(seg, void *);
 			proto = (*buff_data & 0xf0);
-			pi.proto = (proto == 0x40) ?
+			hdr.pi.proto = (proto == 0x40) ?
 				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
 				((proto == 0x60) ?
 					rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
@@ -563,12 +813,24 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 		}
 
 		k = 0;
-		iovecs[k].iov_base = &pi;
-		iovecs[k].iov_len = sizeof(pi);
+		iovecs[k].iov_base = &hdr;
+		iovecs[k].iov_len = sizeof(hdr.pi);
+		if (txq->vnet_hdr)
+			iovecs[k].iov_len += sizeof(hdr.vnet_hdr);
 		k++;
 
 		l4_ol_flags = mbuf->ol_flags & RTE_MBUF_F_TX_L4_MASK;
-		if (txq->csum && (mbuf->ol_flags & RTE_MBUF_F_TX_IP_CKSUM ||
+		if (txq->vnet_hdr) {
+			if (mbuf->ol_flags & (RTE_MBUF_F_TX_IP_CKSUM |
+					      RTE_MBUF_F_TX_TCP_SEG) ||
+			    l4_ol_flags == RTE_MBUF_F_TX_UDP_CKSUM ||
+			    l4_ol_flags == RTE_MBUF_F_TX_TCP_CKSUM) {
+				if (tap_tx_vnet_hdr(&pmbufs[i],
+						    &hdr.vnet_hdr) < 0)
+					return -1;
+				mbuf = seg = pmbufs[i];
+			}
+		} else if (txq->csum && (mbuf->ol_flags & RTE_MBUF_F_TX_IP_CKSUM ||
 				l4_ol_flags == RTE_MBUF_F_TX_UDP_CKSUM ||
 				l4_ol_flags == RTE_MBUF_F_TX_TCP_CKSUM)) {
 			unsigned int hdrlens = mbuf->l2_len + mbuf->l3_len;
@@ -642,6 +904,26 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			seg = seg->next;
 		}
 
+		/* queue the tx frame, accounted for on completion */
+		uring = process_private->txq_urings[txq->queue_id];
+		if (uring != NULL) {
+			n = tap_uring_writev(uring, iovecs, k, mbuf);
+			if (n == -ENOBUFS) {
+				/* All the requests are in flight, reap them */
+				tap_uring_submit(uring);
+				tap_tx_complete_uring(txq, uring);
+				n = tap_uring_writev(uring, iovecs, k, mbuf);
+			}
+			if (n == -EMSGSIZE) {
+				/* Too many segments, drop it rather than retry */
+				txq->stats.errs++;
+				continue;
+			}
+			if (n < 0)
+				return -1;
+			continue;
+		}
+
 		/* copy the tx frame data */
 		n = writev(process_private->txq_fds[txq->queue_id], iovecs, k);
 		if (n <= 0)
@@ -659,12 +941,20 @@ static uint16_t
 pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct tx_queue *txq = queue;
+	struct pmd_process_private *process_private;
+	struct tap_uring *uring;
 	uint16_t num_tx = 0;
 	uint16_t num_packets = 0;
 	unsigned long num_tx_bytes = 0;
 	uint32_t max_size;
 	int i;
 
+	process_private = rte_eth_devices[txq->out_port].process_private;
+	uring = process_private->txq_urings[txq->queue_id];
+	/* Free the packets written since the last burst */
+	if (uring != NULL)
+		tap_tx_complete_uring(txq, uring);
+
 	if (unlikely(nb_pkts == 0))
 		return 0;
 
@@ -696,6 +986,16 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 				txq->stats.errs++;
 				break;
 			}
+			if (txq->vnet_hdr) {
+				/* The kernel segments the packet itself */
+				if (unlikely(rte_pktmbuf_pkt_len(mbuf_in) -
+						mbuf_in->l2_len > UINT16_MAX))
+					break;
+				num_tso_mbufs = 0;
+				mbuf = &mbuf_in;
+				num_mbufs = 1;
+				goto write;
+			}
 			gso_ctx->gso_size = tso_segsz;
 			/* 'mbuf_in' packet to segment */
 			num_tso_mbufs = rte_gso_segment(mbuf_in,
@@ -728,6 +1028,7 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			num_mbufs = 1;
 		}
 
+write:
 		ret = tap_write_mbufs(txq, num_mbufs, mbuf,
 				&num_packets, &num_tx_bytes);
 		if (ret == -1) {
@@ -749,6 +1050,11 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		}
 	}
 
+	if (uring != NULL) {
+		tap_uring_submit(uring);
+		tap_tx_complete_uring(txq, uring);
+	}
+
 	txq->stats.opackets += num_packets;
 	txq->stats.errs += nb_pkts - num_tx;
 	txq->stats.obytes += num_tx_bytes;
@@ -982,6 +1288,27 @@ tap_dev_configure(struct rte_eth_dev *dev)
 		return -1;
 	}
 
+	if (pmd->vnet_hdr) {
+		uint64_t offloads = dev->data->dev_conf.rxmode.offloads;
+		unsigned long tun_offloads = 0;
+
+		/*
+		 * Let the kernel hand over its packets with a partial L4
+		 * checksum, and its super-frames without segmenting them.
+		 */
+		if (offloads & (RTE_ETH_RX_OFFLOAD_UDP_CKSUM |
+				RTE_ETH_RX_OFFLOAD_TCP_CKSUM |
+				RTE_ETH_RX_OFFLOAD_TCP_LRO))
+			tun_offloads |= TUN_F_CSUM;
+		if (offloads & RTE_ETH_RX_OFFLOAD_TCP_LRO)
+			tun_offloads |= TUN_F_TSO4 | TUN_F_TSO6;
+		if (ioctl(pmd->ka_fd, TUNSETOFFLOAD, tun_offloads) < 0) {
+			TAP_LOG(ERR, "%s: unable to set TUN offloads: %s",
+				pmd->name, strerror(errno));
+			return -1;
+		}
+	}
+
 	TAP_LOG(INFO, "%s: %s: TX configured queues number: %u",
 		dev->device->name, pmd->name, dev->data->nb_tx_queues);
 
@@ -1039,7 +1366,16 @@ tap_dev_info(struct rte_eth_dev *dev, struct rte_eth_dev_info *dev_info)
 	dev_info->speed_capa = tap_dev_speed_capa();
 	dev_info->rx_queue_offload_capa = TAP_RX_OFFLOAD;
 	dev_info->rx_offload_capa = dev_info->rx_queue_offload_capa;
+	/* Super-frames are not read in chained mbufs through io_uring */
+	if (internals->vnet_hdr && internals->io_uring == TAP_IO_URING_OFF) {
+		dev_info->rx_offload_capa |= RTE_ETH_RX_OFFLOAD_TCP_LRO;
+		dev_info->max_lro_pkt_size = TAP_VNET_HDR_MAX_LRO_PKT_SIZE;
+	}
 	dev_info->tx_queue_offload_capa = TAP_TX_OFFLOAD;
+	if (internals->io_uring != TAP_IO_URING_OFF) {
+		dev_info->tx_desc_lim.nb_seg_max = TAP_URING_TX_MAX_SEGS;
+		dev_info->tx_desc_lim.nb_mtu_seg_max = TAP_URING_TX_MAX_SEGS;
+	}
 	dev_info->tx_offload_capa = dev_info->tx_queue_offload_capa;
 	dev_info->hash_key_size = TAP_RSS_HASH_KEY_SIZE;
 	/*
@@ -1141,6 +1477,10 @@ tap_dev_close(struct rte_eth_dev *dev)
 	}
 
 	for (i = 0; i < RTE_PMD_TAP_MAX_QUEUES; i++) {
+		tap_uring_free(process_private->rxq_urings[i]);
+		process_private->rxq_urings[i] = NULL;
+		tap_uring_free(process_private->txq_urings[i]);
+		process_private->txq_urings[i] = NULL;
 		if (process_private->rxq_fds[i] != -1) {
 			rxq = &internals->rxq[i];
 			close(process_private->rxq_fds[i]);
@@ -1207,6 +1547,8 @@ tap_rx_queue_release(struct rte_eth_dev *dev, uint16_t qid)
 	if (!rxq)
 		return;
 	process_private = rte_eth_devices[rxq->in_port].process_private;
+	tap_uring_free(process_private->rxq_urings[rxq->queue_id]);
+	process_private->rxq_urings[rxq->queue_id] = NULL;
 	if (process_private->rxq_fds[rxq->queue_id] != -1) {
 		close(process_private->rxq_fds[rxq->queue_id]);
 		process_private->rxq_fds[rxq->queue_id] = -1;
@@ -1226,6 +1568,8 @@ tap_tx_queue_release(struct rte_eth_dev *dev, uint16_t qid)
 	if (!txq)
 		return;
 	process_private = rte_eth_devices[txq->out_port].process_private;
+	tap_uring_free(process_private->txq_urings[txq->queue_id]);
+	process_private->txq_urings[txq->queue_id] = NULL;
 
 	if (process_private->txq_fds[txq->queue_id] != -1) {
 		close(process_private->txq_fds[txq->queue_id]);
@@ -1532,7 +1876,10 @@ tap_setup_queue(struct rte_eth_dev *dev,
 
 	tx->mtu = &dev->data->mtu;
 	rx->rxmode = &dev->data->dev_conf.rxmode;
-	if (gso_ctx) {
+	rx->vnet_hdr = pmd->vnet_hdr;
+	tx->vnet_hdr = pmd->vnet_hdr;
+	/* The kernel segments the packets itself with a vnet header */
+	if (gso_ctx && !pmd->vnet_hdr) {
 		ret = tap_gso_ctx_setup(gso_ctx, dev);
 		if (ret)
 			return -1;
@@ -1577,6 +1924,17 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		return -1;
 	}
 
+	/* Without scatter, a super-frame must fit in a single mbuf */
+	if ((rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_TCP_LRO) &&
+	    !(rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_SCATTER) &&
+	    rte_pktmbuf_data_room_size(mp) <
+	    RTE_PKTMBUF_HEADROOM + rxq->rxmode->max_lro_pkt_size) {
+		TAP_LOG(ERR,
+			"%s: LRO needs Rx scatter or mbufs of %u bytes",
+			dev->device->name, rxq->rxmode->max_lro_pkt_size);
+		return -EINVAL;
+	}
+
 	rxq->mp = mp;
 	rxq->trigger_seen = 1; /* force initial burst */
 	rxq->in_port = dev->data->port_id;
@@ -1599,8 +1957,37 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		goto error;
 	}
 
-	(*rxq->iovecs)[0].iov_len = sizeof(struct tun_pi);
-	(*rxq->iovecs)[0].iov_base = &rxq->pi;
+	(*rxq->iovecs)[0].iov_len = sizeof(rxq->hdr.pi);
+	if (rxq->vnet_hdr)
+		(*rxq->iovecs)[0].iov_len += sizeof(rxq->hdr.vnet_hdr);
+	(*rxq->iovecs)[0].iov_base = &rxq->hdr;
+
+	if (internals->io_uring != TAP_IO_URING_OFF) {
+		/* Packets are read in the mbufs, headers in their headroom */
+		if (rxq->rxmode->offloads & RTE_ETH_RX_OFFLOAD_SCATTER ||
+		    RTE_PKTMBUF_HEADROOM < (*rxq->iovecs)[0].iov_len) {
+			TAP_LOG(ERR, "%s: io_uring does not support Rx scatter",
+				dev->device->name);
+			ret = -ENOTSUP;
+			goto error;
+		}
+		process_private->rxq_urings[rx_queue_id] =
+			tap_uring_create(fd, nb_rx_desc,
+				internals->io_uring == TAP_IO_URING_SQPOLL,
+				0, socket_id);
+		if (process_private->rxq_urings[rx_queue_id] == NULL) {
+			ret = -rte_errno;
+			goto error;
+		}
+		/* Without registered buffers, the mbufs are mapped per read */
+		ret = tap_uring_register_mempool(
+			process_private->rxq_urings[rx_queue_id], mp);
+		if (ret < 0)
+			TAP_LOG(INFO, "%s: mempool %s not registered: %s",
+				dev->device->name, mp->name, strerror(-ret));
+		rxq->trigger_read = 0;
+		goto done;
+	}
 
 	for (i = 1; i <= nb_desc; i++) {
 		*tmp = rte_pktmbuf_alloc(rxq->mp);
@@ -1618,6 +2005,7 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		tmp = &(*tmp)->next;
 	}
 
+done:
 	TAP_LOG(DEBUG, "  RX TUNTAP device name %s, qid %d on fd %d",
 		internals->name, rx_queue_id,
 		process_private->rxq_fds[rx_queue_id]);
@@ -1635,8 +2023,8 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 static int
 tap_tx_queue_setup(struct rte_eth_dev *dev,
 		   uint16_t tx_queue_id,
-		   uint16_t nb_tx_desc __rte_unused,
-		   unsigned int socket_id __rte_unused,
+		   uint16_t nb_tx_desc,
+		   unsigned int socket_id,
 		   const struct rte_eth_txconf *tx_conf)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
@@ -1661,6 +2049,14 @@ tap_tx_queue_setup(struct rte_eth_dev *dev,
 	ret = tap_setup_queue(dev, internals, tx_queue_id, 0);
 	if (ret == -1)
 		return -1;
+	if (internals->io_uring != TAP_IO_URING_OFF) {
+		process_private->txq_urings[tx_queue_id] =
+			tap_uring_create(ret, nb_tx_desc,
+				internals->io_uring == TAP_IO_URING_SQPOLL,
+				TAP_URING_TX_MAX_SEGS, socket_id);
+		if (process_private->txq_urings[tx_queue_id] == NULL)
+			return -rte_errno;
+	}
 	TAP_LOG(DEBUG,
 		"  TX TUNTAP device name %s, qid %d on fd %d csum %s",
 		internals->name, tx_queue_id,
@@ -1925,7 +2321,8 @@ static const struct eth_dev_ops ops = {
 static int
 eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 		   char *remote_iface, struct rte_ether_addr *mac_addr,
-		   enum rte_tuntap_type type, int persist)
+		   enum rte_tuntap_type type, int persist, int vnet_hdr,
+		   enum tap_io_uring_mode io_uring)
 {
 	int numa_node = rte_socket_id();
 	struct rte_eth_dev *dev;
@@ -1958,6 +2355,8 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	pmd->dev = dev;
 	strlcpy(pmd->name, tap_name, sizeof(pmd->name));
 	pmd->type = type;
+	pmd->vnet_hdr = vnet_hdr;
+	pmd->io_uring = io_uring;
 	pmd->ka_fd = -1;
 	pmd->nlsk_fd = -1;
 	pmd->gso_ctx_mp = NULL;
@@ -1991,7 +2390,8 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	data->nb_tx_queues = 0;
 
 	dev->dev_ops = &ops;
-	dev->rx_pkt_burst = pmd_rx_burst;
+	dev->rx_pkt_burst = io_uring != TAP_IO_URING_OFF ?
+		pmd_rx_burst_uring : pmd_rx_burst;
 	dev->tx_pkt_burst = pmd_tx_burst;
 
 	rte_intr_type_set(pmd->intr_handle, RTE_INTR_HANDLE_EXT);
@@ -2217,6 +2617,27 @@ set_remote_iface(const char *key __rte_unused,
 	return 0;
 }
 
+static int
+set_io_uring_mode(const char *key __rte_unused,
+		  const char *value,
+		  void *extra_args)
+{
+	enum tap_io_uring_mode *mode = extra_args;
+
+	if (value == NULL || value[0] == '\0' || strcmp(value, "1") == 0) {
+		*mode = TAP_IO_URING_ON;
+	} else if (strcmp(value, ETH_TAP_IO_URING_SQPOLL) == 0) {
+		*mode = TAP_IO_URING_SQPOLL;
+	} else if (strcmp(value, "0") == 0) {
+		*mode = TAP_IO_URING_OFF;
+	} else {
+		TAP_LOG(ERR, "TAP invalid io_uring mode (%s)", value);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 set_mac_type(const char *key __rte_unused,
 	     const char *value,
@@ -2307,7 +2728,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	TAP_LOG(DEBUG, "Initializing pmd_tun for %s", name);
 
 	ret = eth_dev_tap_create(dev, tun_name, remote_iface, 0,
-				 ETH_TUNTAP_TYPE_TUN, 0);
+				 ETH_TUNTAP_TYPE_TUN, 0, 0, TAP_IO_URING_OFF);
 
 leave:
 	if (ret == -1) {
@@ -2436,8 +2857,11 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	char remote_iface[RTE_ETH_NAME_MAX_LEN];
 	struct rte_ether_addr user_mac = { .addr_bytes = {0} };
 	struct rte_eth_dev *eth_dev;
+	struct pmd_internals *internals;
 	int tap_devices_count_increased = 0;
 	int persist = 0;
+	int vnet_hdr = 0;
+	enum tap_io_uring_mode io_uring = TAP_IO_URING_OFF;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2452,6 +2876,13 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 		eth_dev->device = &dev->device;
 		eth_dev->rx_pkt_burst = pmd_rx_burst;
 		eth_dev->tx_pkt_burst = pmd_tx_burst;
+		internals = eth_dev->data->dev_private;
+		if (internals->io_uring != TAP_IO_URING_OFF) {
+			/* The rings are only mapped in the primary process */
+			TAP_LOG(ERR, "%s: io_uring not supported in secondary",
+				name);
+			return -1;
+		}
 		if (!rte_eal_primary_proc_alive(NULL)) {
 			TAP_LOG(ERR, "Primary process is missing");
 			return -1;
@@ -2524,6 +2955,18 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 
 			if (rte_kvargs_count(kvlist, ETH_TAP_PERSIST_ARG) == 1)
 				persist = 1;
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_VNET_HDR_ARG) == 1)
+				vnet_hdr = 1;
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_IO_URING_ARG) == 1) {
+				ret = rte_kvargs_process(kvlist,
+							 ETH_TAP_IO_URING_ARG,
+							 &set_io_uring_mode,
+							 &io_uring);
+				if (ret == -1)
+					goto leave;
+			}
 		}
 	}
 	pmd_link.link_speed = speed;
@@ -2542,7 +2985,8 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	tap_devices_count++;
 	tap_devices_count_increased = 1;
 	ret = eth_dev_tap_create(dev, tap_name, remote_iface, &user_mac,
-				 ETH_TUNTAP_TYPE_TAP, persist);
+				 ETH_TUNTAP_TYPE_TAP, persist, vnet_hdr,
+				 io_uring);
 
 leave:
 	if (ret == -1) {
@@ -2595,5 +3039,8 @@ RTE_PMD_REGISTER_PARAM_STRING(net_tun,
 RTE_PMD_REGISTER_PARAM_STRING(net_tap,
 			      ETH_TAP_IFACE_ARG "=<string> "
 			      ETH_TAP_MAC_ARG "=" ETH_TAP_MAC_ARG_FMT " "
-			      ETH_TAP_REMOTE_ARG "=<string>");
+			      ETH_TAP_REMOTE_ARG "=<string> "
+			      ETH_TAP_VNET_HDR_ARG " "
+			      ETH_TAP_IO_URING_ARG "=[0|1|"
+			      ETH_TAP_IO_URING_SQPOLL "]");
 RTE_LOG_REGISTER_DEFAULT(tap_logtype, NOTICE);
@@ -12,11 +12,13 @@
 #include <net/if.h>
 
 #include <linux/if_tun.h>
+#include <linux/virtio_net.h>
 
 #include <ethdev_driver.h>
 #include <rte_ether.h>
 #include <rte_gso.h>
 #include "tap_log.h"
+#include "tap_uring.h"
 
 #ifdef IFF_MULTI_QUEUE
 #define RTE_PMD_TAP_MAX_QUEUES	TAP_MAX_QUEUES
@@ -32,6 +34,19 @@ enum rte_tuntap_type {
 	ETH_TUNTAP_TYPE_MAX,
 };
 
+/* Datapath system calls */
+enum tap_io_uring_mode {
+	TAP_IO_URING_OFF,               /* a readv() or writev() per packet */
+	TAP_IO_URING_ON,                /* an io_uring_enter() per burst */
+	TAP_IO_URING_SQPOLL,            /* submissions polled by the kernel */
+};
+
+/* Headers preceding each packet read from or written to the tun fd */
+struct tap_pkt_hdr {
+	struct tun_pi pi;               /* packet info */
+	struct virtio_net_hdr vnet_hdr; /* offloads, with IFF_VNET_HDR only */
+};
+
 struct pkt_stats {
 	uint64_t opackets;              /* Number of output packets */
 	uint64_t ipackets;              /* Number of input packets */
@@ -45,6 +60,7 @@ struct pkt_stats {
 struct rx_queue {
 	struct rte_mempool *mp;         /* Mempool for RX packets */
 	uint32_t trigger_seen;          /* Last seen Rx trigger value */
+	uint32_t trigger_read;          /* Rx trigger value of io_uring reads */
 	uint16_t in_port;               /* Port ID */
 	uint16_t queue_id;		/* queue ID*/
 	struct pkt_stats stats;         /* Stats for this RX queue */
@@ -52,13 +68,15 @@ struct rx_queue {
 	struct rte_eth_rxmode *rxmode;  /* RX features */
 	struct rte_mbuf *pool;          /* mbufs pool for this queue */
 	struct iovec (*iovecs)[];       /* descriptors for this queue */
-	struct tun_pi pi;               /* packet info for iovecs */
+	struct tap_pkt_hdr hdr;         /* packet headers for iovecs */
+	int vnet_hdr;                   /* 1 if IFF_VNET_HDR is set */
 };
 
 struct tx_queue {
 	int type;                       /* Type field - TUN|TAP */
 	uint16_t *mtu;                  /* Pointer to MTU from dev_data */
 	uint16_t csum:1;                /* Enable checksum offloading */
+	uint16_t vnet_hdr:1;            /* Offload to kernel via vnet header */
 	struct pkt_stats stats;         /* Stats for this TX queue */
 	struct rte_gso_ctx gso_ctx;     /* GSO context */
 	uint16_t out_port;              /* Port ID */
@@ -81,6 +99,8 @@ struct pmd_internals {
 	int flower_vlan_support;          /* 1 if kernel supports, else 0 */
 	int rss_enabled;                  /* 1 if RSS is enabled, else 0 */
 	int persist;			  /* 1 if keep link up, else 0 */
+	int vnet_hdr;                     /* 1 if IFF_VNET_HDR is set */
+	enum tap_io_uring_mode io_uring;  /* io_uring datapath mode */
 	/* implicit rules set when RSS is enabled */
 	int map_fd;                       /* BPF RSS map fd */
 	int bpf_fd[RTE_PMD_TAP_MAX_QUEUES];/* List of bpf fds per queue */
@@ -98,6 +118,8 @@ struct pmd_internals {
 struct pmd_process_private {
 	int rxq_fds[RTE_PMD_TAP_MAX_QUEUES];
 	int txq_fds[RTE_PMD_TAP_MAX_QUEUES];
+	struct tap_uring *rxq_urings[RTE_PMD_TAP_MAX_QUEUES];
+	struct tap_uring *txq_urings[RTE_PMD_TAP_MAX_QUEUES];
 };
 
 /* tap_intr.c */
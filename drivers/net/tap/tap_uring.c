@@ -0,0 +1,586 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_stdatomic.h>
+
+#include <tap_autoconf.h>
+#include <tap_uring.h>
+
+#include "tap_log.h"
+
+#ifdef HAVE_IO_URING
+
+#include <linux/io_uring.h>
+
+/* Largest ring, whatever the number of descriptors */
+#define TAP_URING_MAX_ENTRIES 4096
+/* Largest packet headers copied from the first iovec of a write */
+#define TAP_URING_HDR_MAX 32
+/* Most memory chunks of a mempool registered as fixed buffers */
+#define TAP_URING_MAX_BUFS 64
+
+struct tap_uring_slot {
+	struct rte_mbuf *mbuf;          /* Packet of the request in flight */
+	uint8_t hdr[TAP_URING_HDR_MAX]; /* Headers written before the packet */
+};
+
+struct tap_uring {
+	int ring_fd;                    /* io_uring file descriptor */
+	int fd;                         /* Tap queue file descriptor */
+	int sqpoll;                     /* 1 if a kernel thread polls the SQ */
+	unsigned int max_iov;           /* Number of iovecs per write */
+	/* Submission queue, shared with the kernel */
+	RTE_ATOMIC(uint32_t) *sq_head;
+	RTE_ATOMIC(uint32_t) *sq_tail;
+	RTE_ATOMIC(uint32_t) *sq_flags;
+	uint32_t sq_mask;
+	uint32_t sq_local_tail;         /* Tail of the SQEs filled */
+	uint32_t sq_submitted;          /* Tail of the SQEs submitted */
+	struct io_uring_sqe *sqes;
+	/* Completion queue, shared with the kernel */
+	RTE_ATOMIC(uint32_t) *cq_head;
+	RTE_ATOMIC(uint32_t) *cq_tail;
+	uint32_t cq_mask;
+	struct io_uring_cqe *cqes;
+	/* Mappings of the rings */
+	void *sq_ring;
+	size_t sq_ring_sz;
+	void *cq_ring;
+	size_t cq_ring_sz;
+	size_t sqes_sz;
+	/* Memory chunks registered as fixed buffers */
+	struct iovec bufs[TAP_URING_MAX_BUFS];
+	unsigned int nb_bufs;
+	/* Request slots, one per SQE, and mbufs to read in */
+	unsigned int nb_slots;
+	unsigned int nb_free;
+	uint32_t *free;                 /* Indexes of the free slots */
+	unsigned int nb_spares;
+	struct rte_mbuf **spares;       /* Mbufs of the reads without packet */
+	struct iovec *iovs;             /* Iovecs of the write requests */
+	struct tap_uring_slot slots[];
+};
+
+static int
+tap_uring_enter(struct tap_uring *uring, unsigned int to_submit,
+		unsigned int min_complete, unsigned int flags)
+{
+	return syscall(__NR_io_uring_enter, uring->ring_fd, to_submit,
+		       min_complete, flags, NULL, 0);
+}
+
+/**
+ * Create an io_uring instance for a tap queue.
+ *
+ * @param fd
+ *   File descriptor of the tap queue.
+ * @param nb_desc
+ *   Number of requests in flight, rounded up to a power of 2.
+ * @param sqpoll
+ *   Set to 1 to have a kernel thread polling the submissions, so that no
+ *   system call is needed to submit requests while it is busy.
+ * @param max_segs
+ *   Most segments of a packet written, 0 if the queue is only read.
+ * @param socket_id
+ *   NUMA socket of the request slots.
+ *
+ * @return
+ *   The io_uring instance, NULL otherwise with rte_errno set.
+ */
+struct tap_uring *
+tap_uring_create(int fd, unsigned int nb_desc, int sqpoll,
+		 unsigned int max_segs, int socket_id)
+{
+	struct io_uring_params p;
+	struct tap_uring *uring;
+	unsigned int entries;
+	unsigned int i;
+	uint32_t *sq_array;
+	int ring_fd;
+
+	entries = rte_align32pow2(RTE_MAX(nb_desc, 1U));
+	entries = RTE_MIN(entries, (unsigned int)TAP_URING_MAX_ENTRIES);
+	memset(&p, 0, sizeof(p));
+	if (sqpoll)
+		p.flags |= IORING_SETUP_SQPOLL;
+	ring_fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (ring_fd < 0) {
+		rte_errno = errno;
+		TAP_LOG(ERR, "Unable to set up io_uring: %s", strerror(errno));
+		return NULL;
+	}
+
+	uring = rte_zmalloc_socket("tap_uring", sizeof(*uring) +
+				   p.sq_entries * sizeof(uring->slots[0]),
+				   RTE_CACHE_LINE_SIZE, socket_id);
+	if (uring == NULL) {
+		close(ring_fd);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+	uring->ring_fd = ring_fd;
+	uring->fd = fd;
+	uring->sqpoll = sqpoll;
+	uring->nb_slots = p.sq_entries;
+	uring->max_iov = max_segs ? max_segs + 1 : 0;
+	uring->free = rte_malloc_socket("tap_uring", p.sq_entries *
+					sizeof(*uring->free), 0, socket_id);
+	uring->spares = rte_malloc_socket("tap_uring", p.sq_entries *
+					  sizeof(*uring->spares), 0,
+					  socket_id);
+	if (uring->max_iov)
+		uring->iovs = rte_malloc_socket("tap_uring", p.sq_entries *
+						uring->max_iov *
+						sizeof(*uring->iovs), 0,
+						socket_id);
+	if (uring->free == NULL || uring->spares == NULL ||
+	    (uring->max_iov && uring->iovs == NULL)) {
+		rte_errno = ENOMEM;
+		goto error;
+	}
+	for (i = 0; i < uring->nb_slots; i++)
+		uring->free[uring->nb_free++] = i;
+
+	uring->sq_ring_sz = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+	uring->cq_ring_sz = p.cq_off.cqes +
+		p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+		uring->sq_ring_sz = uring->cq_ring_sz =
+			RTE_MAX(uring->sq_ring_sz, uring->cq_ring_sz);
+	uring->sqes_sz = p.sq_entries * sizeof(struct io_uring_sqe);
+
+	uring->sq_ring = mmap(NULL, uring->sq_ring_sz, PROT_READ | PROT_WRITE,
+			      MAP_SHARED | MAP_POPULATE, ring_fd,
+			      IORING_OFF_SQ_RING);
+	if (uring->sq_ring == MAP_FAILED)
+		goto error_mmap;
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		uring->cq_ring = uring->sq_ring;
+	} else {
+		uring->cq_ring = mmap(NULL, uring->cq_ring_sz,
+				      PROT_READ | PROT_WRITE,
+				      MAP_SHARED | MAP_POPULATE, ring_fd,
+				      IORING_OFF_CQ_RING);
+		if (uring->cq_ring == MAP_FAILED)
+			goto error_mmap;
+	}
+	uring->sqes = mmap(NULL, uring->sqes_sz, PROT_READ | PROT_WRITE,
+			   MAP_SHARED | MAP_POPULATE, ring_fd,
+			   IORING_OFF_SQES);
+	if (uring->sqes == MAP_FAILED)
+		goto error_mmap;
+
+	uring->sq_head = RTE_PTR_ADD(uring->sq_ring, p.sq_off.head);
+	uring->sq_tail = RTE_PTR_ADD(uring->sq_ring, p.sq_off.tail);
+	uring->sq_flags = RTE_PTR_ADD(uring->sq_ring, p.sq_off.flags);
+	uring->sq_mask = *(uint32_t *)RTE_PTR_ADD(uring->sq_ring,
+						  p.sq_off.ring_mask);
+	uring->cq_head = RTE_PTR_ADD(uring->cq_ring, p.cq_off.head);
+	uring->cq_tail = RTE_PTR_ADD(uring->cq_ring, p.cq_off.tail);
+	uring->cq_mask = *(uint32_t *)RTE_PTR_ADD(uring->cq_ring,
+						  p.cq_off.ring_mask);
+	uring->cqes = RTE_PTR_ADD(uring->cq_ring, p.cq_off.cqes);
+
+	/* SQEs are always submitted in order */
+	sq_array = RTE_PTR_ADD(uring->sq_ring, p.sq_off.array);
+	for (i = 0; i < p.sq_entries; i++)
+		sq_array[i] = i;
+	uring->sq_local_tail = *uring->sq_tail;
+	uring->sq_submitted = uring->sq_local_tail;
+
+	return uring;
+
+error_mmap:
+	rte_errno = errno;
+	TAP_LOG(ERR, "Unable to map io_uring: %s", strerror(errno));
+error:
+	if (uring->sq_ring == MAP_FAILED)
+		uring->sq_ring = NULL;
+	if (uring->cq_ring == MAP_FAILED)
+		uring->cq_ring = NULL;
+	if (uring->sqes == MAP_FAILED)
+		uring->sqes = NULL;
+	tap_uring_free(uring);
+	return NULL;
+}
+
+/**
+ * Free an io_uring instance, once its requests in flight are completed.
+ *
+ * @param uring
+ *   The io_uring instance, or NULL.
+ */
+void
+tap_uring_free(struct tap_uring *uring)
+{
+	struct rte_mbuf *mbufs[32];
+	int res[RTE_DIM(mbufs)];
+	unsigned int n;
+
+	if (uring == NULL)
+		return;
+
+	while (uring->sqes != NULL && tap_uring_inflight(uring) != 0) {
+		if (tap_uring_enter(uring,
+				uring->sq_local_tail - uring->sq_submitted,
+				tap_uring_inflight(uring),
+				IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+			TAP_LOG(ERR, "Unable to wait for io_uring requests: %s",
+				strerror(errno));
+			break;
+		}
+		uring->sq_submitted = uring->sq_local_tail;
+		n = tap_uring_complete(uring, mbufs, res, RTE_DIM(mbufs));
+		rte_pktmbuf_free_bulk(mbufs, n);
+	}
+	if (uring->spares != NULL)
+		rte_pktmbuf_free_bulk(uring->spares, uring->nb_spares);
+
+	if (uring->sqes != NULL)
+		munmap(uring->sqes, uring->sqes_sz);
+	if (uring->cq_ring != NULL && uring->cq_ring != uring->sq_ring)
+		munmap(uring->cq_ring, uring->cq_ring_sz);
+	if (uring->sq_ring != NULL)
+		munmap(uring->sq_ring, uring->sq_ring_sz);
+	close(uring->ring_fd);
+	rte_free(uring->iovs);
+	rte_free(uring->spares);
+	rte_free(uring->free);
+	rte_free(uring);
+}
+
+static void
+tap_uring_mem_cb(struct rte_mempool *mp __rte_unused, void *opaque,
+		 struct rte_mempool_memhdr *memhdr,
+		 unsigned int mem_idx __rte_unused)
+{
+	struct tap_uring *uring = opaque;
+
+	if (uring->nb_bufs < RTE_DIM(uring->bufs)) {
+		uring->bufs[uring->nb_bufs].iov_base = memhdr->addr;
+		uring->bufs[uring->nb_bufs].iov_len = memhdr->len;
+	}
+	uring->nb_bufs++;
+}
+
+/**
+ * Register the memory of a mempool as fixed buffers, so that the kernel
+ * does not map the pages of each packet read into its mbufs.
+ *
+ * @param uring
+ *   The io_uring instance.
+ * @param mp
+ *   Mempool of the mbufs read into.
+ *
+ * @return
+ *   0 on success, a negative errno value otherwise.
+ */
+int
+tap_uring_register_mempool(struct tap_uring *uring, struct rte_mempool *mp)
+{
+	uring->nb_bufs = 0;
+	rte_mempool_mem_iter(mp, tap_uring_mem_cb, uring);
+	if (uring->nb_bufs > RTE_DIM(uring->bufs)) {
+		uring->nb_bufs = 0;
+		return -E2BIG;
+	}
+	if (syscall(__NR_io_uring_register, uring->ring_fd,
+		    IORING_REGISTER_BUFFERS, uring->bufs,
+		    uring->nb_bufs) < 0) {
+		uring->nb_bufs = 0;
+		return -errno;
+	}
+	return 0;
+}
+
+/**
+ * Get the number of requests not completed yet.
+ */
+unsigned int
+tap_uring_inflight(const struct tap_uring *uring)
+{
+	return uring->nb_slots - uring->nb_free;
+}
+
+static struct io_uring_sqe *
+tap_uring_sqe_get(struct tap_uring *uring, unsigned int slot_id)
+{
+	struct io_uring_sqe *sqe;
+
+	/* A SQE is never reused before the completion of its request */
+	sqe = &uring->sqes[uring->sq_local_tail++ & uring->sq_mask];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->fd = uring->fd;
+	sqe->user_data = slot_id;
+	return sqe;
+}
+
+/**
+ * Queue reads of packets, each one in a mbuf, preceded by its headers in
+ * the headroom. The mbufs without a packet read are reused first.
+ *
+ * @param uring
+ *   The io_uring instance.
+ * @param mp
+ *   Mempool to allocate the mbufs from.
+ * @param nb_pkts
+ *   Number of packets to read.
+ * @param hdr_len
+ *   Length of the headers preceding each packet.
+ *
+ * @return
+ *   The number of reads queued.
+ */
+unsigned int
+tap_uring_read_burst(struct tap_uring *uring, struct rte_mempool *mp,
+		     unsigned int nb_pkts, unsigned int hdr_len)
+{
+	unsigned int n = RTE_MIN(nb_pkts, uring->nb_free);
+	unsigned int i, j;
+
+	if (uring->nb_spares < n &&
+	    rte_pktmbuf_alloc_bulk(mp, &uring->spares[uring->nb_spares],
+				   n - uring->nb_spares) == 0)
+		uring->nb_spares = n;
+	n = RTE_MIN(n, uring->nb_spares);
+
+	for (i = 0; i < n; i++) {
+		struct rte_mbuf *mbuf = uring->spares[--uring->nb_spares];
+		uint32_t slot_id = uring->free[--uring->nb_free];
+		struct io_uring_sqe *sqe = tap_uring_sqe_get(uring, slot_id);
+		char *addr = (char *)mbuf->buf_addr + mbuf->data_off - hdr_len;
+
+		uring->slots[slot_id].mbuf = mbuf;
+		sqe->opcode = IORING_OP_READ;
+		sqe->addr = (uintptr_t)addr;
+		sqe->len = mbuf->buf_len - mbuf->data_off + hdr_len;
+		for (j = 0; j < uring->nb_bufs; j++) {
+			if (addr >= (char *)uring->bufs[j].iov_base &&
+			    addr + sqe->len <= (char *)uring->bufs[j].iov_base +
+					       uring->bufs[j].iov_len) {
+				sqe->opcode = IORING_OP_READ_FIXED;
+				sqe->buf_index = j;
+				break;
+			}
+		}
+	}
+	return n;
+}
+
+/**
+ * Give back a mbuf returned by a read without packet, to read in again.
+ */
+void
+tap_uring_recycle(struct tap_uring *uring, struct rte_mbuf *mbuf)
+{
+	uring->spares[uring->nb_spares++] = mbuf;
+}
+
+/**
+ * Queue the write of a packet. The first iovec, holding the packet headers,
+ * is copied, and the others point to the data of the mbuf segments, which
+ * are kept until the completion of the write.
+ *
+ * @param uring
+ *   The io_uring instance.
+ * @param iov
+ *   Headers and segments of the packet.
+ * @param iovcnt
+ *   Number of iovecs.
+ * @param mbuf
+ *   The packet.
+ *
+ * @return
+ *   0 on success, a negative errno value otherwise.
+ */
+int
+tap_uring_writev(struct tap_uring *uring, const struct iovec *iov,
+		 int iovcnt, struct rte_mbuf *mbuf)
+{
+	struct tap_uring_slot *slot;
+	struct io_uring_sqe *sqe;
+	struct rte_mbuf *seg;
+	struct iovec *slot_iov;
+	uint32_t slot_id;
+
+	if (uring->nb_free == 0)
+		return -ENOBUFS;
+	if ((unsigned int)iovcnt > uring->max_iov ||
+	    iov[0].iov_len > TAP_URING_HDR_MAX)
+		return -EMSGSIZE;
+
+	slot_id = uring->free[--uring->nb_free];
+	slot = &uring->slots[slot_id];
+	slot_iov = &uring->iovs[slot_id * uring->max_iov];
+	memcpy(slot->hdr, iov[0].iov_base, iov[0].iov_len);
+	slot_iov[0].iov_base = slot->hdr;
+	slot_iov[0].iov_len = iov[0].iov_len;
+	memcpy(&slot_iov[1], &iov[1], (iovcnt - 1) * sizeof(*iov));
+
+	/* The caller still frees the mbuf once queued */
+	for (seg = mbuf; seg != NULL; seg = seg->next)
+		rte_mbuf_refcnt_update(seg, 1);
+	slot->mbuf = mbuf;
+
+	sqe = tap_uring_sqe_get(uring, slot_id);
+	sqe->opcode = IORING_OP_WRITEV;
+	sqe->addr = (uintptr_t)slot_iov;
+	sqe->len = iovcnt;
+	return 0;
+}
+
+/**
+ * Submit the requests queued. Without a kernel thread polling them, the
+ * reads and writes on the non-blocking tap queue are completed on return.
+ *
+ * @return
+ *   0 on success, a negative errno value otherwise.
+ */
+int
+tap_uring_submit(struct tap_uring *uring)
+{
+	unsigned int to_submit = uring->sq_local_tail - uring->sq_submitted;
+	int ret;
+
+	if (to_submit == 0)
+		return 0;
+	rte_atomic_store_explicit(uring->sq_tail, uring->sq_local_tail,
+				  rte_memory_order_release);
+
+	if (uring->sqpoll) {
+		uring->sq_submitted = uring->sq_local_tail;
+		/* Order the tail store with the flags load, as the kernel */
+		rte_atomic_thread_fence(rte_memory_order_seq_cst);
+		if (rte_atomic_load_explicit(uring->sq_flags,
+				rte_memory_order_relaxed) &
+		    IORING_SQ_NEED_WAKEUP)
+			tap_uring_enter(uring, 0, 0, IORING_ENTER_SQ_WAKEUP);
+		return 0;
+	}
+
+	ret = tap_uring_enter(uring, to_submit, 0, 0);
+	if (ret < 0)
+		return -errno;
+	uring->sq_submitted += ret;
+	return 0;
+}
+
+/**
+ * Get the completed requests, with their mbuf and result.
+ *
+ * @param uring
+ *   The io_uring instance.
+ * @param mbufs
+ *   Filled with the mbuf of each request completed.
+ * @param res
+ *   Filled with the result of each request completed, the number of bytes
+ *   read or written, or a negative errno value.
+ * @param nb_pkts
+ *   Most requests to complete.
+ *
+ * @return
+ *   The number of requests completed.
+ */
+unsigned int
+tap_uring_complete(struct tap_uring *uring, struct rte_mbuf **mbufs,
+		   int *res, unsigned int nb_pkts)
+{
+	uint32_t head = rte_atomic_load_explicit(uring->cq_head,
+						 rte_memory_order_relaxed);
+	uint32_t tail = rte_atomic_load_explicit(uring->cq_tail,
+						 rte_memory_order_acquire);
+	unsigned int i;
+
+	for (i = 0; i < nb_pkts && head != tail; i++, head++) {
+		const struct io_uring_cqe *cqe = &uring->cqes[head &
+							       uring->cq_mask];
+		uint32_t slot_id = cqe->user_data;
+
+		mbufs[i] = uring->slots[slot_id].mbuf;
+		res[i] = cqe->res;
+		uring->slots[slot_id].mbuf = NULL;
+		uring->free[uring->nb_free++] = slot_id;
+	}
+	rte_atomic_store_explicit(uring->cq_head, head,
+				  rte_memory_order_release);
+	return i;
+}
+
+#else /* !HAVE_IO_URING */
+
+struct tap_uring *
+tap_uring_create(int fd __rte_unused, unsigned int nb_desc __rte_unused,
+		 int sqpoll __rte_unused, unsigned int max_segs __rte_unused,
+		 int socket_id __rte_unused)
+{
+	TAP_LOG(ERR, "io_uring is not supported by the kernel headers");
+	rte_errno = ENOTSUP;
+	return NULL;
+}
+
+void
+tap_uring_free(struct tap_uring *uring __rte_unused)
+{
+}
+
+int
+tap_uring_register_mempool(struct tap_uring *uring __rte_unused,
+			   struct rte_mempool *mp __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+unsigned int
+tap_uring_inflight(const struct tap_uring *uring __rte_unused)
+{
+	return 0;
+}
+
+unsigned int
+tap_uring_read_burst(struct tap_uring *uring __rte_unused,
+		     struct rte_mempool *mp __rte_unused,
+		     unsigned int nb_pkts __rte_unused,
+		     unsigned int hdr_len __rte_unused)
+{
+	return 0;
+}
+
+void
+tap_uring_recycle(struct tap_uring *uring __rte_unused,
+		  struct rte_mbuf *mbuf __rte_unused)
+{
+}
+
+int
+tap_uring_writev(struct tap_uring *uring __rte_unused,
+		 const struct iovec *iov __rte_unused,
+		 int iovcnt __rte_unused, struct rte_mbuf *mbuf __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+int
+tap_uring_submit(struct tap_uring *uring __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+unsigned int
+tap_uring_complete(struct tap_uring *uring __rte_unused,
+		   struct rte_mbuf **mbufs __rte_unused,
+		   int *res __rte_unused, unsigned int nb_pkts __rte_unused)
+{
+	return 0;
+}
+
+#endif /* HAVE_IO_URING */
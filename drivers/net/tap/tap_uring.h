@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef _TAP_URING_H_
+#define _TAP_URING_H_
+
+#include <sys/uio.h>
+
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+/*
+ * Minimal io_uring instance reading or writing the packets of a tap queue,
+ * a burst of packets per submission. Each request in flight holds a mbuf.
+ */
+struct tap_uring;
+
+struct tap_uring *tap_uring_create(int fd, unsigned int nb_desc, int sqpoll,
+				   unsigned int max_segs, int socket_id);
+void tap_uring_free(struct tap_uring *uring);
+int tap_uring_register_mempool(struct tap_uring *uring,
+			       struct rte_mempool *mp);
+unsigned int tap_uring_inflight(const struct tap_uring *uring);
+unsigned int tap_uring_read_burst(struct tap_uring *uring,
+				  struct rte_mempool *mp, unsigned int nb_pkts,
+				  unsigned int hdr_len);
+void tap_uring_recycle(struct tap_uring *uring, struct rte_mbuf *mbuf);
+int tap_uring_writev(struct tap_uring *uring, const struct iovec *iov,
+		     int iovcnt, struct rte_mbuf *mbuf);
+int tap_uring_submit(struct tap_uring *uring);
+unsigned int tap_uring_complete(struct tap_uring *uring,
+				struct rte_mbuf **mbufs, int *res,
+				unsigned int nb_pkts);
+
+#endif /* _TAP_URING_H_ */
@@ -17,6 +17,8 @@
 #include <bus_vdev_driver.h>
 #include <rte_kvargs.h>
 #include <rte_vhost.h>
+#include <rte_vhost_async.h>
+#include <rte_dmadev.h>
 #include <rte_spinlock.h>
 
 #include "rte_eth_vhost.h"
@@ -37,7 +39,10 @@ enum {VIRTIO_RXQ, VIRTIO_TXQ, VIRTIO_QNUM};
 #define ETH_VHOST_LINEAR_BUF		"linear-buffer"
 #define ETH_VHOST_EXT_BUF		"ext-buffer"
 #define ETH_VHOST_LEGACY_OL_FLAGS	"legacy-ol-flags"
+#define ETH_VHOST_DMAS			"dmas"
+#define ETH_VHOST_DMA_RING_SIZE		"dma-ring-size"
 #define VHOST_MAX_PKT_BURST 32
+#define VHOST_DMA_RING_SIZE 4096
 
 static const char *valid_arguments[] = {
 	ETH_VHOST_IFACE_ARG,
@@ -49,6 +54,8 @@ static const char *valid_arguments[] = {
 	ETH_VHOST_LINEAR_BUF,
 	ETH_VHOST_EXT_BUF,
 	ETH_VHOST_LEGACY_OL_FLAGS,
+	ETH_VHOST_DMAS,
+	ETH_VHOST_DMA_RING_SIZE,
 	NULL
 };
 
@@ -81,6 +88,13 @@ struct vhost_queue {
 	rte_spinlock_t intr_lock;
 	struct epoll_event ev;
 	int kickfd;
+	int16_t dma_id;
+};
+
+/* DMA devices offloading the copies of each queue, -1 if none */
+struct vhost_queue_dmas {
+	int16_t rxq[RTE_MAX_QUEUES_PER_PORT];
+	int16_t txq[RTE_MAX_QUEUES_PER_PORT];
 };
 
 struct pmd_internal {
@@ -95,6 +109,7 @@ struct pmd_internal {
 	bool vlan_strip;
 	bool rx_sw_csum;
 	bool tx_sw_csum;
+	struct vhost_queue_dmas dmas;
 };
 
 struct internal_list {
@@ -119,12 +134,17 @@ struct rte_vhost_vring_state {
 
 	bool cur[RTE_MAX_QUEUES_PER_PORT * 2];
 	bool seen[RTE_MAX_QUEUES_PER_PORT * 2];
+	bool async[RTE_MAX_QUEUES_PER_PORT * 2];
 	unsigned int index;
 	unsigned int max_vring;
 };
 
 static struct rte_vhost_vring_state *vring_states[RTE_MAX_ETHPORTS];
 
+/* DMA devices configured for the async datapath, shared by the ports */
+static int16_t dmas_configured[RTE_DMADEV_DEFAULT_MAX];
+static uint16_t nb_dmas_configured;
+
 static int
 vhost_dev_xstats_reset(struct rte_eth_dev *dev)
 {
@@ -418,9 +438,18 @@ eth_vhost_rx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 		uint16_t num = (uint16_t)RTE_MIN(nb_receive,
 						 VHOST_MAX_PKT_BURST);
 
-		nb_pkts = rte_vhost_dequeue_burst(r->vid, r->virtqueue_id,
-						  r->mb_pool, &bufs[nb_rx],
-						  num);
+		if (r->dma_id >= 0) {
+			int nr_inflight;
+
+			nb_pkts = rte_vhost_async_try_dequeue_burst(r->vid,
+					r->virtqueue_id, r->mb_pool,
+					&bufs[nb_rx], num, &nr_inflight,
+					r->dma_id, 0);
+		} else {
+			nb_pkts = rte_vhost_dequeue_burst(r->vid,
+					r->virtqueue_id, r->mb_pool,
+					&bufs[nb_rx], num);
+		}
 
 		nb_rx += nb_pkts;
 		nb_receive -= nb_pkts;
@@ -449,6 +478,28 @@ eth_vhost_rx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 	return nb_rx;
 }
 
+/*
+ * Free the packets copied by the DMA device into the guest, which sees them
+ * only once their completion is polled.
+ */
+static uint32_t
+vhost_async_tx_complete(struct vhost_queue *r, uint32_t max)
+{
+	struct rte_mbuf *pkts[VHOST_MAX_PKT_BURST];
+	uint32_t nb_cpl = 0;
+	uint16_t n;
+
+	do {
+		n = rte_vhost_poll_enqueue_completed(r->vid, r->virtqueue_id,
+				pkts, RTE_MIN(max - nb_cpl, RTE_DIM(pkts)),
+				r->dma_id, 0);
+		rte_pktmbuf_free_bulk(pkts, n);
+		nb_cpl += n;
+	} while (n == RTE_DIM(pkts) && nb_cpl < max);
+
+	return nb_cpl;
+}
+
 static uint16_t
 eth_vhost_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 {
@@ -492,8 +543,13 @@ eth_vhost_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 		uint16_t num = (uint16_t)RTE_MIN(nb_send,
 						 VHOST_MAX_PKT_BURST);
 
-		nb_pkts = rte_vhost_enqueue_burst(r->vid, r->virtqueue_id,
-						  &bufs[nb_tx], num);
+		if (r->dma_id >= 0)
+			nb_pkts = rte_vhost_submit_enqueue_burst(r->vid,
+					r->virtqueue_id, &bufs[nb_tx], num,
+					r->dma_id, 0);
+		else
+			nb_pkts = rte_vhost_enqueue_burst(r->vid,
+					r->virtqueue_id, &bufs[nb_tx], num);
 
 		nb_tx += nb_pkts;
 		nb_send -= nb_pkts;
@@ -510,6 +566,12 @@ eth_vhost_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 	r->stats.bytes += nb_bytes;
 	r->stats.missed_pkts += nb_missed;
 
+	/* The packets submitted to the DMA device are freed once copied */
+	if (r->dma_id >= 0) {
+		vhost_async_tx_complete(r, UINT32_MAX);
+		goto out;
+	}
+
 	for (i = 0; likely(i < nb_tx); i++)
 		rte_pktmbuf_free(bufs[i]);
 out:
@@ -810,6 +872,41 @@ queue_setup(struct rte_eth_dev *eth_dev, struct pmd_internal *internal)
 	}
 }
 
+/* DMA device offloading the copies of a vring, -1 if none */
+static int16_t
+vhost_vring_dma_id(struct pmd_internal *internal, uint16_t vring)
+{
+	uint16_t qid = vring / VIRTIO_QNUM;
+
+	if (qid >= internal->max_queues)
+		return -1;
+	/* Guest RX vrings are filled by the Tx queues */
+	if (vring % VIRTIO_QNUM == VIRTIO_RXQ)
+		return internal->dmas.txq[qid];
+	return internal->dmas.rxq[qid];
+}
+
+/* Free the packets of a vring whose copies are still in flight */
+static void
+vhost_async_clear_vring(int vid, uint16_t vring, int16_t dma_id,
+			bool locked)
+{
+	struct rte_mbuf *pkts[VHOST_MAX_PKT_BURST];
+	uint16_t n;
+
+	while ((locked ?
+		rte_vhost_async_get_inflight_thread_unsafe(vid, vring) :
+		rte_vhost_async_get_inflight(vid, vring)) > 0) {
+		if (locked)
+			n = rte_vhost_clear_queue_thread_unsafe(vid, vring,
+					pkts, RTE_DIM(pkts), dma_id, 0);
+		else
+			n = rte_vhost_clear_queue(vid, vring, pkts,
+					RTE_DIM(pkts), dma_id, 0);
+		rte_pktmbuf_free_bulk(pkts, n);
+	}
+}
+
 static int
 new_device(int vid)
 {
@@ -895,6 +992,16 @@ destroy_device(int vid)
 	update_queuing_status(eth_dev, true);
 	eth_vhost_unconfigure_intr(eth_dev);
 
+	state = vring_states[eth_dev->data->port_id];
+	for (i = 0; i < RTE_DIM(state->async); i++) {
+		if (!state->async[i])
+			continue;
+		vhost_async_clear_vring(vid, i, vhost_vring_dma_id(internal, i),
+					false);
+		rte_vhost_async_channel_unregister(vid, i);
+		state->async[i] = false;
+	}
+
 	eth_dev->data->dev_link.link_status = RTE_ETH_LINK_DOWN;
 
 	if (eth_dev->data->rx_queues && eth_dev->data->tx_queues) {
@@ -912,7 +1019,6 @@ destroy_device(int vid)
 		}
 	}
 
-	state = vring_states[eth_dev->data->port_id];
 	rte_spinlock_lock(&state->lock);
 	for (i = 0; i <= state->max_vring; i++) {
 		state->cur[i] = false;
@@ -933,6 +1039,7 @@ vring_state_changed(int vid, uint16_t vring, int enable)
 	struct rte_eth_dev *eth_dev;
 	struct internal_list *list;
 	char ifname[PATH_MAX];
+	int16_t dma_id;
 
 	rte_vhost_get_ifname(vid, ifname, sizeof(ifname));
 	list = find_internal_resource(ifname);
@@ -948,6 +1055,21 @@ vring_state_changed(int vid, uint16_t vring, int enable)
 	if (eth_dev->data->dev_conf.intr_conf.rxq && vring % 2)
 		eth_vhost_update_intr(eth_dev, (vring - 1) >> 1);
 
+	/* The vhost library holds the vring locks during this callback */
+	dma_id = vhost_vring_dma_id(eth_dev->data->dev_private, vring);
+	if (dma_id >= 0 && enable && !state->async[vring]) {
+		if (rte_vhost_async_channel_register_thread_unsafe(vid,
+								   vring)) {
+			VHOST_LOG(ERR, "Failed to register async vring%u\n",
+				  vring);
+			return -1;
+		}
+		state->async[vring] = true;
+	} else if (dma_id >= 0 && !enable && state->async[vring]) {
+		/* A vring cannot be enabled back with copies in flight */
+		vhost_async_clear_vring(vid, vring, dma_id, true);
+	}
+
 	rte_spinlock_lock(&state->lock);
 	if (state->cur[vring] == enable) {
 		rte_spinlock_unlock(&state->lock);
@@ -1230,6 +1352,7 @@ eth_rx_queue_setup(struct rte_eth_dev *dev, uint16_t rx_queue_id,
 		   const struct rte_eth_rxconf *rx_conf __rte_unused,
 		   struct rte_mempool *mb_pool)
 {
+	struct pmd_internal *internal = dev->data->dev_private;
 	struct vhost_queue *vq;
 
 	vq = rte_zmalloc_socket(NULL, sizeof(struct vhost_queue),
@@ -1241,6 +1364,7 @@ eth_rx_queue_setup(struct rte_eth_dev *dev, uint16_t rx_queue_id,
 
 	vq->mb_pool = mb_pool;
 	vq->virtqueue_id = rx_queue_id * VIRTIO_QNUM + VIRTIO_TXQ;
+	vq->dma_id = internal->dmas.rxq[rx_queue_id];
 	rte_spinlock_init(&vq->intr_lock);
 	vq->kickfd = -1;
 	dev->data->rx_queues[rx_queue_id] = vq;
@@ -1254,6 +1378,7 @@ eth_tx_queue_setup(struct rte_eth_dev *dev, uint16_t tx_queue_id,
 		   unsigned int socket_id,
 		   const struct rte_eth_txconf *tx_conf __rte_unused)
 {
+	struct pmd_internal *internal = dev->data->dev_private;
 	struct vhost_queue *vq;
 
 	vq = rte_zmalloc_socket(NULL, sizeof(struct vhost_queue),
@@ -1264,6 +1389,7 @@ eth_tx_queue_setup(struct rte_eth_dev *dev, uint16_t tx_queue_id,
 	}
 
 	vq->virtqueue_id = tx_queue_id * VIRTIO_QNUM + VIRTIO_RXQ;
+	vq->dma_id = internal->dmas.txq[tx_queue_id];
 	rte_spinlock_init(&vq->intr_lock);
 	vq->kickfd = -1;
 	dev->data->tx_queues[tx_queue_id] = vq;
@@ -1387,13 +1513,30 @@ eth_tx_queue_release(struct rte_eth_dev *dev, uint16_t qid)
 }
 
 static int
-eth_tx_done_cleanup(void *txq __rte_unused, uint32_t free_cnt __rte_unused)
+eth_tx_done_cleanup(void *txq, uint32_t free_cnt)
 {
+	struct vhost_queue *r = txq;
+	int nb_cpl = 0;
+
 	/*
-	 * vHost does not hang onto mbuf. eth_vhost_tx() copies packet data
-	 * and releases mbuf, so nothing to cleanup.
+	 * Without DMA device, vHost does not hang onto mbuf. eth_vhost_tx()
+	 * copies packet data and releases mbuf, so nothing to cleanup.
 	 */
-	return 0;
+	if (r->dma_id < 0)
+		return 0;
+
+	if (unlikely(rte_atomic32_read(&r->allow_queuing) == 0))
+		return 0;
+
+	rte_atomic32_set(&r->while_queuing, 1);
+
+	if (likely(rte_atomic32_read(&r->allow_queuing) != 0))
+		nb_cpl = vhost_async_tx_complete(r,
+				free_cnt != 0 ? free_cnt : UINT32_MAX);
+
+	rte_atomic32_set(&r->while_queuing, 0);
+
+	return nb_cpl;
 }
 
 static int
@@ -1500,7 +1643,7 @@ static const struct eth_dev_ops ops = {
 static int
 eth_dev_vhost_create(struct rte_vdev_device *dev, char *iface_name,
 	int16_t queues, const unsigned int numa_node, uint64_t flags,
-	uint64_t disable_flags)
+	uint64_t disable_flags, const struct vhost_queue_dmas *dmas)
 {
 	const char *name = rte_vdev_device_name(dev);
 	struct rte_eth_dev_data *data;
@@ -1542,6 +1685,7 @@ eth_dev_vhost_create(struct rte_vdev_device *dev, char *iface_name,
 	internal->vid = -1;
 	internal->flags = flags;
 	internal->disable_flags = disable_flags;
+	internal->dmas = *dmas;
 	data->dev_link = pmd_link;
 	data->dev_flags = RTE_ETH_DEV_INTR_LSC |
 				RTE_ETH_DEV_AUTOFILL_QUEUE_XSTATS;
@@ -1594,6 +1738,114 @@ open_int(const char *key __rte_unused, const char *value, void *extra_args)
 	return 0;
 }
 
+/* Parse the DMA devices of the queues, as [txq0@dma0,rxq0@dma1,...] */
+static int
+open_dmas(const char *key __rte_unused, const char *value, void *extra_args)
+{
+	struct vhost_queue_dmas *dmas = extra_args;
+	char *input, *elem, *saveptr = NULL;
+	size_t len;
+	int ret = 0;
+
+	if (value == NULL)
+		return -1;
+
+	len = strlen(value);
+	if (len < 2 || value[0] != '[' || value[len - 1] != ']') {
+		VHOST_LOG(ERR, "Invalid %s argument: %s\n", ETH_VHOST_DMAS,
+			  value);
+		return -1;
+	}
+
+	input = strndup(value + 1, len - 2);
+	if (input == NULL)
+		return -1;
+
+	for (elem = strtok_r(input, ",", &saveptr); elem != NULL;
+	     elem = strtok_r(NULL, ",", &saveptr)) {
+		char *dma_name = strchr(elem, '@');
+		int16_t *dma_ids;
+		unsigned long qid;
+		char *end;
+		int dma_id;
+
+		if (dma_name == NULL)
+			goto invalid;
+		*dma_name++ = '\0';
+
+		if (strncmp(elem, "txq", 3) == 0)
+			dma_ids = dmas->txq;
+		else if (strncmp(elem, "rxq", 3) == 0)
+			dma_ids = dmas->rxq;
+		else
+			goto invalid;
+
+		errno = 0;
+		qid = strtoul(elem + 3, &end, 10);
+		if (end == elem + 3 || *end != '\0' || errno != 0 ||
+		    qid >= RTE_MAX_QUEUES_PER_PORT)
+			goto invalid;
+
+		dma_id = rte_dma_get_dev_id_by_name(dma_name);
+		if (dma_id < 0) {
+			VHOST_LOG(ERR, "DMA device %s not found\n", dma_name);
+			ret = -1;
+			break;
+		}
+		dma_ids[qid] = dma_id;
+		continue;
+invalid:
+		VHOST_LOG(ERR, "Invalid %s argument: %s\n", ETH_VHOST_DMAS,
+			  value);
+		ret = -1;
+		break;
+	}
+
+	free(input);
+	return ret;
+}
+
+/* Start a DMA device, unless already done for another queue or port */
+static int
+vhost_dma_setup(int16_t dma_id, uint16_t ring_size)
+{
+	struct rte_dma_conf dev_conf = { .nb_vchans = 1 };
+	struct rte_dma_vchan_conf vchan_conf = {
+		.direction = RTE_DMA_DIR_MEM_TO_MEM,
+	};
+	struct rte_dma_info info;
+	uint16_t i;
+
+	for (i = 0; i < nb_dmas_configured; i++)
+		if (dmas_configured[i] == dma_id)
+			return 0;
+
+	if (nb_dmas_configured == RTE_DIM(dmas_configured) ||
+	    rte_dma_info_get(dma_id, &info) != 0 || info.max_vchans < 1) {
+		VHOST_LOG(ERR, "DMA device %d cannot be used\n", dma_id);
+		return -1;
+	}
+
+	vchan_conf.nb_desc = RTE_MAX(RTE_MIN(ring_size, info.max_desc),
+				     info.min_desc);
+	if (rte_dma_configure(dma_id, &dev_conf) != 0 ||
+	    rte_dma_vchan_setup(dma_id, 0, &vchan_conf) != 0 ||
+	    rte_dma_start(dma_id) != 0) {
+		VHOST_LOG(ERR, "Failed to start DMA device %d\n", dma_id);
+		return -1;
+	}
+
+	if (rte_vhost_async_dma_configure(dma_id, 0) < 0) {
+		VHOST_LOG(ERR, "Failed to configure DMA device %d in vhost\n",
+			  dma_id);
+		rte_dma_stop(dma_id);
+		return -1;
+	}
+
+	dmas_configured[nb_dmas_configured++] = dma_id;
+	return 0;
+}
+
 static int
 rte_pmd_vhost_probe(struct rte_vdev_device *dev)
 {
@@ -1610,8 +1862,11 @@ rte_pmd_vhost_probe(struct rte_vdev_device *dev)
 	int linear_buf = 0;
 	int ext_buf = 0;
 	int legacy_ol_flags = 0;
+	uint16_t dma_ring_size = VHOST_DMA_RING_SIZE;
+	struct vhost_queue_dmas dmas;
 	struct rte_eth_dev *eth_dev;
 	const char *name = rte_vdev_device_name(dev);
+	uint16_t i;
 
 	VHOST_LOG(INFO, "Initializing pmd_vhost for %s\n", name);
 
@@ -1730,11 +1985,57 @@ rte_pmd_vhost_probe(struct rte_vdev_device *dev)
 	if (legacy_ol_flags == 0)
 		flags |= RTE_VHOST_USER_NET_COMPLIANT_OL_FLAGS;
 
+	for (i = 0; i < RTE_MAX_QUEUES_PER_PORT; i++) {
+		dmas.rxq[i] = -1;
+		dmas.txq[i] = -1;
+	}
+
+	if (rte_kvargs_count(kvlist, ETH_VHOST_DMA_RING_SIZE) == 1) {
+		ret = rte_kvargs_process(kvlist, ETH_VHOST_DMA_RING_SIZE,
+					 &open_int, &dma_ring_size);
+		if (ret < 0)
+			goto out_free;
+
+		if (!rte_is_power_of_2(dma_ring_size)) {
+			VHOST_LOG(ERR, "DMA ring size %u is not a power of 2\n",
+				  dma_ring_size);
+			ret = -1;
+			goto out_free;
+		}
+	}
+
+	if (rte_kvargs_count(kvlist, ETH_VHOST_DMAS) == 1) {
+		ret = rte_kvargs_process(kvlist, ETH_VHOST_DMAS,
+					 &open_dmas, &dmas);
+		if (ret < 0)
+			goto out_free;
+
+		for (i = 0; i < RTE_MAX_QUEUES_PER_PORT; i++) {
+			if (dmas.rxq[i] < 0 && dmas.txq[i] < 0)
+				continue;
+			if (i >= queues) {
+				VHOST_LOG(ERR, "DMA device set on queue %u\n",
+					  i);
+				ret = -1;
+				goto out_free;
+			}
+			if ((dmas.rxq[i] >= 0 &&
+			     vhost_dma_setup(dmas.rxq[i], dma_ring_size) < 0) ||
+			    (dmas.txq[i] >= 0 &&
+			     vhost_dma_setup(dmas.txq[i], dma_ring_size) < 0)) {
+				ret = -1;
+				goto out_free;
+			}
+		}
+		flags |= RTE_VHOST_USER_ASYNC_COPY;
+	}
+
 	if (dev->device.numa_node == SOCKET_ID_ANY)
 		dev->device.numa_node = rte_socket_id();
 
 	ret = eth_dev_vhost_create(dev, iface_name, queues,
-				   dev->device.numa_node, flags, disable_flags);
+				   dev->device.numa_node, flags, disable_flags,
+				   &dmas);
 	if (ret == -1)
 		VHOST_LOG(ERR, "Failed to create %s\n", name);
 
@@ -1778,4 +2079,6 @@ RTE_PMD_REGISTER_PARAM_STRING(net_vhost,
 	"postcopy-support=<0|1> "
 	"tso=<0|1> "
 	"linear-buffer=<0|1> "
-	"ext-buffer=<0|1>");
+	"ext-buffer=<0|1> "
+	"dmas=[txq0@<dmadev>,rxq0@<dmadev>,...] "
+	"dma-ring-size=<int>");
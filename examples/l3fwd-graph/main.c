@@ -23,6 +23,8 @@
 #include <rte_cycles.h>
 #include <rte_eal.h>
 #include <rte_ethdev.h>
+#include <rte_fib.h>
+#include <rte_fib6.h>
 #define RTE_GRAPH_MODEL_SELECT RTE_GRAPH_MODEL_RTC
 #include <rte_graph_worker.h>
 #include <rte_launch.h>
@@ -61,6 +63,13 @@
 /* Graph module */
 #define WORKER_MODEL_RTC "rtc"
 #define WORKER_MODEL_MCORE_DISPATCH "dispatch"
+/* Route lookup method */
+#define LOOKUP_METHOD_LPM "lpm"
+#define LOOKUP_METHOD_FIB "fib"
+#define IPV4_L3FWD_FIB_MAX_ROUTES (1 << 20)
+#define IPV4_L3FWD_FIB_NUM_TBL8 (1 << 15)
+#define IPV6_L3FWD_FIB_MAX_ROUTES (1 << 18)
+#define IPV6_L3FWD_FIB_NUM_TBL8 (1 << 16)
 /* Static global variables used within this file. */
 static uint16_t nb_rxd = RX_DESC_DEFAULT;
 static uint16_t nb_txd = TX_DESC_DEFAULT;
@@ -96,6 +105,9 @@ struct lcore_rx_queue {
 
 static uint8_t model_conf = RTE_GRAPH_MODEL_DEFAULT;
 
+/* Use FIB instead of LPM for route lookup */
+static int lookup_fib_on;
+
 /* Lcore conf */
 struct lcore_conf {
 	uint16_t n_rx_queue;
@@ -317,7 +329,8 @@ print_usage(const char *prgname)
 		" [--max-pkt-len PKTLEN]"
 		" [--no-numa]"
 		" [--per-port-pool]"
-		" [--num-pkt-cap]\n\n"
+		" [--num-pkt-cap]"
+		" [--lookup NAME]\n\n"
 
 		"  -p PORTMASK: Hexadecimal bitmask of ports to configure\n"
 		"  -P : Enable promiscuous mode\n"
@@ -330,7 +343,8 @@ print_usage(const char *prgname)
 		"  --per-port-pool: Use separate buffer pool per port\n"
 		"  --pcap-enable: Enables pcap capture\n"
 		"  --pcap-num-cap NUMPKT: Number of packets to capture\n"
-		"  --pcap-file-name NAME: Pcap file name\n\n",
+		"  --pcap-file-name NAME: Pcap file name\n"
+		"  --lookup NAME: route lookup method, fib or lpm(by default)\n\n",
 		prgname);
 }
 
@@ -502,6 +516,7 @@ static const char short_options[] = "p:" /* portmask */
 #define CMD_LINE_OPT_NUM_PKT_CAP   "pcap-num-cap"
 #define CMD_LINE_OPT_PCAP_FILENAME "pcap-file-name"
 #define CMD_LINE_OPT_WORKER_MODEL  "model"
+#define CMD_LINE_OPT_LOOKUP	   "lookup"
 
 enum {
 	/* Long options mapped to a short option */
@@ -519,6 +534,7 @@ enum {
 	CMD_LINE_OPT_PARSE_NUM_PKT_CAP,
 	CMD_LINE_OPT_PCAP_FILENAME_CAP,
 	CMD_LINE_OPT_WORKER_MODEL_TYPE,
+	CMD_LINE_OPT_LOOKUP_NUM,
 };
 
 static const struct option lgopts[] = {
@@ -531,6 +547,7 @@ static const struct option lgopts[] = {
 	{CMD_LINE_OPT_NUM_PKT_CAP, 1, 0, CMD_LINE_OPT_PARSE_NUM_PKT_CAP},
 	{CMD_LINE_OPT_PCAP_FILENAME, 1, 0, CMD_LINE_OPT_PCAP_FILENAME_CAP},
 	{CMD_LINE_OPT_WORKER_MODEL, 1, 0, CMD_LINE_OPT_WORKER_MODEL_TYPE},
+	{CMD_LINE_OPT_LOOKUP, 1, 0, CMD_LINE_OPT_LOOKUP_NUM},
 	{NULL, 0, 0, 0},
 };
 
@@ -627,6 +644,16 @@ parse_args(int argc, char **argv)
 			parse_worker_model(optarg);
 			break;
 
+		case CMD_LINE_OPT_LOOKUP_NUM:
+			if (strcmp(optarg, LOOKUP_METHOD_FIB) == 0) {
+				lookup_fib_on = 1;
+			} else if (strcmp(optarg, LOOKUP_METHOD_LPM) != 0) {
+				fprintf(stderr, "Invalid lookup method\n");
+				print_usage(prgname);
+				return -1;
+			}
+			break;
+
 		default:
 			print_usage(prgname);
 			return -1;
@@ -649,6 +676,49 @@ print_ethaddr(const char *name, const struct rte_ether_addr *eth_addr)
 	printf("%s%s", name, buf);
 }
 
+static void
+init_fib(void)
+{
+	struct rte_fib6_conf conf6;
+	struct rte_fib_conf conf;
+	uint32_t lcore_id;
+	int socketid, ret;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.type = RTE_FIB_DIR24_8;
+	conf.max_routes = IPV4_L3FWD_FIB_MAX_ROUTES;
+	conf.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	conf.dir24_8.num_tbl8 = IPV4_L3FWD_FIB_NUM_TBL8;
+
+	memset(&conf6, 0, sizeof(conf6));
+	conf6.type = RTE_FIB6_TRIE;
+	conf6.max_routes = IPV6_L3FWD_FIB_MAX_ROUTES;
+	conf6.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	conf6.trie.num_tbl8 = IPV6_L3FWD_FIB_NUM_TBL8;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (rte_lcore_is_enabled(lcore_id) == 0)
+			continue;
+
+		if (numa_on)
+			socketid = rte_lcore_to_socket_id(lcore_id);
+		else
+			socketid = 0;
+
+		ret = rte_node_ip4_fib_create(socketid, &conf);
+		if (ret < 0)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to create ip4 FIB on socket %d: err=%d\n",
+				 socketid, ret);
+
+		ret = rte_node_ip6_fib_create(socketid, &conf6);
+		if (ret < 0)
+			rte_exit(EXIT_FAILURE,
+				 "Unable to create ip6 FIB on socket %d: err=%d\n",
+				 socketid, ret);
+	}
+}
+
 static int
 init_mem(uint16_t portid, uint32_t nb_mbuf)
 {
@@ -1301,6 +1371,10 @@ main(int argc, char **argv)
 	graph_conf.num_pkt_to_capture = packet_to_capture;
 	graph_conf.pcap_filename = pcap_filename;
 
+	/* FIB tables must exist before the lookup node is initialized */
+	if (lookup_fib_on)
+		init_fib();
+
 	if (model_conf == RTE_GRAPH_MODEL_MCORE_DISPATCH)
 		graph_config_mcore_dispatch(graph_conf);
 	else
@@ -1333,10 +1407,16 @@ main(int argc, char **argv)
 			 ipv4_l3fwd_lpm_route_array[i].if_out);
 
 		/* Use route index 'i' as next hop id */
-		ret = rte_node_ip4_route_add(
-			ipv4_l3fwd_lpm_route_array[i].ip,
-			ipv4_l3fwd_lpm_route_array[i].depth, i,
-			RTE_NODE_IP4_LOOKUP_NEXT_REWRITE);
+		if (lookup_fib_on)
+			ret = rte_node_ip4_fib_route_add(
+				ipv4_l3fwd_lpm_route_array[i].ip,
+				ipv4_l3fwd_lpm_route_array[i].depth, i,
+				RTE_NODE_IP4_LOOKUP_NEXT_REWRITE);
+		else
+			ret = rte_node_ip4_route_add(
+				ipv4_l3fwd_lpm_route_array[i].ip,
+				ipv4_l3fwd_lpm_route_array[i].depth, i,
+				RTE_NODE_IP4_LOOKUP_NEXT_REWRITE);
 
 		if (ret < 0)
 			rte_exit(EXIT_FAILURE,
@@ -1377,9 +1457,14 @@ main(int argc, char **argv)
 			 ipv6_l3fwd_lpm_route_array[i].if_out);
 
 		/* Use route index 'i' as next hop id */
-		ret = rte_node_ip6_route_add(ipv6_l3fwd_lpm_route_array[i].ip,
-			ipv6_l3fwd_lpm_route_array[i].depth, i,
-			RTE_NODE_IP6_LOOKUP_NEXT_REWRITE);
+		if (lookup_fib_on)
+			ret = rte_node_ip6_fib_route_add(ipv6_l3fwd_lpm_route_array[i].ip,
+				ipv6_l3fwd_lpm_route_array[i].depth, i,
+				RTE_NODE_IP6_LOOKUP_NEXT_REWRITE);
+		else
+			ret = rte_node_ip6_route_add(ipv6_l3fwd_lpm_route_array[i].ip,
+				ipv6_l3fwd_lpm_route_array[i].depth, i,
+				RTE_NODE_IP6_LOOKUP_NEXT_REWRITE);
 
 		if (ret < 0)
 			rte_exit(EXIT_FAILURE,
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_debug.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
@@ -218,7 +219,7 @@ graph_node_fini(struct graph *graph)
 }
 
 static struct rte_graph *
-graph_mem_fixup_node_ctx(struct rte_graph *graph)
+graph_mem_fixup_node_ctx(struct rte_graph *graph, bool pcap)
 {
 	struct rte_node *node;
 	struct node *node_db;
@@ -236,7 +237,7 @@ graph_mem_fixup_node_ctx(struct rte_graph *graph)
 		if (node_db == NULL)
 			SET_ERR_JMP(ENOLINK, fail, "Node %s not found", name);
 
-		if (graph->pcap_enable) {
+		if (pcap) {
 			node->process = graph_pcap_dispatch;
 			node->original_process = node_db->process;
 		} else
@@ -251,13 +252,16 @@ graph_mem_fixup_node_ctx(struct rte_graph *graph)
 static struct rte_graph *
 graph_mem_fixup_secondary(struct rte_graph *graph)
 {
+	bool pcap = false;
+
 	if (graph == NULL || rte_eal_process_type() == RTE_PROC_PRIMARY)
 		return graph;
 
-	if (graph_pcap_file_open(graph->pcap_filename) || graph_pcap_mp_init())
-		graph_pcap_exit(graph);
+	/* Walk without capture when the process can't capture */
+	if (graph->pcap_enable && graph_pcap_secondary_init(graph) == 0)
+		pcap = true;
 
-	return graph_mem_fixup_node_ctx(graph);
+	return graph_mem_fixup_node_ctx(graph, pcap);
 }
 
 static bool
@@ -321,6 +325,88 @@ rte_graph_model_mcore_dispatch_core_unbind(rte_graph_t id)
 	return;
 }
 
+int
+rte_graph_model_rtc_coalesce_set(rte_graph_t id, uint16_t thresh,
+				 uint16_t max_walks, uint64_t max_ns)
+{
+	uint64_t hz = rte_get_tsc_hz();
+	struct rte_node *node;
+	struct graph *graph;
+	rte_graph_off_t off;
+	rte_node_t count;
+
+	GRAPH_ID_CHECK(id);
+	if (thresh && max_walks == 0 && max_ns == 0)
+		SET_ERR_JMP(EINVAL, fail, "Unbounded coalescing");
+
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id)
+			break;
+	if (graph == NULL)
+		SET_ERR_JMP(ENOENT, fail, "Graph %u not found", id);
+
+	if (graph->graph->model != RTE_GRAPH_MODEL_RTC)
+		SET_ERR_JMP(ENOTSUP, fail, "Graph %s is not in rtc model", graph->name);
+
+	/* Drop the deferral state left over from the last time it was enabled */
+	if (graph->graph->coalesce.thresh == 0 && thresh) {
+		rte_graph_foreach_node(count, off, graph->graph, node)
+			memset(&__rte_node_ext(node)->coalesce, 0,
+			       sizeof(__rte_node_ext(node)->coalesce));
+		rte_smp_wmb();
+	}
+
+	graph->graph->coalesce.max_walks = max_walks;
+	graph->graph->coalesce.max_cycles = (max_ns / NS_PER_S) * hz +
+		((max_ns % NS_PER_S) * hz) / NS_PER_S;
+	graph->graph->coalesce.thresh = thresh;
+
+	return 0;
+
+fail:
+	return -rte_errno;
+}
+
+int
+rte_graph_stats_hist_enable(rte_graph_t id, bool enable)
+{
+	struct rte_node *node;
+	struct graph *graph;
+	rte_graph_off_t off;
+	rte_node_t count;
+
+	GRAPH_ID_CHECK(id);
+	if (!rte_graph_has_stats_feature())
+		SET_ERR_JMP(ENOTSUP, fail, "Stats feature is not enabled");
+
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id)
+			break;
+	if (graph == NULL)
+		SET_ERR_JMP(ENOENT, fail, "Graph %u not found", id);
+
+	/* Only pay for the histograms of the graphs using them */
+	if (enable && graph->hist == NULL) {
+		graph->hist = rte_zmalloc_socket(NULL,
+			sizeof(struct rte_node_hist) * graph->node_count,
+			RTE_CACHE_LINE_SIZE, graph->socket);
+		if (graph->hist == NULL)
+			SET_ERR_JMP(ENOMEM, fail, "Failed to alloc %s histograms",
+				    graph->name);
+		rte_graph_foreach_node(count, off, graph->graph, node)
+			__rte_node_ext(node)->hist = &graph->hist[count];
+		/* Make the histograms visible before the walk uses them */
+		rte_smp_wmb();
+	}
+
+	graph->graph->hist = enable;
+
+	return 0;
+
+fail:
+	return -rte_errno;
+}
+
 struct rte_graph *
 rte_graph_lookup(const char *name)
 {
@@ -455,6 +541,9 @@ rte_graph_destroy(rte_graph_t id)
 			if (rte_graph_worker_model_get(graph->graph) ==
 			    RTE_GRAPH_MODEL_MCORE_DISPATCH)
 				graph_sched_wq_destroy(graph);
+			else if (rte_graph_worker_model_get(graph->graph) ==
+				 RTE_GRAPH_MODEL_WORK_STEAL)
+				graph_steal_wq_destroy(graph);
 
 			/* Call fini() of the all the nodes in the graph */
 			graph_node_fini(graph);
@@ -534,6 +623,11 @@ graph_clone(struct graph *parent_graph, const char *name, struct rte_graph_param
 	    graph_sched_wq_create(graph, parent_graph, prm))
 		goto graph_mem_destroy;
 
+	/* Create the graph steal work queue and join the steal group */
+	if (rte_graph_worker_model_get(graph->graph) == RTE_GRAPH_MODEL_WORK_STEAL &&
+	    graph_steal_wq_create(graph, parent_graph, prm))
+		goto graph_mem_destroy;
+
 	/* Call init() of the all the nodes in the graph */
 	if (graph_node_init(graph))
 		goto graph_mem_destroy;
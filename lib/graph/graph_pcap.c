@@ -7,9 +7,14 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <rte_cycles.h>
 #include <rte_ethdev.h>
 #include <rte_mbuf.h>
 #include <rte_pcapng.h>
+#include <rte_ring.h>
+#include <rte_spinlock.h>
+#include <rte_stdatomic.h>
+#include <rte_thread.h>
 
 #include "rte_graph_worker.h"
 
@@ -19,12 +24,28 @@
 #define GRAPH_PCAP_NUM_PACKETS	1024
 #define GRAPH_PCAP_PKT_POOL	"graph_pcap_pkt_pool"
 #define GRAPH_PCAP_FILE_NAME	"dpdk_graph_pcap_capture_XXXXXX.pcapng"
+#define GRAPH_PCAP_RING_SZ	1024
+#define GRAPH_PCAP_WRITE_BURST	32
+#define GRAPH_PCAP_IDLE_US	100
+
+/* Capture ring of a graph, drained by the writer thread. */
+struct graph_pcap_ring {
+	struct rte_graph *graph;
+	struct rte_ring *ring;
+};
 
 /* For multi-process, packets are captured in separate files. */
 static rte_pcapng_t *pcapng_fd;
 static bool pcap_enable;
 struct rte_mempool *pkt_mp;
 
+/* Writer thread state, local to the process owning the capture file. */
+static rte_thread_t pcap_writer;
+static RTE_ATOMIC(bool) pcap_writer_run;
+static rte_spinlock_t pcap_rings_lock = RTE_SPINLOCK_INITIALIZER;
+static struct graph_pcap_ring *pcap_rings;
+static unsigned int pcap_nb_rings;
+
 void
 graph_pcap_enable(bool val)
 {
@@ -37,20 +58,174 @@ graph_pcap_is_enable(void)
 	return pcap_enable;
 }
 
-void
-graph_pcap_exit(struct rte_graph *graph)
+static unsigned int
+graph_pcap_ring_drain(struct rte_ring *ring)
+{
+	struct rte_mbuf *pkts[GRAPH_PCAP_WRITE_BURST];
+	unsigned int n;
+
+	n = rte_ring_sc_dequeue_burst(ring, (void **)pkts, RTE_DIM(pkts), NULL);
+	if (n == 0)
+		return 0;
+
+	if (rte_pcapng_write_packets(pcapng_fd, pkts, n) < 0)
+		graph_err("Graph pcap write failed.");
+	rte_pktmbuf_free_bulk(pkts, n);
+
+	return n;
+}
+
+static uint32_t
+graph_pcap_writer_main(void *arg)
+{
+	unsigned int i, nb_pkts;
+
+	RTE_SET_USED(arg);
+
+	while (rte_atomic_load_explicit(&pcap_writer_run, rte_memory_order_acquire)) {
+		nb_pkts = 0;
+		rte_spinlock_lock(&pcap_rings_lock);
+		for (i = 0; i < pcap_nb_rings; i++)
+			nb_pkts += graph_pcap_ring_drain(pcap_rings[i].ring);
+		rte_spinlock_unlock(&pcap_rings_lock);
+
+		if (nb_pkts == 0)
+			rte_delay_us_sleep(GRAPH_PCAP_IDLE_US);
+	}
+
+	return 0;
+}
+
+static int
+graph_pcap_ring_init(struct rte_graph *graph)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct graph_pcap_ring *rings;
+	struct rte_ring *ring;
+	int rc;
+
+	/* Graph memory is shared, keep ring names unique per process. */
+	snprintf(name, sizeof(name), "graph_pcap_%d_%u", getpid(), graph->id);
+	ring = rte_ring_create(name, GRAPH_PCAP_RING_SZ, graph->socket,
+			       RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (ring == NULL) {
+		graph_err("Cannot create pcap ring for graph %s.", graph->name);
+		return -1;
+	}
+
+	rte_spinlock_lock(&pcap_rings_lock);
+	rings = realloc(pcap_rings, (pcap_nb_rings + 1) * sizeof(*rings));
+	if (rings == NULL) {
+		rte_spinlock_unlock(&pcap_rings_lock);
+		rte_ring_free(ring);
+		return -1;
+	}
+	pcap_rings = rings;
+	pcap_rings[pcap_nb_rings].graph = graph;
+	pcap_rings[pcap_nb_rings].ring = ring;
+	pcap_nb_rings++;
+	rte_spinlock_unlock(&pcap_rings_lock);
+
+	graph->pcap_ring = ring;
+
+	if (rte_atomic_load_explicit(&pcap_writer_run, rte_memory_order_relaxed))
+		return 0;
+
+	rte_atomic_store_explicit(&pcap_writer_run, true, rte_memory_order_release);
+	rc = rte_thread_create_internal_control(&pcap_writer, "graph-pcap",
+						graph_pcap_writer_main, NULL);
+	if (rc != 0) {
+		rte_atomic_store_explicit(&pcap_writer_run, false,
+					  rte_memory_order_relaxed);
+		graph_err("Cannot create graph pcap writer thread: %d", rc);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void
+graph_pcap_ring_fini(struct rte_graph *graph)
+{
+	struct rte_ring *ring = NULL;
+	unsigned int i;
+
+	rte_spinlock_lock(&pcap_rings_lock);
+	for (i = 0; i < pcap_nb_rings; i++) {
+		if (pcap_rings[i].graph != graph)
+			continue;
+		ring = pcap_rings[i].ring;
+		pcap_rings[i] = pcap_rings[--pcap_nb_rings];
+		break;
+	}
+	rte_spinlock_unlock(&pcap_rings_lock);
+
+	if (ring == NULL)
+		return;
+
+	/* The graph is no longer walked, flush what is left in its ring. */
+	while (graph_pcap_ring_drain(ring))
+		;
+	rte_ring_free(ring);
+	graph->pcap_ring = NULL;
+}
+
+static struct rte_ring *
+graph_pcap_ring_lookup(struct rte_graph *graph)
+{
+	struct rte_ring *ring = NULL;
+	unsigned int i;
+
+	rte_spinlock_lock(&pcap_rings_lock);
+	for (i = 0; i < pcap_nb_rings; i++) {
+		if (pcap_rings[i].graph == graph) {
+			ring = pcap_rings[i].ring;
+			break;
+		}
+	}
+	rte_spinlock_unlock(&pcap_rings_lock);
+
+	return ring;
+}
+
+/* Release the capture resources of the process, graph memory is untouched. */
+static void
+graph_pcap_release(struct rte_graph *graph)
 {
-	if (rte_eal_process_type() == RTE_PROC_PRIMARY)
+	graph_pcap_ring_fini(graph);
+
+	/* Capture resources are shared by all the graphs of the process. */
+	if (pcap_nb_rings)
+		return;
+
+	if (rte_atomic_load_explicit(&pcap_writer_run, rte_memory_order_relaxed)) {
+		rte_atomic_store_explicit(&pcap_writer_run, false,
+					  rte_memory_order_release);
+		rte_thread_join(pcap_writer, NULL);
+	}
+	free(pcap_rings);
+	pcap_rings = NULL;
+
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
 		rte_mempool_free(pkt_mp);
+		pkt_mp = NULL;
+	}
 
 	if (pcapng_fd) {
 		rte_pcapng_close(pcapng_fd);
 		pcapng_fd = NULL;
 	}
 
+	graph_pcap_enable(0);
+}
+
+void
+graph_pcap_exit(struct rte_graph *graph)
+{
+	graph_pcap_release(graph);
+
 	/* Disable pcap. */
 	graph->pcap_enable = 0;
-	graph_pcap_enable(0);
 }
 
 static int
@@ -144,9 +319,10 @@ graph_pcap_mp_init(void)
 	if (pkt_mp)
 		goto done;
 
-	/* Make a pool for cloned packets */
+	/* Make a pool for cloned packets, a full ring plus bursts in flight. */
 	pkt_mp = rte_pktmbuf_pool_create_by_ops(GRAPH_PCAP_PKT_POOL,
-			IOV_MAX + RTE_GRAPH_BURST_SIZE,	0, 0,
+			GRAPH_PCAP_RING_SZ + GRAPH_PCAP_WRITE_BURST +
+			RTE_GRAPH_BURST_SIZE, 0, 0,
 			rte_pcapng_mbuf_size(RTE_MBUF_DEFAULT_BUF_SIZE),
 			SOCKET_ID_ANY, "ring_mp_mc");
 	if (pkt_mp == NULL) {
@@ -158,6 +334,23 @@ graph_pcap_mp_init(void)
 	return 0;
 }
 
+int
+graph_pcap_secondary_init(struct rte_graph *graph)
+{
+	/* The graph may be looked up several times by the process. */
+	if (graph_pcap_ring_lookup(graph) != NULL)
+		return 0;
+
+	/* The capture is still enabled for the other processes. */
+	if (graph_pcap_file_open(graph->pcap_filename) < 0 ||
+	    graph_pcap_mp_init() < 0 || graph_pcap_ring_init(graph) < 0) {
+		graph_pcap_release(graph);
+		return -1;
+	}
+
+	return 0;
+}
+
 int
 graph_pcap_init(struct graph *graph)
 {
@@ -169,6 +362,9 @@ graph_pcap_init(struct graph *graph)
 	if (graph_pcap_mp_init() < 0)
 		goto error;
 
+	if (graph_pcap_ring_init(graph_data) < 0)
+		goto error;
+
 	/* User configured number of packets to capture. */
 	if (graph->num_pkt_to_capture)
 		graph_data->nb_pkt_to_capture = graph->num_pkt_to_capture;
@@ -197,7 +393,7 @@ graph_pcap_dispatch(struct rte_graph *graph,
 	char buffer[GRAPH_PCAP_BUF_SZ];
 	uint64_t i, num_packets;
 	struct rte_mbuf *mbuf;
-	ssize_t len;
+	unsigned int n;
 
 	if (!nb_objs || (graph->nb_pkt_captured >= graph->nb_pkt_to_capture))
 		goto done;
@@ -221,13 +417,14 @@ graph_pcap_dispatch(struct rte_graph *graph,
 		mbuf_clones[i] = mc;
 	}
 
-	/* write it to capture file */
-	len = rte_pcapng_write_packets(pcapng_fd, mbuf_clones, i);
-	rte_pktmbuf_free_bulk(mbuf_clones, i);
-	if (len <= 0)
-		goto done;
+	/* Hand the copies to the writer thread, drop what does not fit. */
+	n = rte_ring_sp_enqueue_burst(graph->pcap_ring, (void **)mbuf_clones,
+				      i, NULL);
+	if (unlikely(n < i))
+		rte_pktmbuf_free_bulk(&mbuf_clones[n], i - n);
 
-	graph->nb_pkt_captured += i;
+	graph->nb_pkt_dropped += num_packets - n;
+	graph->nb_pkt_captured += n;
 
 done:
 	return node->original_process(graph, node, objs, nb_objs);
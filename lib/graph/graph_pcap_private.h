@@ -68,8 +68,8 @@ int graph_pcap_file_open(const char *filename);
  * Initialise graph pcap trace functionality.
  *
  * The function invoked when the graph pcap trace is enabled. This function
- * open's pcap file and allocates mempool. Information needed for secondary
- * process is populated.
+ * open's pcap file, allocates mempool and creates the graph capture ring.
+ * Information needed for secondary process is populated.
  *
  * @param graph
  *   Pointer to graph structure.
@@ -79,13 +79,35 @@ int graph_pcap_file_open(const char *filename);
  */
 int graph_pcap_init(struct graph *graph);
 
+/**
+ * @internal
+ *
+ * Initialise graph pcap trace functionality in a secondary process.
+ *
+ * The function invoked when a secondary process looks up a graph with pcap
+ * trace enabled. It opens the process's own pcap file, looks up the mempool
+ * and creates the graph's capture ring drained by the writer thread.
+ * Nothing is done if the process already captures the graph. On failure,
+ * the process releases what it set up and the graph's pcap_enable shared
+ * with the other processes is left untouched.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ *
+ * @return
+ *   0 on success and -1 on failure.
+ */
+int graph_pcap_secondary_init(struct rte_graph *graph);
+
 /**
  * @internal
  *
  * Exit graph pcap trace functionality.
  *
- * The function is called to exit graph pcap trace and close open fd's and
- * free up memory. Pcap trace is also disabled.
+ * The function is called to exit graph pcap trace of the graph. Packets left
+ * in its capture ring are written out and the ring is freed. Once no graph
+ * captures anymore, the writer thread is stopped, open fd's are closed and
+ * memory is freed. Pcap trace is also disabled.
  *
  * @param graph
  *   Pointer to graph structure.
@@ -98,7 +120,9 @@ void graph_pcap_exit(struct rte_graph *graph);
  * Capture mbuf metadata and node metadata to a pcap file.
  *
  * When graph pcap trace enabled, this function is invoked prior to each node
- * and mbuf, node metadata is parsed and captured in a pcap file.
+ * and mbuf, node metadata is copied and enqueued to the graph's capture ring.
+ * The copies are written to the pcap file by the writer thread; the ones
+ * not fitting in the ring are dropped.
  *
  * @param graph
  *   Pointer to the graph object.
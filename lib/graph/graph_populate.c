@@ -38,6 +38,9 @@ graph_fp_mem_calc_size(struct graph *graph)
 		sz += sizeof(struct rte_node);
 		/* Pointer to next nodes(edges) */
 		sz += sizeof(struct rte_node *) * graph_node->node->nb_edges;
+		/* Extended node data */
+		sz = RTE_ALIGN(sz, RTE_CACHE_LINE_SIZE);
+		sz += sizeof(struct rte_node_ext);
 	}
 
 	graph->mem_sz = sz;
@@ -101,6 +104,9 @@ graph_nodes_populate(struct graph *_graph)
 
 		off += sizeof(struct rte_node *) * nb_edges;
 		off = RTE_ALIGN(off, RTE_CACHE_LINE_SIZE);
+		RTE_ASSERT(RTE_PTR_ADD(graph, off) == __rte_node_ext(node));
+		memset(__rte_node_ext(node), 0, sizeof(struct rte_node_ext));
+		off += sizeof(struct rte_node_ext);
 		node->next = off;
 		__rte_node_stream_alloc(graph, node);
 	}
@@ -239,5 +245,6 @@ graph_fp_mem_destroy(struct graph *graph)
 		graph_pcap_exit(graph->graph);
 
 	graph_nodes_mem_destroy(graph->graph);
+	rte_free(graph->hist);
 	return rte_memzone_free(graph->mz);
 }
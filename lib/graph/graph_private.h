@@ -55,6 +55,10 @@ struct node {
 	uint64_t flags;		      /**< Node configuration flag. */
 	unsigned int lcore_id;
 	/**< Node runs on the Lcore ID used for mcore dispatch model. */
+	bool steal;
+	/**< Node streams can be stolen, used for work steal model. */
+	rte_node_affinity_key_t steal_key;
+	/**< Flow affinity key of the node objects, used for work steal model. */
 	rte_node_process_t process;   /**< Node process function. */
 	rte_node_init_t init;         /**< Node init function. */
 	rte_node_fini_t fini;	      /**< Node fini function. */
@@ -76,6 +80,19 @@ struct graph_mcore_dispatch_wq_node {
 	void *objs[RTE_GRAPH_BURST_SIZE];
 } __rte_cache_aligned;
 
+/**
+ * @internal
+ *
+ * Structure that holds a node stream offered to the steal group.
+ * Used for work steal model.
+ */
+struct graph_work_steal_wq_node {
+	rte_graph_off_t node_off;
+	uint16_t nb_objs;
+	uint16_t lanes; /**< Flow lanes of the objects. */
+	void *objs[RTE_GRAPH_BURST_SIZE];
+} __rte_cache_aligned;
+
 /**
  * @internal
  *
@@ -126,6 +143,8 @@ struct graph {
 	/**< Number of packets to be captured per core. */
 	char pcap_filename[RTE_GRAPH_PCAP_FILE_SZ];
 	/**< pcap file name/path. */
+	struct rte_node_hist *hist;
+	/**< Stats histograms of the nodes, allocated when first enabled. */
 	STAILQ_HEAD(gnode_list, graph_node) node_list;
 	/**< Nodes in a graph. */
 };
@@ -445,4 +464,35 @@ int graph_sched_wq_create(struct graph *_graph, struct graph *_parent_graph,
  */
 void graph_sched_wq_destroy(struct graph *_graph);
 
+/**
+ * @internal
+ *
+ * Create the graph steal work queue for work steal model and join the steal
+ * group of the parent graph.
+ *
+ * @param _graph
+ *   The graph object
+ * @param _parent_graph
+ *   The parent graph object which holds the steal group head.
+ * @param prm
+ *   Graph parameter, includes model-specific parameters in this graph.
+ *
+ * @return
+ *   - 0: Success.
+ *   - <0: Graph steal work queue related error.
+ */
+int graph_steal_wq_create(struct graph *_graph, struct graph *_parent_graph,
+			  struct rte_graph_param *prm);
+
+/**
+ * @internal
+ *
+ * Destroy the graph steal work queue for work steal model and leave the
+ * steal group.
+ *
+ * @param _graph
+ *   The graph object
+ */
+void graph_steal_wq_destroy(struct graph *_graph);
+
 #endif /* _RTE_GRAPH_PRIVATE_H_ */
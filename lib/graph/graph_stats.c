@@ -9,6 +9,7 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_telemetry.h>
 
 #include "graph_private.h"
 
@@ -46,6 +47,12 @@ struct rte_graph_cluster_stats {
 		   "---------------+---------------+-" \
 		   "----------+\n")
 
+#define boarder_model_steal()                                                                 \
+	fprintf(f, "+-------------------------------+---------------+--------" \
+		   "-------+---------------+---------------+---------------+" \
+		   "---------------+---------------+---------------+-" \
+		   "----------+\n")
+
 #define boarder()                                                              \
 	fprintf(f, "+-------------------------------+---------------+--------" \
 		   "-------+---------------+---------------+---------------+-" \
@@ -73,12 +80,28 @@ print_banner_dispatch(FILE *f)
 	boarder_model_dispatch();
 }
 
+static inline void
+print_banner_steal(FILE *f)
+{
+	boarder_model_steal();
+	fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-16s%-16s%-16s%-16s\n",
+		"|Node", "|calls",
+		"|objs", "|offload objs", "|stolen objs", "|offload fail",
+		"|realloc_count", "|objs/call", "|objs/sec(10E6)",
+		"|cycles/call|");
+	boarder_model_steal();
+}
+
 static inline void
 print_banner(FILE *f)
 {
-	if (rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph) ==
-	    RTE_GRAPH_MODEL_MCORE_DISPATCH)
+	int model;
+
+	model = rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph);
+	if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH)
 		print_banner_dispatch(f);
+	else if (model == RTE_GRAPH_MODEL_WORK_STEAL)
+		print_banner_steal(f);
 	else
 		print_banner_default(f);
 }
@@ -93,6 +116,7 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 	const uint64_t calls = stat->calls;
 	const uint64_t objs = stat->objs;
 	uint64_t call_delta;
+	int model;
 
 	call_delta = calls - prev_calls;
 	objs_per_call =
@@ -103,9 +127,9 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 	ts_per_hz = (double)((stat->ts - stat->prev_ts) / stat->hz);
 	objs_per_sec = ts_per_hz ? (objs - prev_objs) / ts_per_hz : 0;
 	objs_per_sec /= 1000000;
+	model = rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph);
 
-	if (rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph) ==
-	    RTE_GRAPH_MODEL_MCORE_DISPATCH) {
+	if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH) {
 		fprintf(f,
 			"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
 			"|%-15" PRIu64 "|%-15" PRIu64
@@ -113,6 +137,15 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 			stat->name, calls, objs, stat->dispatch.sched_objs,
 			stat->dispatch.sched_fail, stat->realloc_count, objs_per_call,
 			objs_per_sec, cycles_per_call);
+	} else if (model == RTE_GRAPH_MODEL_WORK_STEAL) {
+		fprintf(f,
+			"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
+			"|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
+			"|%-15.3f|%-15.6f|%-11.4f|\n",
+			stat->name, calls, objs, stat->steal.offload_objs,
+			stat->steal.stolen_objs, stat->steal.offload_fail,
+			stat->realloc_count, objs_per_call, objs_per_sec,
+			cycles_per_call);
 	} else {
 		fprintf(f,
 			"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
@@ -138,6 +171,8 @@ graph_cluster_stats_cb(bool is_first, bool is_last, void *cookie,
 	if (unlikely(is_last)) {
 		if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH)
 			boarder_model_dispatch();
+		else if (model == RTE_GRAPH_MODEL_WORK_STEAL)
+			boarder_model_steal();
 		else
 			boarder();
 	}
@@ -379,18 +414,36 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 {
 	uint64_t calls = 0, cycles = 0, objs = 0, realloc_count = 0;
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
+	uint64_t offload_objs = 0, stolen_objs = 0, offload_fail = 0;
 	uint64_t sched_objs = 0, sched_fail = 0;
+	struct rte_node_ext *ext;
 	struct rte_node *node;
 	rte_node_t count;
+	unsigned int i;
 	int model;
 
+	memset(stat->hist_objs, 0, sizeof(stat->hist_objs));
+	memset(stat->hist_cycles, 0, sizeof(stat->hist_cycles));
+	memset(stat->hist_cycles_per_obj, 0, sizeof(stat->hist_cycles_per_obj));
+
 	model = rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph);
 	for (count = 0; count < cluster->nb_nodes; count++) {
 		node = cluster->nodes[count];
+		ext = __rte_node_ext(node);
+
+		for (i = 0; ext->hist != NULL && i < RTE_GRAPH_HIST_BUCKETS; i++) {
+			stat->hist_objs[i] += ext->hist->objs[i];
+			stat->hist_cycles[i] += ext->hist->cycles[i];
+			stat->hist_cycles_per_obj[i] += ext->hist->cycles_per_obj[i];
+		}
 
 		if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH) {
 			sched_objs += node->dispatch.total_sched_objs;
 			sched_fail += node->dispatch.total_sched_fail;
+		} else if (model == RTE_GRAPH_MODEL_WORK_STEAL) {
+			offload_objs += ext->steal.total_offload_objs;
+			stolen_objs += ext->steal.total_stolen_objs;
+			offload_fail += ext->steal.total_offload_fail;
 		}
 
 		calls += node->total_calls;
@@ -406,6 +459,10 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH) {
 		stat->dispatch.sched_objs = sched_objs;
 		stat->dispatch.sched_fail = sched_fail;
+	} else if (model == RTE_GRAPH_MODEL_WORK_STEAL) {
+		stat->steal.offload_objs = offload_objs;
+		stat->steal.stolen_objs = stolen_objs;
+		stat->steal.offload_fail = offload_fail;
 	}
 
 	stat->ts = rte_get_timer_cycles();
@@ -464,6 +521,90 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		memset(node->hist_objs, 0, sizeof(node->hist_objs));
+		memset(node->hist_cycles, 0, sizeof(node->hist_cycles));
+		memset(node->hist_cycles_per_obj, 0, sizeof(node->hist_cycles_per_obj));
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+static struct rte_tel_data *
+graph_hist_to_tel(const uint64_t *hist)
+{
+	struct rte_tel_data *d;
+	unsigned int i;
+
+	d = rte_tel_data_alloc();
+	if (d == NULL)
+		return NULL;
+
+	rte_tel_data_start_array(d, RTE_TEL_UINT_VAL);
+	for (i = 0; i < RTE_GRAPH_HIST_BUCKETS; i++)
+		rte_tel_data_add_array_uint(d, hist[i]);
+
+	return d;
+}
+
+static int
+graph_handle_node_hist(const char *cmd __rte_unused, const char *params,
+		       struct rte_tel_data *d)
+{
+	struct rte_tel_data *node_hist, *objs, *cycles, *cycles_per_obj;
+	struct rte_node_hist *hist;
+	struct graph *graph;
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+	int rc = -EINVAL;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	graph_spinlock_lock();
+
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		if (strncmp(graph->name, params, RTE_GRAPH_NAMESIZE) == 0)
+			break;
+	if (graph == NULL)
+		goto unlock;
+
+	rte_tel_data_start_dict(d);
+	rte_graph_foreach_node(count, off, graph->graph, node) {
+		/* Histograms were never enabled on the graph */
+		hist = __rte_node_ext(node)->hist;
+		if (hist == NULL)
+			break;
+
+		node_hist = rte_tel_data_alloc();
+		objs = graph_hist_to_tel(hist->objs);
+		cycles = graph_hist_to_tel(hist->cycles);
+		cycles_per_obj = graph_hist_to_tel(hist->cycles_per_obj);
+		if (node_hist == NULL || objs == NULL || cycles == NULL ||
+		    cycles_per_obj == NULL) {
+			rte_tel_data_free(node_hist);
+			rte_tel_data_free(objs);
+			rte_tel_data_free(cycles);
+			rte_tel_data_free(cycles_per_obj);
+			rc = -ENOMEM;
+			goto unlock;
+		}
+
+		rte_tel_data_start_dict(node_hist);
+		rte_tel_data_add_dict_container(node_hist, "objs_per_call", objs, 0);
+		rte_tel_data_add_dict_container(node_hist, "cycles_per_call", cycles, 0);
+		rte_tel_data_add_dict_container(node_hist, "cycles_per_obj",
+						cycles_per_obj, 0);
+		rte_tel_data_add_dict_container(d, node->name, node_hist, 0);
+	}
+	rc = 0;
+
+unlock:
+	graph_spinlock_unlock();
+	return rc;
+}
+
+RTE_INIT(graph_stats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/node_hist", graph_handle_node_hist,
+		"Returns the per node stats histograms of a graph. Parameters: graph name");
+}
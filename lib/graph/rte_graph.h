@@ -22,6 +22,7 @@
 #include <stdio.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +65,18 @@ typedef uint16_t rte_graph_t;      /**< Graph id type. */
 #error "Unsupported burst size"
 #endif
 
+/**
+ * Number of log2 buckets of the per node stats histograms.
+ *
+ * Bucket 0 counts the zero values and bucket i the values in
+ * [2^(i - 1), 2^i), the last bucket collecting all the larger values.
+ * The cycles per call histogram is scaled down by
+ * RTE_GRAPH_HIST_CYCLES_SHIFT so that bucket 0 holds the calls shorter
+ * than 2^RTE_GRAPH_HIST_CYCLES_SHIFT cycles.
+ */
+#define RTE_GRAPH_HIST_BUCKETS 16U
+#define RTE_GRAPH_HIST_CYCLES_SHIFT 5 /**< Cycles per call histogram scale. */
+
 /* Forward declaration */
 struct rte_node;  /**< Node object */
 struct rte_graph; /**< Graph object */
@@ -129,6 +142,23 @@ typedef int (*rte_node_init_t)(const struct rte_graph *graph,
 typedef void (*rte_node_fini_t)(const struct rte_graph *graph,
 				struct rte_node *node);
 
+/**
+ * Node flow affinity key function.
+ *
+ * The function invoked by the work steal model on every object of a stream
+ * offered for stealing. Objects returning the same key are never processed
+ * concurrently nor out of order across the graphs of a steal group.
+ *
+ * @param obj
+ *   Pointer to the object.
+ *
+ * @return
+ *   Flow affinity key of the object.
+ *
+ * @see rte_graph_model_work_steal_node_enable()
+ */
+typedef uint32_t (*rte_node_affinity_key_t)(void *obj);
+
 /**
  * Graph cluster stats callback.
  *
@@ -171,6 +201,12 @@ struct rte_graph_param {
 			uint32_t wq_size_max; /**< Maximum size of workqueue for dispatch model. */
 			uint32_t mp_capacity; /**< Capacity of memory pool for dispatch model. */
 		} dispatch;
+		struct {
+			uint32_t wq_size_max; /**< Maximum size of steal queue for work steal model. */
+			uint16_t thresh;
+			/**< Objects of a stream kept by the graph before offering the rest. */
+			uint16_t max_batch; /**< Maximum streams stolen at once by an idle graph. */
+		} steal;
 	};
 };
 
@@ -218,6 +254,14 @@ struct rte_graph_cluster_node_stats {
 			uint64_t sched_fail;
 			/**< Previous number of failed schedule objs for dispatch model. */
 		} dispatch;
+		struct {
+			uint64_t offload_objs;
+			/**< Number of objs offered to other graphs for work steal model. */
+			uint64_t stolen_objs;
+			/**< Number of objs stolen from other graphs for work steal model. */
+			uint64_t offload_fail;
+			/**< Number of objs failed to be offered for work steal model. */
+		} steal;
 	};
 
 	uint64_t realloc_count; /**< Realloc count. */
@@ -225,6 +269,13 @@ struct rte_graph_cluster_node_stats {
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+
+	uint64_t hist_objs[RTE_GRAPH_HIST_BUCKETS];
+	/**< Histogram of objs per call, see rte_graph_stats_hist_enable(). */
+	uint64_t hist_cycles[RTE_GRAPH_HIST_BUCKETS];
+	/**< Histogram of cycles per call, see rte_graph_stats_hist_enable(). */
+	uint64_t hist_cycles_per_obj[RTE_GRAPH_HIST_BUCKETS];
+	/**< Histogram of cycles per obj, see rte_graph_stats_hist_enable(). */
 } __rte_cache_aligned;
 
 /**
@@ -332,6 +383,64 @@ int rte_graph_model_mcore_dispatch_core_bind(rte_graph_t id, int lcore);
  */
 void rte_graph_model_mcore_dispatch_core_unbind(rte_graph_t id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the pending streams coalescing policy of a graph for rtc model.
+ *
+ * A pending stream of less than thresh objects is not processed by the
+ * graph walk but deferred to the next walks so that it grows with the
+ * objects enqueued meanwhile, until it reaches thresh objects or it was
+ * deferred max_walks walks or max_ns nanoseconds. Trades a bounded latency
+ * for bigger bursts at low load. Source nodes are never deferred.
+ *
+ * May be called while the graph is walked, the new policy applies from
+ * the next walk. The policy is reset when the graph leaves rtc model.
+ *
+ * @param id
+ *   Graph id.
+ * @param thresh
+ *   Number of objects below which a pending stream is deferred,
+ *   0 to disable coalescing.
+ * @param max_walks
+ *   Maximum number of walks a stream is deferred, 0 for no walk bound.
+ * @param max_ns
+ *   Maximum nanoseconds a stream is deferred, 0 for no time bound.
+ *
+ * @return
+ *   0 on success, error otherwise. Enabling coalescing without any
+ *   bound is invalid, as is setting it on a graph not in rtc model.
+ */
+__rte_experimental
+int rte_graph_model_rtc_coalesce_set(rte_graph_t id, uint16_t thresh,
+				     uint16_t max_walks, uint64_t max_ns);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable the per node stats histograms of a graph.
+ *
+ * When enabled, every node process call of the graph accounts its number
+ * of objs, cycles and approximate cycles per obj in log2 histograms
+ * reported by rte_graph_cluster_stats_get() and telemetry. Requires the
+ * stats feature. The histograms memory is allocated on the first enable
+ * and kept until the graph is destroyed.
+ *
+ * @param id
+ *   Graph id.
+ * @param enable
+ *   True to collect the histograms, false to stop collecting them.
+ *
+ * @return
+ *   0 on success, error otherwise.
+ *
+ * @see RTE_GRAPH_HIST_BUCKETS
+ */
+__rte_experimental
+int rte_graph_stats_hist_enable(rte_graph_t id, bool enable);
+
 /**
  * Get graph object from its name.
  *
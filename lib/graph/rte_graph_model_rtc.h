@@ -5,6 +5,67 @@
 
 #include "rte_graph_worker_common.h"
 
+/**
+ * @internal
+ *
+ * Put the pending streams deferred by the coalescing policy back to the
+ * circular buffer at the end of the graph walk.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param nb_deferred
+ *   Number of streams deferred during the walk.
+ *
+ * @note
+ * This implementation is used by rtc model only and user application
+ * should not call it directly.
+ */
+void __rte_graph_rtc_coalesce_requeue(struct rte_graph *graph, uint16_t nb_deferred);
+
+/**
+ * @internal
+ *
+ * Check whether a pending stream is deferred by the coalescing policy.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object of the pending stream.
+ * @param now
+ *   Timestamp of the walk, read on first use.
+ *
+ * @return
+ *   True if the stream is deferred to a later walk, false otherwise.
+ */
+static __rte_always_inline bool
+__rte_graph_rtc_coalesce_defer(struct rte_graph *graph, struct rte_node *node,
+			       uint64_t *now)
+{
+	struct rte_node_ext *ext = __rte_node_ext(node);
+
+	if (node->idx >= graph->coalesce.thresh)
+		goto process;
+
+	if (*now == 0)
+		*now = rte_rdtsc();
+
+	if (ext->coalesce.walks == 0) {
+		ext->coalesce.start = *now;
+	} else if ((graph->coalesce.max_walks &&
+		    ext->coalesce.walks >= graph->coalesce.max_walks) ||
+		   (graph->coalesce.max_cycles &&
+		    *now - ext->coalesce.start >= graph->coalesce.max_cycles)) {
+		goto process;
+	}
+
+	ext->coalesce.walks++;
+	return true;
+
+process:
+	ext->coalesce.walks = 0;
+	return false;
+}
+
 /**
  * Perform graph walk on the circular buffer and invoke the process function
  * of the nodes and collect the stats.
@@ -20,7 +81,9 @@ rte_graph_walk_rtc(struct rte_graph *graph)
 	const rte_graph_off_t *cir_start = graph->cir_start;
 	const rte_node_t mask = graph->cir_mask;
 	uint32_t head = graph->head;
+	uint16_t nb_deferred = 0;
 	struct rte_node *node;
+	uint64_t now = 0;
 
 	/*
 	 * Walk on the source node(s) ((cir_start - head) -> cir_start) and then
@@ -36,11 +99,22 @@ rte_graph_walk_rtc(struct rte_graph *graph)
 	 *	| ... | <= pending streams
 	 *	|     |
 	 *	+-----+ <= cir_start + mask
+	 *
+	 * When coalescing is enabled, the pending streams smaller than the
+	 * threshold are skipped and put back to the circular buffer for the
+	 * next walk, up to the configured number of walks or cycles.
 	 */
 	while (likely(head != graph->tail)) {
 		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
-		__rte_node_process(graph, node);
+		if (unlikely(graph->coalesce.thresh) && (int32_t)head > 0 &&
+		    __rte_graph_rtc_coalesce_defer(graph, node, &now))
+			nb_deferred++;
+		else
+			__rte_node_process(graph, node);
 		head = likely((int32_t)head > 0) ? head & mask : head;
 	}
 	graph->tail = 0;
+
+	if (unlikely(nb_deferred))
+		__rte_graph_rtc_coalesce_requeue(graph, nb_deferred);
 }
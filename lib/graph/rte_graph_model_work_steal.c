@@ -0,0 +1,341 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include <rte_bitops.h>
+
+#include "graph_private.h"
+#include "rte_graph_model_work_steal.h"
+
+#define WQ_SZ 32
+
+int
+graph_steal_wq_create(struct graph *_graph, struct graph *_parent_graph,
+		      struct rte_graph_param *prm)
+{
+	struct rte_graph *parent_graph = _parent_graph->graph;
+	struct rte_graph *graph = _graph->graph;
+	unsigned int flags = RING_F_SP_ENQ | RING_F_SC_DEQ;
+	struct graph_node *graph_node;
+	struct rte_node_ext *ext;
+	unsigned int wq_size;
+
+	wq_size = RTE_GRAPH_STEAL_WQ_SIZE(graph->nb_nodes);
+	wq_size = rte_align32pow2(wq_size + 1);
+
+	if (prm->steal.wq_size_max > 0)
+		wq_size = wq_size <= (prm->steal.wq_size_max) ? wq_size :
+			prm->steal.wq_size_max;
+
+	if (!rte_is_power_of_2(wq_size))
+		flags |= RING_F_EXACT_SZ;
+
+	/* Only the owner offers and the consumers are serialized by the lock */
+	graph->steal.wq = rte_ring_create(graph->name, wq_size, graph->socket,
+					  flags);
+	if (graph->steal.wq == NULL)
+		SET_ERR_JMP(EIO, fail, "Failed to allocate graph steal WQ");
+
+	/* No more entries than the queue can hold, so offering never fails */
+	graph->steal.mp = rte_mempool_create(graph->name,
+					     rte_ring_get_capacity(graph->steal.wq),
+					     sizeof(struct graph_work_steal_wq_node),
+					     0, 0, NULL, NULL, NULL, NULL,
+					     graph->socket, MEMPOOL_F_SC_GET);
+	if (graph->steal.mp == NULL)
+		SET_ERR_JMP(EIO, fail_mp,
+			    "Failed to allocate graph steal WQ entry");
+
+	graph->steal.thresh = prm->steal.thresh ? prm->steal.thresh :
+		RTE_GRAPH_STEAL_THRESH_DEFAULT;
+	graph->steal.max_batch = prm->steal.max_batch ?
+		RTE_MIN(prm->steal.max_batch, WQ_SZ) :
+		RTE_GRAPH_STEAL_MAX_BATCH_DEFAULT;
+	graph->steal.victim = NULL;
+	rte_spinlock_init(&graph->steal.lock);
+
+	/* Switch the node schedule area of the clone to work steal model */
+	STAILQ_FOREACH(graph_node, &_graph->node_list, next) {
+		ext = __rte_node_ext(graph_node_id_to_ptr(graph, graph_node->node->id));
+		memset(&ext->steal, 0, sizeof(ext->steal));
+		ext->steal.enable = graph_node->node->steal;
+		ext->steal.key = graph_node->node->steal_key;
+	}
+
+	if (parent_graph->steal.rq == NULL) {
+		parent_graph->steal.rq = &parent_graph->steal.rq_head;
+		SLIST_INIT(parent_graph->steal.rq);
+	}
+
+	graph->steal.rq = parent_graph->steal.rq;
+	SLIST_INSERT_HEAD(graph->steal.rq, graph, next);
+
+	return 0;
+
+fail_mp:
+	rte_ring_free(graph->steal.wq);
+	graph->steal.wq = NULL;
+fail:
+	return -rte_errno;
+}
+
+void
+graph_steal_wq_destroy(struct graph *_graph)
+{
+	struct rte_graph *graph = _graph->graph;
+	struct rte_graph *peer;
+
+	if (graph == NULL)
+		return;
+
+	/* The parent graph holds the steal group head without being a member */
+	if (graph->steal.rq != NULL && graph->steal.wq != NULL) {
+		SLIST_REMOVE(graph->steal.rq, graph, rte_graph, next);
+		SLIST_FOREACH(peer, graph->steal.rq, next)
+			if (peer->steal.victim == graph)
+				peer->steal.victim = NULL;
+	}
+	graph->steal.rq = NULL;
+
+	rte_ring_free(graph->steal.wq);
+	graph->steal.wq = NULL;
+
+	rte_mempool_free(graph->steal.mp);
+	graph->steal.mp = NULL;
+}
+
+static __rte_always_inline void
+graph_steal_wq_node_offer(struct rte_graph *graph, struct rte_node_ext *ext,
+			  struct graph_work_steal_wq_node *wq_node)
+{
+	uint32_t lanes = wq_node->lanes;
+	unsigned int lane;
+
+	while (lanes) {
+		lane = rte_ctz32(lanes);
+		lanes &= lanes - 1;
+		rte_atomic_fetch_add_explicit(&ext->steal.lane_inflight[lane], 1,
+					      rte_memory_order_relaxed);
+	}
+
+	ext->steal.total_offload_objs += wq_node->nb_objs;
+
+	/* Enqueue publishes the lane updates above to the consumers */
+	RTE_VERIFY(rte_ring_sp_enqueue_elem(graph->steal.wq, &wq_node,
+					    sizeof(wq_node)) == 0);
+}
+
+void __rte_noinline
+__rte_graph_work_steal_node_offload(struct rte_graph *graph, struct rte_node *node)
+{
+	struct rte_node_ext *ext = __rte_node_ext(node);
+	const rte_node_affinity_key_t key = ext->steal.key;
+	struct graph_work_steal_wq_node *wq_node = NULL;
+	const uint16_t thresh = graph->steal.thresh;
+	const uint16_t nb_objs = node->idx;
+	uint32_t lanes_busy = 0, lanes_local = 0;
+	void **objs = node->objs;
+	uint16_t local = 0, i;
+	uint32_t bit = 0;
+	bool keep;
+
+	/* Lanes having offered objects in flight can't run locally */
+	if (key != NULL) {
+		for (i = 0; i < RTE_GRAPH_WORK_STEAL_LANES; i++)
+			if (rte_atomic_load_explicit(&ext->steal.lane_inflight[i],
+						     rte_memory_order_acquire))
+				lanes_busy |= RTE_BIT32(i);
+
+		/* Stream at most the threshold and no lane in flight, run as is */
+		if (lanes_busy == 0 && nb_objs <= thresh)
+			return;
+	}
+
+	for (i = 0; i < nb_objs; i++) {
+		if (key == NULL) {
+			keep = local < thresh;
+		} else {
+			bit = RTE_BIT32(key(objs[i]) % RTE_GRAPH_WORK_STEAL_LANES);
+			if (lanes_busy & bit) {
+				keep = false;
+			} else if ((lanes_local & bit) || local < thresh) {
+				lanes_local |= bit;
+				keep = true;
+			} else {
+				/* Rest of the flow lane must follow this object */
+				lanes_busy |= bit;
+				keep = false;
+			}
+		}
+
+		if (keep) {
+			objs[local++] = objs[i];
+			continue;
+		}
+
+		if (wq_node == NULL) {
+			if (rte_mempool_get(graph->steal.mp, (void **)&wq_node) < 0) {
+				wq_node = NULL;
+				ext->steal.total_offload_fail++;
+				objs[local++] = objs[i];
+				continue;
+			}
+			wq_node->node_off = node->off;
+			wq_node->nb_objs = 0;
+			wq_node->lanes = 0;
+		}
+
+		wq_node->objs[wq_node->nb_objs++] = objs[i];
+		wq_node->lanes |= bit;
+		if (wq_node->nb_objs == RTE_DIM(wq_node->objs)) {
+			graph_steal_wq_node_offer(graph, ext, wq_node);
+			wq_node = NULL;
+		}
+	}
+
+	if (wq_node != NULL)
+		graph_steal_wq_node_offer(graph, ext, wq_node);
+
+	node->idx = local;
+}
+
+static __rte_always_inline void
+graph_steal_pending_walk(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const rte_node_t mask = graph->cir_mask;
+	struct rte_node *node;
+	uint32_t head = 0;
+
+	/* Only the pending streams, source nodes are run by the graph walk */
+	while (head != graph->tail) {
+		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[head++]);
+		__rte_node_process(graph, node);
+		head &= mask;
+	}
+	graph->tail = 0;
+}
+
+static __rte_always_inline void
+graph_steal_wq_node_process(struct rte_graph *graph, struct rte_graph *victim,
+			    struct graph_work_steal_wq_node *wq_node)
+{
+	struct rte_node_ext *owner;
+	struct rte_node *node;
+	uint32_t lanes;
+	uint16_t idx;
+
+	node = RTE_PTR_ADD(graph, wq_node->node_off);
+	RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+	idx = node->idx;
+
+	__rte_node_enqueue_prologue(graph, node, idx, wq_node->nb_objs);
+	rte_memcpy(&node->objs[idx], wq_node->objs, wq_node->nb_objs * sizeof(void *));
+	node->idx = idx + wq_node->nb_objs;
+	if (graph != victim)
+		__rte_node_ext(node)->steal.total_stolen_objs += wq_node->nb_objs;
+
+	/* Complete the stream and its successors before releasing its lanes */
+	graph_steal_pending_walk(graph);
+
+	owner = __rte_node_ext(RTE_PTR_ADD(victim, wq_node->node_off));
+	lanes = wq_node->lanes;
+	while (lanes) {
+		rte_atomic_fetch_sub_explicit(&owner->steal.lane_inflight[rte_ctz32(lanes)],
+					      1, rte_memory_order_release);
+		lanes &= lanes - 1;
+	}
+}
+
+/* Must be called with the victim lock held */
+static void
+graph_steal_wq_process(struct rte_graph *graph, struct rte_graph *victim,
+		       unsigned int max)
+{
+	struct graph_work_steal_wq_node *wq_nodes[WQ_SZ];
+	unsigned int i, n;
+
+	n = rte_ring_sc_dequeue_burst_elem(victim->steal.wq, wq_nodes,
+					   sizeof(wq_nodes[0]), max, NULL);
+	if (n == 0)
+		return;
+
+	for (i = 0; i < n; i++)
+		graph_steal_wq_node_process(graph, victim, wq_nodes[i]);
+
+	rte_mempool_put_bulk(victim->steal.mp, (void **)wq_nodes, n);
+}
+
+void
+__rte_graph_work_steal_wq_process(struct rte_graph *graph)
+{
+	if (rte_ring_empty(graph->steal.wq))
+		return;
+
+	/* A thief holding the lock completes the offered streams */
+	if (!rte_spinlock_trylock(&graph->steal.lock))
+		return;
+
+	graph_steal_wq_process(graph, graph, WQ_SZ);
+	rte_spinlock_unlock(&graph->steal.lock);
+}
+
+static __rte_always_inline bool
+graph_steal_from(struct rte_graph *graph, struct rte_graph *victim)
+{
+	if (victim == graph || rte_ring_empty(victim->steal.wq))
+		return false;
+
+	if (!rte_spinlock_trylock(&victim->steal.lock))
+		return false;
+
+	graph_steal_wq_process(graph, victim, graph->steal.max_batch);
+	rte_spinlock_unlock(&victim->steal.lock);
+	graph->steal.victim = victim;
+
+	return true;
+}
+
+void __rte_noinline
+__rte_graph_work_steal(struct rte_graph *graph)
+{
+	struct rte_graph *victim = graph->steal.victim;
+
+	/* The last victim first, its node contexts are likely still cached */
+	if (victim != NULL && graph_steal_from(graph, victim))
+		return;
+
+	/* Then the graphs sharing the socket, remote ones as the last resort */
+	SLIST_FOREACH(victim, graph->steal.rq, next)
+		if (victim->socket == graph->socket && graph_steal_from(graph, victim))
+			return;
+
+	SLIST_FOREACH(victim, graph->steal.rq, next)
+		if (victim->socket != graph->socket && graph_steal_from(graph, victim))
+			return;
+}
+
+int
+rte_graph_model_work_steal_node_enable(const char *name, rte_node_affinity_key_t key)
+{
+	struct node *node;
+	int ret = -EINVAL;
+
+	graph_spinlock_lock();
+
+	STAILQ_FOREACH(node, node_list_head_get(), next) {
+		if (strncmp(node->name, name, RTE_NODE_NAMESIZE) == 0) {
+			/* Source nodes are polled by each graph of the group */
+			if (node->flags & RTE_NODE_SOURCE_F)
+				break;
+			node->steal = true;
+			node->steal_key = key;
+			ret = 0;
+			break;
+		}
+	}
+
+	graph_spinlock_unlock();
+
+	return ret;
+}
@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#ifndef _RTE_GRAPH_MODEL_WORK_STEAL_H_
+#define _RTE_GRAPH_MODEL_WORK_STEAL_H_
+
+/**
+ * @file rte_graph_model_work_steal.h
+ *
+ * These APIs allow idle graphs of a steal group to steal pending streams
+ * from busy graphs and are only used for work steal model.
+ *
+ * A steal group is made of all the graphs cloned from the same parent graph.
+ * A graph walking a node stream bigger than the steal threshold keeps the
+ * first objects for itself and offers the rest in a bounded queue. A graph
+ * which found no pending stream during its walk steals from the queues of
+ * its group, preferring the graph it stole from last time and the graphs of
+ * its own socket, and runs the stolen streams to completion before releasing
+ * the victim queue.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_compat.h>
+#include <rte_errno.h>
+#include <rte_mempool.h>
+#include <rte_memzone.h>
+#include <rte_ring.h>
+
+#include "rte_graph_worker_common.h"
+
+#define RTE_GRAPH_STEAL_WQ_SIZE_MULTIPLIER  8
+#define RTE_GRAPH_STEAL_WQ_SIZE(nb_nodes)   \
+	((typeof(nb_nodes))((nb_nodes) * RTE_GRAPH_STEAL_WQ_SIZE_MULTIPLIER))
+#define RTE_GRAPH_STEAL_THRESH_DEFAULT RTE_GRAPH_BURST_SIZE
+/**< Default number of objects of a stream kept by the graph. */
+#define RTE_GRAPH_STEAL_MAX_BATCH_DEFAULT 4
+/**< Default number of streams stolen at once by an idle graph. */
+
+/**
+ * @internal
+ *
+ * Offer the objects of the node stream above the steal threshold to the
+ * other graphs of the steal group for work steal model.
+ *
+ * @param graph
+ *   Pointer to the graph object owning the stream.
+ * @param node
+ *   Pointer to the node object of the stream.
+ *
+ * @note
+ * This implementation is used by work steal model only and user application
+ * should not call it directly.
+ */
+void __rte_noinline __rte_graph_work_steal_node_offload(struct rte_graph *graph,
+							 struct rte_node *node);
+
+/**
+ * @internal
+ *
+ * Process the streams offered by the graph itself which were not stolen
+ * in the meantime for work steal model.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ *
+ * @note
+ * This implementation is used by work steal model only and user application
+ * should not call it directly.
+ */
+void __rte_graph_work_steal_wq_process(struct rte_graph *graph);
+
+/**
+ * @internal
+ *
+ * Steal and process the streams offered by the other graphs of the steal
+ * group for work steal model.
+ *
+ * @param graph
+ *   Pointer to the idle graph object.
+ *
+ * @note
+ * This implementation is used by work steal model only and user application
+ * should not call it directly.
+ */
+void __rte_noinline __rte_graph_work_steal(struct rte_graph *graph);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allow the streams of a node to be stolen by idle graphs for work steal
+ * model. Source nodes are never stolen.
+ *
+ * Must be called before cloning the graphs of the steal group.
+ *
+ * @param name
+ *   Valid node name. In the case of the cloned node, the name will be
+ * "parent node name" + "-" + name.
+ * @param key
+ *   Flow affinity key function used to preserve the per flow order of the
+ *   objects across the steal group. NULL if the node does not need ordering.
+ *
+ * @return
+ *   0 on success, error otherwise.
+ */
+__rte_experimental
+int rte_graph_model_work_steal_node_enable(const char *name,
+					   rte_node_affinity_key_t key);
+
+/**
+ * Perform graph walk on the circular buffer and invoke the process function
+ * of the nodes and collect the stats.
+ *
+ * @param graph
+ *   Graph pointer returned from rte_graph_lookup function.
+ *
+ * @see rte_graph_lookup()
+ */
+static inline void
+rte_graph_walk_work_steal(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const rte_node_t mask = graph->cir_mask;
+	uint32_t head = graph->head;
+	struct rte_node_ext *ext;
+	struct rte_node *node;
+	bool idle = true;
+	bool pending;
+
+	/* Complete the offered streams nobody did steal since the last walk */
+	if (graph->steal.wq != NULL)
+		__rte_graph_work_steal_wq_process(graph);
+
+	while (likely(head != graph->tail)) {
+		/* Source nodes sit below cir_start and are never offered */
+		pending = (int32_t)head >= 0;
+		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+
+		/* Keyed streams must check their lanes in flight whatever their size */
+		if (pending) {
+			idle = false;
+			ext = __rte_node_ext(node);
+			if (ext->steal.enable && graph->steal.wq != NULL &&
+			    (ext->steal.key != NULL || node->idx > graph->steal.thresh))
+				__rte_graph_work_steal_node_offload(graph, node);
+		}
+
+		/* Whole stream may be offered when all its flow lanes are in flight */
+		if (likely(!pending || node->idx != 0))
+			__rte_node_process(graph, node);
+
+		head = likely((int32_t)head > 0) ? head & mask : head;
+	}
+
+	graph->tail = 0;
+
+	if (idle && graph->steal.rq != NULL)
+		__rte_graph_work_steal(graph);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_GRAPH_MODEL_WORK_STEAL_H_ */
@@ -8,7 +8,7 @@
 bool
 rte_graph_model_is_valid(uint8_t model)
 {
-	if (model > RTE_GRAPH_MODEL_MCORE_DISPATCH)
+	if (model > RTE_GRAPH_MODEL_WORK_STEAL)
 		return false;
 
 	return true;
@@ -23,8 +23,13 @@ rte_graph_worker_model_set(uint8_t model)
 	if (!rte_graph_model_is_valid(model))
 		return -EINVAL;
 
-	STAILQ_FOREACH(graph, graph_head, next)
-			graph->graph->model = model;
+	STAILQ_FOREACH(graph, graph_head, next) {
+		/* The coalescing policy only applies to rtc model */
+		if (graph->graph->model != model)
+			memset(&graph->graph->coalesce, 0,
+			       sizeof(graph->graph->coalesce));
+		graph->graph->model = model;
+	}
 
 	return 0;
 }
@@ -37,3 +42,21 @@ rte_graph_worker_model_get(struct rte_graph *graph)
 
 	return graph->model;
 }
+
+void
+__rte_graph_rtc_coalesce_requeue(struct rte_graph *graph, uint16_t nb_deferred)
+{
+	struct rte_node *node;
+	rte_graph_off_t off;
+	rte_node_t count;
+
+	/* Every stream processed in the walk was emptied, the rest is deferred */
+	rte_graph_foreach_node(count, off, graph, node) {
+		if (node->idx == 0)
+			continue;
+
+		__rte_node_enqueue_tail_update(graph, node);
+		if (--nb_deferred == 0)
+			break;
+	}
+}
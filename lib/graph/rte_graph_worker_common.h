@@ -12,11 +12,14 @@
  * process, enqueue and move streams of objects to the next nodes.
  */
 
+#include <rte_bitops.h>
 #include <rte_common.h>
 #include <rte_cycles.h>
 #include <rte_prefetch.h>
 #include <rte_memcpy.h>
 #include <rte_memory.h>
+#include <rte_spinlock.h>
+#include <rte_stdatomic.h>
 
 #include "rte_graph.h"
 
@@ -29,8 +32,13 @@ extern "C" {
 #define RTE_GRAPH_MODEL_RTC 0 /**< Run-To-Completion model. It is the default model. */
 #define RTE_GRAPH_MODEL_MCORE_DISPATCH 1
 /**< Dispatch model to support cross-core dispatching within core affinity. */
+#define RTE_GRAPH_MODEL_WORK_STEAL 2
+/**< Work steal model to let idle graphs steal pending streams of busy ones. */
 #define RTE_GRAPH_MODEL_DEFAULT RTE_GRAPH_MODEL_RTC /**< Default graph model. */
 
+/** Number of flow lanes tracked per node by the work steal model. */
+#define RTE_GRAPH_WORK_STEAL_LANES 16
+
 /**
  * @internal
  *
@@ -52,8 +60,14 @@ struct rte_graph {
 	rte_graph_off_t *cir_start;  /**< Pointer to circular buffer. */
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
 	uint8_t model;		     /**< graph model */
-	uint8_t reserved1;	     /**< Reserved for future use. */
+	uint8_t hist;		     /**< Per node stats histograms enabled. */
 	uint16_t reserved2;	     /**< Reserved for future use. */
+	/* Fits in the padding before the cache aligned schedule area */
+	struct {
+		uint16_t thresh;     /**< Pending streams smaller than it are deferred. */
+		uint16_t max_walks;  /**< Maximum walks a stream is deferred. */
+		uint64_t max_cycles; /**< Maximum cycles a stream is deferred. */
+	} coalesce; /** Pending streams coalescing policy, only used by rtc model */
 	union {
 		/* Fast schedule area for mcore dispatch model */
 		struct {
@@ -64,6 +78,18 @@ struct rte_graph {
 			struct rte_ring *wq;    /**< The work-queue for pending streams. */
 			struct rte_mempool *mp; /**< The mempool for scheduling streams. */
 		} dispatch; /** Only used by dispatch model */
+		/* Fast schedule area for work steal model */
+		struct {
+			struct rte_graph_rq_head *rq __rte_cache_aligned; /* The steal group */
+			struct rte_graph_rq_head rq_head; /* The head for steal group list */
+
+			struct rte_graph *victim; /**< Graph stolen from last time. */
+			struct rte_ring *wq;    /**< The queue of streams offered to steal. */
+			struct rte_mempool *mp; /**< The mempool for offered streams. */
+			rte_spinlock_t lock;    /**< Serializes the consumers of wq. */
+			uint16_t thresh;        /**< Objects of a stream kept locally. */
+			uint16_t max_batch;     /**< Maximum streams stolen at once. */
+		} steal; /** Only used by work steal model */
 	};
 	SLIST_ENTRY(rte_graph) next;   /* The next for rte_graph list */
 	/* End of Fast path area.*/
@@ -75,10 +101,24 @@ struct rte_graph {
 	uint64_t nb_pkt_captured;
 	/** Number of packets to capture per core. */
 	uint64_t nb_pkt_to_capture;
+	/** Number of captured packets dropped as the writer lagged behind. */
+	uint64_t nb_pkt_dropped;
+	struct rte_ring *pcap_ring;	/**< Captured packets to be written. */
 	char pcap_filename[RTE_GRAPH_PCAP_FILE_SZ];  /**< Pcap filename. */
 	uint64_t fence;			/**< Fence. */
 } __rte_cache_aligned;
 
+/**
+ * @internal
+ *
+ * Data structure to hold the stats histograms of a node.
+ */
+struct rte_node_hist {
+	uint64_t objs[RTE_GRAPH_HIST_BUCKETS];   /**< Objects per call. */
+	uint64_t cycles[RTE_GRAPH_HIST_BUCKETS]; /**< Cycles per call. */
+	uint64_t cycles_per_obj[RTE_GRAPH_HIST_BUCKETS]; /**< Cycles per object. */
+};
+
 /**
  * @internal
  *
@@ -127,6 +167,52 @@ struct rte_node {
 	struct rte_node *nodes[] __rte_cache_min_aligned; /**< Next nodes. */
 } __rte_cache_aligned;
 
+/**
+ * @internal
+ *
+ * Data structure to hold the node data added after the layout of
+ * struct rte_node was fixed. It follows the next nodes of each node
+ * in the graph reel.
+ */
+struct rte_node_ext {
+	/* Fast schedule area for work steal model */
+	struct {
+		rte_node_affinity_key_t key; /**< Flow affinity key function. */
+		uint64_t total_offload_objs; /**< Number of objects offered to steal. */
+		uint64_t total_stolen_objs;  /**< Number of objects stolen. */
+		uint64_t total_offload_fail; /**< Number of objects failed to offer. */
+		/** Offered streams in flight per flow lane. */
+		RTE_ATOMIC(uint32_t) lane_inflight[RTE_GRAPH_WORK_STEAL_LANES];
+		bool enable;                 /**< Streams of the node can be stolen. */
+	} steal;
+	/** Stats histograms, allocated when first enabled on the graph. */
+	struct rte_node_hist *hist;
+	/* Coalescing state, only used by rtc model */
+	struct {
+		uint64_t start; /**< Timestamp of the first deferral. */
+		uint16_t walks; /**< Number of walks the stream was deferred. */
+	} coalesce;
+} __rte_cache_aligned;
+
+/**
+ * @internal
+ *
+ * Get the extended data of a node.
+ *
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @return
+ *   Pointer to the extended data of the node.
+ */
+static __rte_always_inline struct rte_node_ext *
+__rte_node_ext(const struct rte_node *node)
+{
+	return RTE_PTR_ALIGN_CEIL(RTE_PTR_ADD(node, sizeof(*node) +
+				  sizeof(node->nodes[0]) * node->nb_edges),
+				  RTE_CACHE_LINE_SIZE);
+}
+
 /**
  * @internal
  *
@@ -160,6 +246,48 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 
 /* Fast path helper functions */
 
+/**
+ * @internal
+ *
+ * Get the log2 histogram bucket of a value.
+ *
+ * @param val
+ *   Value to account.
+ *
+ * @return
+ *   Bucket index.
+ */
+static __rte_always_inline unsigned int
+__rte_node_hist_bucket(uint64_t val)
+{
+	return RTE_MIN(rte_fls_u64(val), RTE_GRAPH_HIST_BUCKETS - 1);
+}
+
+/**
+ * @internal
+ *
+ * Account a node process call in the node stats histograms.
+ *
+ * @param node
+ *   Pointer to the node object.
+ * @param objs
+ *   Number of objects processed by the call.
+ * @param cycles
+ *   Cycles spent in the call.
+ */
+static __rte_always_inline void
+__rte_node_hist_update(struct rte_node *node, uint16_t objs, uint64_t cycles)
+{
+	struct rte_node_hist *hist = __rte_node_ext(node)->hist;
+
+	hist->objs[__rte_node_hist_bucket(objs)]++;
+	hist->cycles[__rte_node_hist_bucket(cycles >> RTE_GRAPH_HIST_CYCLES_SHIFT)]++;
+	/* Shift by log2 of objs instead of dividing, good enough for log2 buckets */
+	if (objs)
+		hist->cycles_per_obj[__rte_node_hist_bucket(cycles >>
+							 (rte_fls_u32(objs) - 1))]++;
+}
+
 /**
  * @internal
  *
@@ -173,7 +301,7 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 static __rte_always_inline void
 __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 {
-	uint64_t start;
+	uint64_t start, cycles;
 	uint16_t rc;
 	void **objs;
 
@@ -184,9 +312,12 @@ __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 	if (rte_graph_has_stats_feature()) {
 		start = rte_rdtsc();
 		rc = node->process(graph, node, objs, node->idx);
-		node->total_cycles += rte_rdtsc() - start;
+		cycles = rte_rdtsc() - start;
+		node->total_cycles += cycles;
 		node->total_calls++;
 		node->total_objs += rc;
+		if (unlikely(graph->hist))
+			__rte_node_hist_update(node, rc, cycles);
 	} else {
 		node->process(graph, node, objs, node->idx);
 	}
@@ -16,6 +16,7 @@
 #include <rte_malloc.h>
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
+#include <rte_idpool.h>
 #include <rte_string_fns.h>
 #include <rte_cpuflags.h>
 #include <rte_rwlock.h>
@@ -25,6 +26,9 @@
 
 #include "rte_hash.h"
 #include "rte_cuckoo_hash.h"
+#if defined(RTE_ARCH_X86)
+#include "rte_cuckoo_hash_x86.h"
+#endif
 
 /* Mask of all flags supported by this version */
 #define RTE_HASH_EXTRA_FLAGS_MASK (RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT | \
@@ -32,7 +36,9 @@
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_RESIZE | \
+				   RTE_HASH_EXTRA_FLAGS_AGING)
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -134,13 +140,13 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	struct rte_hash *h = NULL;
 	struct rte_tailq_entry *te = NULL;
 	struct rte_hash_list *hash_list;
-	struct rte_ring *r = NULL;
+	struct rte_idpool *free_ids = NULL;
 	struct rte_ring *r_ext = NULL;
 	char hash_name[RTE_HASH_NAMESIZE];
 	void *k = NULL;
 	void *buckets = NULL;
 	void *buckets_ext = NULL;
-	char ring_name[RTE_RING_NAMESIZE];
+	char idpool_name[RTE_IDPOOL_NAMESIZE];
 	char ext_ring_name[RTE_RING_NAMESIZE];
 	unsigned num_key_slots;
 	unsigned int hw_trans_mem_support = 0, use_local_cache = 0;
@@ -150,8 +156,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	unsigned int no_free_on_del = 0;
 	uint32_t *ext_bkt_to_free = NULL;
 	RTE_ATOMIC(uint32_t) *tbl_chng_cnt = NULL;
-	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	struct rte_hash_resize *rsz = NULL;
+	struct rte_hash_resize_view *rsz_view = NULL;
+	RTE_ATOMIC(uint64_t) *key_ts = NULL;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -187,6 +195,24 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZE) &&
+	    (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT |
+				   RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD |
+				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: resize is not supported "
+			"with transactional memory, multi writer or ext table\n");
+		return NULL;
+	}
+
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING) &&
+	    (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZE)) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: aging is not supported "
+			"with resize\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -228,17 +254,29 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	else
 		num_key_slots = params->entries + 1;
 
-	snprintf(ring_name, sizeof(ring_name), "HT_%s", params->name);
-	/* Create ring (Dummy slot index is not enqueued) */
-	r = rte_ring_create_elem(ring_name, sizeof(uint32_t),
-			rte_align32pow2(num_key_slots), params->socket_id, 0);
-	if (r == NULL) {
+	snprintf(idpool_name, sizeof(idpool_name), "HT_%s", params->name);
+	/*
+	 * Create the pool of free slots, slot i being ID i - 1
+	 * (Dummy slot index is not in the pool)
+	 */
+	free_ids = rte_idpool_create(idpool_name, num_key_slots - 1,
+			use_local_cache ? LCORE_CACHE_SIZE - 1 : 0,
+			params->socket_id, 0);
+	if (free_ids == NULL) {
 		RTE_LOG(ERR, HASH, "memory allocation failed\n");
 		goto err;
 	}
 
-	const uint32_t num_buckets = rte_align32pow2(params->entries) /
+	const uint32_t max_buckets = rte_align32pow2(params->entries) /
 						RTE_HASH_BUCKET_ENTRIES;
+	/* A resizable table starts small and grows with the number of keys */
+	const uint32_t min_buckets =
+		(params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZE) ?
+		RTE_MAX(max_buckets >> RTE_HASH_RESIZE_MIN_SHIFT, 1U) :
+		max_buckets;
+	/* Lock free tables can't resize before RCU is attached, start full */
+	const uint32_t num_buckets = readwrite_concur_lf_support ?
+		max_buckets : min_buckets;
 
 	/* Create ring for extendable buckets. */
 	if (ext_table_support) {
@@ -260,7 +298,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_mcfg_tailq_write_lock();
 
 	/* guarantee there's no existing: this is normally already checked
-	 * by ring creation above */
+	 * by ID pool creation above */
 	TAILQ_FOREACH(te, hash_list, next) {
 		h = (struct rte_hash *) te->data;
 		if (strncmp(params->name, h->name, RTE_HASH_NAMESIZE) == 0)
@@ -296,6 +334,24 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZE) {
+		rsz = rte_zmalloc_socket(NULL, sizeof(struct rte_hash_resize),
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		rsz_view = rte_zmalloc_socket(NULL,
+				sizeof(struct rte_hash_resize_view),
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		if (rsz == NULL || rsz_view == NULL) {
+			RTE_LOG(ERR, HASH, "resize memory allocation failed\n");
+			goto err_unlock;
+		}
+		rsz_view->buckets[0] = buckets;
+		rsz_view->bucket_bitmask[0] = num_buckets - 1;
+		rsz->view = rsz_view;
+		rsz->min_buckets = min_buckets;
+		rsz->max_buckets = max_buckets;
+		rsz->socket_id = params->socket_id;
+	}
+
 	/* Allocate same number of extendable buckets */
 	if (ext_table_support) {
 		buckets_ext = rte_zmalloc_socket(NULL,
@@ -346,6 +402,16 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING) {
+		key_ts = rte_zmalloc_socket(NULL, sizeof(uint64_t) * num_key_slots,
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		if (key_ts == NULL) {
+			RTE_LOG(ERR, HASH, "key timestamps memory allocation "
+								"failed\n");
+			goto err_unlock;
+		}
+	}
+
 /*
  * If x86 architecture is used, select appropriate compare function,
  * which may use x86 intrinsics, otherwise use memcmp
@@ -385,16 +451,6 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->cmp_jump_table_idx = KEY_OTHER_BYTES;
 #endif
 
-	if (use_local_cache) {
-		local_free_slots = rte_zmalloc_socket(NULL,
-				sizeof(struct lcore_cache) * RTE_MAX_LCORE,
-				RTE_CACHE_LINE_SIZE, params->socket_id);
-		if (local_free_slots == NULL) {
-			RTE_LOG(ERR, HASH, "local free slots memory allocation failed\n");
-			goto err_unlock;
-		}
-	}
-
 	/* Default hash function */
 #if defined(RTE_ARCH_X86)
 	default_hash_func = (rte_hash_function)rte_hash_crc;
@@ -417,20 +473,36 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->hash_func = (params->hash_func == NULL) ?
 		default_hash_func : params->hash_func;
 	h->key_store = k;
-	h->free_slots = r;
+	h->free_slots = free_ids;
 	h->ext_bkt_to_free = ext_bkt_to_free;
 	h->tbl_chng_cnt = tbl_chng_cnt;
 	*h->tbl_chng_cnt = 0;
 	h->hw_trans_mem_support = hw_trans_mem_support;
 	h->use_local_cache = use_local_cache;
-	h->local_free_slots = local_free_slots;
 	h->readwrite_concur_support = readwrite_concur_support;
 	h->ext_table_support = ext_table_support;
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resize_support = rsz != NULL;
+	h->rsz = rsz;
+	h->aging_support = key_ts != NULL;
+	h->key_ts = key_ts;
 
 #if defined(RTE_ARCH_X86)
+#ifdef CC_HASH_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512)
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
+#ifdef CC_HASH_AVX2_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) > 0 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX2;
+	else
+#endif
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -454,10 +526,6 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		rte_rwlock_init(h->readwrite_lock);
 	}
 
-	/* Populate free slots ring. Entry zero is reserved for key misses. */
-	for (i = 1; i < num_key_slots; i++)
-		rte_ring_sp_enqueue_elem(r, &i, sizeof(uint32_t));
-
 	te->data = (void *) h;
 	TAILQ_INSERT_TAIL(hash_list, te, next);
 	rte_mcfg_tailq_write_unlock();
@@ -466,16 +534,18 @@ rte_hash_create(const struct rte_hash_parameters *params)
 err_unlock:
 	rte_mcfg_tailq_write_unlock();
 err:
-	rte_ring_free(r);
+	rte_idpool_free(free_ids);
 	rte_ring_free(r_ext);
 	rte_free(te);
-	rte_free(local_free_slots);
 	rte_free(h);
 	rte_free(buckets);
 	rte_free(buckets_ext);
 	rte_free(k);
 	rte_free(tbl_chng_cnt);
 	rte_free(ext_bkt_to_free);
+	rte_free(rsz_view);
+	rte_free(rsz);
+	rte_free(key_ts);
 	return NULL;
 }
 
@@ -484,6 +554,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	uint32_t i;
 
 	if (h == NULL)
 		return;
@@ -510,17 +581,23 @@ rte_hash_free(struct rte_hash *h)
 	if (h->dq)
 		rte_rcu_qsbr_dq_delete(h->dq);
 
-	if (h->use_local_cache)
-		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
 		rte_free(h->readwrite_lock);
-	rte_ring_free(h->free_slots);
+	rte_idpool_free(h->free_slots);
 	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
 	rte_free(h->buckets);
 	rte_free(h->buckets_ext);
 	rte_free(h->tbl_chng_cnt);
 	rte_free(h->ext_bkt_to_free);
+	if (h->resize_support) {
+		for (i = 0; i < h->rsz->nb_retired; i++)
+			rte_free(h->rsz->retired[i].ptr);
+		rte_free(h->rsz->old_buckets);
+		rte_free(h->rsz->view);
+		rte_free(h->rsz);
+	}
+	rte_free(h->key_ts);
 	rte_free(h->hash_rcu_cfg);
 	rte_free(h);
 	rte_free(te);
@@ -551,25 +628,19 @@ rte_hash_max_key_id(const struct rte_hash *h)
 int32_t
 rte_hash_count(const struct rte_hash *h)
 {
-	uint32_t tot_ring_cnt, cached_cnt = 0;
-	uint32_t i, ret;
+	uint32_t tot_slot_cnt;
 
 	if (h == NULL)
 		return -EINVAL;
 
-	if (h->use_local_cache) {
-		tot_ring_cnt = h->entries + (RTE_MAX_LCORE - 1) *
+	if (h->use_local_cache)
+		tot_slot_cnt = h->entries + (RTE_MAX_LCORE - 1) *
 					(LCORE_CACHE_SIZE - 1);
-		for (i = 0; i < RTE_MAX_LCORE; i++)
-			cached_cnt += h->local_free_slots[i].len;
+	else
+		tot_slot_cnt = h->entries;
 
-		ret = tot_ring_cnt - rte_ring_count(h->free_slots) -
-								cached_cnt;
-	} else {
-		tot_ring_cnt = h->entries;
-		ret = tot_ring_cnt - rte_ring_count(h->free_slots);
-	}
-	return ret;
+	/* The free slots cached by the lcores are counted as available */
+	return tot_slot_cnt - rte_idpool_avail_count(h->free_slots);
 }
 
 /* Read write locks implemented using rte_rwlock */
@@ -620,7 +691,7 @@ __hash_rw_reader_unlock(const struct rte_hash *h)
 void
 rte_hash_reset(struct rte_hash *h)
 {
-	uint32_t tot_ring_cnt, i;
+	uint32_t i;
 	unsigned int pending;
 
 	if (h == NULL)
@@ -636,11 +707,18 @@ rte_hash_reset(struct rte_hash *h)
 	}
 
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
+	/* An ongoing resize goes on, migrating empty buckets */
+	if (h->resize_support && h->rsz->old_buckets != NULL)
+		memset(h->rsz->old_buckets, 0, h->rsz->old_num_buckets *
+						sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
+	/* Keep the aging clock, stored in the dummy entry */
+	if (h->aging_support)
+		memset(&h->key_ts[1], 0, sizeof(uint64_t) * h->entries);
 	*h->tbl_chng_cnt = 0;
 
-	/* reset the free ring */
-	rte_ring_reset(h->free_slots);
+	/* reset the free slots, including the ones cached by the lcores */
+	rte_idpool_reset(h->free_slots);
 
 	/* flush free extendable bucket ring and memory */
 	if (h->ext_table_support) {
@@ -649,47 +727,24 @@ rte_hash_reset(struct rte_hash *h)
 		rte_ring_reset(h->free_ext_bkts);
 	}
 
-	/* Repopulate the free slots ring. Entry zero is reserved for key misses */
-	if (h->use_local_cache)
-		tot_ring_cnt = h->entries + (RTE_MAX_LCORE - 1) *
-					(LCORE_CACHE_SIZE - 1);
-	else
-		tot_ring_cnt = h->entries;
-
-	for (i = 1; i < tot_ring_cnt + 1; i++)
-		rte_ring_sp_enqueue_elem(h->free_slots, &i, sizeof(uint32_t));
-
 	/* Repopulate the free ext bkt ring. */
 	if (h->ext_table_support) {
 		for (i = 1; i <= h->num_buckets; i++)
 			rte_ring_sp_enqueue_elem(h->free_ext_bkts, &i,
 							sizeof(uint32_t));
 	}
-
-	if (h->use_local_cache) {
-		/* Reset local caches per lcore */
-		for (i = 0; i < RTE_MAX_LCORE; i++)
-			h->local_free_slots[i].len = 0;
-	}
 	__hash_rw_writer_unlock(h);
 }
 
 /*
- * Function called to enqueue back an index in the cache/ring,
+ * Function called to enqueue back an index in the cache/pool,
  * as slot has not being used and it can be used in the
  * next addition attempt.
  */
 static inline void
-enqueue_slot_back(const struct rte_hash *h,
-		struct lcore_cache *cached_free_slots,
-		uint32_t slot_id)
+enqueue_slot_back(const struct rte_hash *h, uint32_t slot_id)
 {
-	if (h->use_local_cache) {
-		cached_free_slots->objs[cached_free_slots->len] = slot_id;
-		cached_free_slots->len++;
-	} else
-		rte_ring_sp_enqueue_elem(h->free_slots, &slot_id,
-						sizeof(uint32_t));
+	rte_idpool_put(h->free_slots, slot_id - 1);
 }
 
 /* Search a key from bucket and update its data.
@@ -976,39 +1031,19 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 }
 
 static inline uint32_t
-alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
+alloc_slot(const struct rte_hash *h)
 {
-	unsigned int n_slots;
-	uint32_t slot_id;
-
-	if (h->use_local_cache) {
-		/* Try to get a free slot from the local cache */
-		if (cached_free_slots->len == 0) {
-			/* Need to get another burst of free slots from global ring */
-			n_slots = rte_ring_mc_dequeue_burst_elem(h->free_slots,
-					cached_free_slots->objs,
-					sizeof(uint32_t),
-					LCORE_CACHE_SIZE, NULL);
-			if (n_slots == 0)
-				return EMPTY_SLOT;
-
-			cached_free_slots->len += n_slots;
-		}
+	uint32_t id;
 
-		/* Get a free slot from the local cache */
-		cached_free_slots->len--;
-		slot_id = cached_free_slots->objs[cached_free_slots->len];
-	} else {
-		if (rte_ring_sc_dequeue_elem(h->free_slots, &slot_id,
-						sizeof(uint32_t)) != 0)
-			return EMPTY_SLOT;
-	}
+	/* The lcore cache of the pool is refilled as needed */
+	if (rte_idpool_get(h->free_slots, &id) != 0)
+		return EMPTY_SLOT;
 
-	return slot_id;
+	return id + 1;
 }
 
 static inline int32_t
-__rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
+__rte_hash_add_key_cuckoo(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
 {
 	uint16_t short_sig;
@@ -1018,9 +1053,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
-	unsigned lcore_id;
 	unsigned int i;
-	struct lcore_cache *cached_free_slots = NULL;
 	int32_t ret_val;
 	struct rte_hash_bucket *last;
 
@@ -1052,11 +1085,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	__hash_rw_writer_unlock(h);
 
 	/* Did not find a match, so get a new slot for storing the new key */
-	if (h->use_local_cache) {
-		lcore_id = rte_lcore_id();
-		cached_free_slots = &h->local_free_slots[lcore_id];
-	}
-	slot_id = alloc_slot(h, cached_free_slots);
+	slot_id = alloc_slot(h);
 	if (slot_id == EMPTY_SLOT) {
 		if (h->dq) {
 			__hash_rw_writer_lock(h);
@@ -1065,7 +1094,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 					NULL, NULL, NULL);
 			__hash_rw_writer_unlock(h);
 			if (ret == 0)
-				slot_id = alloc_slot(h, cached_free_slots);
+				slot_id = alloc_slot(h);
 		}
 		if (slot_id == EMPTY_SLOT)
 			return -ENOSPC;
@@ -1088,7 +1117,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
-		enqueue_slot_back(h, cached_free_slots, slot_id);
+		enqueue_slot_back(h, slot_id);
 		return ret_val;
 	}
 
@@ -1098,7 +1127,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
-		enqueue_slot_back(h, cached_free_slots, slot_id);
+		enqueue_slot_back(h, slot_id);
 		return ret_val;
 	}
 
@@ -1109,13 +1138,13 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
-		enqueue_slot_back(h, cached_free_slots, slot_id);
+		enqueue_slot_back(h, slot_id);
 		return ret_val;
 	}
 
 	/* if ext table not enabled, we failed the insertion */
 	if (!h->ext_table_support) {
-		enqueue_slot_back(h, cached_free_slots, slot_id);
+		enqueue_slot_back(h, slot_id);
 		return ret;
 	}
 
@@ -1126,14 +1155,14 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	/* We check for duplicates again since could be inserted before the lock */
 	ret = search_and_update(h, data, key, prim_bkt, short_sig);
 	if (ret != -1) {
-		enqueue_slot_back(h, cached_free_slots, slot_id);
+		enqueue_slot_back(h, slot_id);
 		goto failure;
 	}
 
 	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, short_sig);
 		if (ret != -1) {
-			enqueue_slot_back(h, cached_free_slots, slot_id);
+			enqueue_slot_back(h, slot_id);
 			goto failure;
 		}
 	}
@@ -1200,6 +1229,392 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 }
 
+/* Free the resize leftovers that no reader can still be using. */
+static void
+__rte_hash_resize_reclaim(const struct rte_hash *h)
+{
+	struct rte_hash_resize *rsz = h->rsz;
+	uint32_t i, n = 0;
+
+	for (i = 0; i < rsz->nb_retired; i++) {
+		if (rte_rcu_qsbr_check(h->hash_rcu_cfg->v,
+				rsz->retired[i].token, false) != 1) {
+			rsz->retired[n++] = rsz->retired[i];
+			continue;
+		}
+		rte_free(rsz->retired[i].ptr);
+	}
+	rsz->nb_retired = n;
+}
+
+/* Free memory dropped by a resize once the readers are done with it. */
+static void
+__rte_hash_resize_retire(const struct rte_hash *h, void *ptr)
+{
+	struct rte_hash_resize *rsz = h->rsz;
+
+	/* Readers take the lock or do not run concurrently with the writer */
+	if (!h->readwrite_concur_lf_support) {
+		rte_free(ptr);
+		return;
+	}
+
+	if (rsz->nb_retired == RTE_HASH_RESIZE_RETIRED_MAX) {
+		/* Wait for the readers of the oldest retired memory */
+		rte_rcu_qsbr_check(h->hash_rcu_cfg->v, rsz->retired[0].token,
+				   true);
+		rte_free(rsz->retired[0].ptr);
+		rsz->nb_retired--;
+		memmove(&rsz->retired[0], &rsz->retired[1],
+			rsz->nb_retired * sizeof(rsz->retired[0]));
+	}
+	rsz->retired[rsz->nb_retired].ptr = ptr;
+	rsz->retired[rsz->nb_retired].token =
+			rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+	rsz->nb_retired++;
+}
+
+/* Publish the tables the readers have to probe. */
+static int
+__rte_hash_resize_set_view(const struct rte_hash *h,
+			struct rte_hash_bucket *old_buckets,
+			uint32_t old_bucket_bitmask)
+{
+	struct rte_hash_resize *rsz = h->rsz;
+	struct rte_hash_resize_view *view, *prev;
+
+	view = rte_zmalloc_socket(NULL, sizeof(struct rte_hash_resize_view),
+				  RTE_CACHE_LINE_SIZE, rsz->socket_id);
+	if (view == NULL)
+		return -ENOMEM;
+
+	view->buckets[0] = h->buckets;
+	view->bucket_bitmask[0] = h->bucket_bitmask;
+	view->buckets[1] = old_buckets;
+	view->bucket_bitmask[1] = old_bucket_bitmask;
+
+	prev = rte_atomic_load_explicit(&rsz->view, rte_memory_order_relaxed);
+	/* The view is the guard variable for the bucket tables. */
+	rte_atomic_store_explicit(&rsz->view, view, rte_memory_order_release);
+	__rte_hash_resize_retire(h, prev);
+
+	return 0;
+}
+
+/* Start migrating the keys to a table of num_buckets buckets. */
+static int
+__rte_hash_resize_start(const struct rte_hash *h, uint32_t num_buckets)
+{
+	struct rte_hash *wh = (struct rte_hash *)((uintptr_t)h);
+	struct rte_hash_resize *rsz = h->rsz;
+	struct rte_hash_bucket *buckets;
+	int ret;
+
+	/* Without RCU, lock free readers could use the freed old table */
+	if (h->readwrite_concur_lf_support && h->hash_rcu_cfg == NULL)
+		return -ENOTSUP;
+	if (rsz->old_buckets != NULL)
+		return -EBUSY;
+
+	buckets = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, rsz->socket_id);
+	if (buckets == NULL)
+		return -ENOMEM;
+
+	__hash_rw_writer_lock(h);
+	rsz->old_buckets = h->buckets;
+	rsz->old_num_buckets = h->num_buckets;
+	rsz->old_bucket_bitmask = h->bucket_bitmask;
+	rsz->migrate_idx = 0;
+	wh->buckets = buckets;
+	wh->num_buckets = num_buckets;
+	wh->bucket_bitmask = num_buckets - 1;
+	ret = __rte_hash_resize_set_view(h, rsz->old_buckets,
+					 rsz->old_bucket_bitmask);
+	if (ret != 0) {
+		wh->buckets = rsz->old_buckets;
+		wh->num_buckets = rsz->old_num_buckets;
+		wh->bucket_bitmask = rsz->old_bucket_bitmask;
+		rsz->old_buckets = NULL;
+	}
+	__hash_rw_writer_unlock(h);
+
+	if (ret != 0)
+		rte_free(buckets);
+
+	return ret;
+}
+
+/* Move the keys of one old bucket to the new table. */
+static int
+__rte_hash_resize_migrate_bkt(const struct rte_hash *h,
+			struct rte_hash_bucket *old_bkt)
+{
+	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint32_t key_idx;
+	hash_sig_t sig;
+	uint16_t short_sig;
+	int32_t ret_val;
+	unsigned int i;
+	void *data;
+	int ret;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		key_idx = old_bkt->key_idx[i];
+		if (key_idx == EMPTY_SLOT)
+			continue;
+
+		k = (struct rte_hash_key *) ((char *)keys +
+				key_idx * h->key_entry_size);
+		sig = rte_hash_hash(h, k->key);
+		short_sig = get_short_sig(sig);
+		prim_bucket_idx = get_prim_bucket_index(h, sig);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+						      short_sig);
+		prim_bkt = &h->buckets[prim_bucket_idx];
+		sec_bkt = &h->buckets[sec_bucket_idx];
+		data = k->pdata;
+
+		/* Insert the same key index in the new table */
+		ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt,
+				(const void *)k->key, data, short_sig,
+				key_idx, &ret_val);
+		if (ret == -1)
+			ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt,
+					sec_bkt, (const void *)k->key, data,
+					short_sig, prim_bucket_idx, key_idx,
+					&ret_val);
+		if (ret < 0)
+			ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt,
+					prim_bkt, (const void *)k->key, data,
+					short_sig, sec_bucket_idx, key_idx,
+					&ret_val);
+		if (ret < 0)
+			return ret;
+
+		__hash_rw_writer_lock(h);
+		if (h->readwrite_concur_lf_support) {
+			/* Inform the readers that the key moved to the
+			 * new table. Since there is one writer, load
+			 * acquire on tbl_chng_cnt is not required.
+			 */
+			rte_atomic_store_explicit(h->tbl_chng_cnt,
+					 *h->tbl_chng_cnt + 1,
+					 rte_memory_order_release);
+			/* The store to key_idx should not move above
+			 * the store to tbl_chng_cnt.
+			 */
+			__atomic_thread_fence(rte_memory_order_release);
+		}
+		old_bkt->sig_current[i] = NULL_SIGNATURE;
+		rte_atomic_store_explicit(&old_bkt->key_idx[i], EMPTY_SLOT,
+					  rte_memory_order_release);
+		__hash_rw_writer_unlock(h);
+	}
+
+	return 0;
+}
+
+/* The new table can't take a key of the old one, migrate the keys back to
+ * the old table. A rollback failing in turn leaves the migration stalled,
+ * lookups still find all the keys in either table.
+ */
+static void
+__rte_hash_resize_rollback(const struct rte_hash *h, int err)
+{
+	struct rte_hash *wh = (struct rte_hash *)((uintptr_t)h);
+	struct rte_hash_resize *rsz = h->rsz;
+	struct rte_hash_bucket *buckets;
+	uint32_t num_buckets;
+
+	if (rsz->rollback) {
+		if (!rsz->stalled)
+			RTE_LOG(ERR, HASH, "%s: resize rollback stalled (%d)\n",
+				h->name, err);
+		rsz->stalled = 1;
+		return;
+	}
+
+	RTE_LOG(WARNING, HASH, "%s: resize to %u buckets failed (%d), "
+		"rolling back\n", h->name, h->num_buckets, err);
+
+	__hash_rw_writer_lock(h);
+	buckets = h->buckets;
+	num_buckets = h->num_buckets;
+	wh->buckets = rsz->old_buckets;
+	wh->num_buckets = rsz->old_num_buckets;
+	wh->bucket_bitmask = rsz->old_bucket_bitmask;
+	if (__rte_hash_resize_set_view(h, buckets, num_buckets - 1) != 0) {
+		/* Keep going forward */
+		wh->buckets = buckets;
+		wh->num_buckets = num_buckets;
+		wh->bucket_bitmask = num_buckets - 1;
+		__hash_rw_writer_unlock(h);
+		return;
+	}
+	rsz->old_buckets = buckets;
+	rsz->old_num_buckets = num_buckets;
+	rsz->old_bucket_bitmask = num_buckets - 1;
+	rsz->migrate_idx = 0;
+	rsz->rollback = 1;
+	/* Don't retry the resize on load until the table size changes */
+	rsz->failed_buckets = num_buckets;
+	__hash_rw_writer_unlock(h);
+}
+
+/* Migrate up to RTE_HASH_RESIZE_STEP old buckets, then grow or shrink
+ * the table if its load is out of bounds.
+ */
+static void
+__rte_hash_resize_step(const struct rte_hash *h)
+{
+	struct rte_hash_resize *rsz = h->rsz;
+	struct rte_hash_bucket *old_buckets;
+	uint32_t capacity, count, n;
+	int ret;
+
+	if (rsz->nb_retired != 0)
+		__rte_hash_resize_reclaim(h);
+
+	if (rsz->old_buckets != NULL) {
+		for (n = 0; n < RTE_HASH_RESIZE_STEP &&
+				rsz->migrate_idx < rsz->old_num_buckets; n++) {
+			ret = __rte_hash_resize_migrate_bkt(h,
+				&rsz->old_buckets[rsz->migrate_idx]);
+			if (ret != 0) {
+				__rte_hash_resize_rollback(h, ret);
+				return;
+			}
+			rsz->migrate_idx++;
+		}
+		if (rsz->migrate_idx < rsz->old_num_buckets)
+			return;
+
+		/* Migration done, readers can stop probing the old table */
+		__hash_rw_writer_lock(h);
+		if (__rte_hash_resize_set_view(h, NULL, 0) != 0) {
+			__hash_rw_writer_unlock(h);
+			return;
+		}
+		old_buckets = rsz->old_buckets;
+		rsz->old_buckets = NULL;
+		if (!rsz->rollback)
+			rsz->failed_buckets = 0;
+		rsz->rollback = 0;
+		rsz->stalled = 0;
+		__hash_rw_writer_unlock(h);
+		__rte_hash_resize_retire(h, old_buckets);
+		return;
+	}
+
+	count = rte_hash_count(h);
+	capacity = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	if (count >= capacity - capacity / 4 &&
+			h->num_buckets < rsz->max_buckets &&
+			(h->num_buckets << 1) != rsz->failed_buckets)
+		__rte_hash_resize_start(h, h->num_buckets << 1);
+	else if (count < capacity / 4 && h->num_buckets > rsz->min_buckets &&
+			(h->num_buckets >> 1) != rsz->failed_buckets)
+		__rte_hash_resize_start(h, h->num_buckets >> 1);
+}
+
+/* Update the data of a key not migrated yet. */
+static int32_t
+__rte_hash_resize_update_old(const struct rte_hash *h, const void *key,
+			hash_sig_t sig, void *data)
+{
+	struct rte_hash_resize *rsz = h->rsz;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+
+	if (rsz->old_buckets == NULL)
+		return -1;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = sig & rsz->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+					rsz->old_bucket_bitmask;
+
+	__hash_rw_writer_lock(h);
+	ret = search_and_update(h, data, key,
+			&rsz->old_buckets[prim_bucket_idx], short_sig);
+	if (ret == -1)
+		ret = search_and_update(h, data, key,
+				&rsz->old_buckets[sec_bucket_idx], short_sig);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+/* Refresh the last-hit timestamp of a key with the current aging clock */
+static inline void
+__rte_hash_age_touch(const struct rte_hash *h, int32_t position)
+{
+	uint64_t now = rte_atomic_load_explicit(&h->age_clock,
+					rte_memory_order_relaxed);
+
+	/* Avoid dirtying the cache line when the key was already hit */
+	if (rte_atomic_load_explicit(&h->key_ts[position + 1],
+				rte_memory_order_relaxed) != now)
+		rte_atomic_store_explicit(&h->key_ts[position + 1], now,
+					rte_memory_order_relaxed);
+}
+
+static inline int32_t
+__rte_hash_add_key_resize(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	struct rte_hash_resize *rsz = h->rsz;
+	uint32_t n;
+	int32_t ret;
+
+	__rte_hash_resize_step(h);
+
+	ret = __rte_hash_resize_update_old(h, key, sig, data);
+	if (ret != -1)
+		return ret;
+
+	ret = __rte_hash_add_key_cuckoo(h, key, sig, data);
+	if (ret != -ENOSPC || h->num_buckets >= rsz->max_buckets ||
+			(uint32_t)rte_hash_count(h) >= h->entries)
+		return ret;
+
+	/* Cuckoo path failed below the load threshold. Complete the ongoing
+	 * resize, if any, then grow the table right away.
+	 */
+	while (rsz->old_buckets != NULL) {
+		n = rsz->migrate_idx;
+		__rte_hash_resize_step(h);
+		if (rsz->old_buckets != NULL && rsz->migrate_idx == n)
+			return ret;
+	}
+	if (__rte_hash_resize_start(h, h->num_buckets << 1) != 0)
+		return ret;
+
+	return __rte_hash_add_key_cuckoo(h, key, sig, data);
+}
+
+static inline int32_t
+__rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	int32_t ret;
+
+	if (unlikely(h->resize_support))
+		ret = __rte_hash_add_key_resize(h, key, sig, data);
+	else
+		ret = __rte_hash_add_key_cuckoo(h, key, sig, data);
+
+	if (unlikely(h->aging_support) && ret >= 0)
+		__rte_hash_age_touch(h, ret);
+
+	return ret;
+}
+
 int32_t
 rte_hash_add_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
@@ -1412,69 +1827,132 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+/* Search the tables of a resizable hash table, new table first */
 static inline int32_t
-__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
-					hash_sig_t sig, void **data)
+search_resize_view(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		void **data, const struct rte_hash_resize_view *view)
 {
-	if (h->readwrite_concur_lf_support)
-		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
-	else
-		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
-}
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	unsigned int t;
+	uint16_t short_sig;
+	int32_t ret;
 
-int32_t
-rte_hash_lookup_with_hash(const struct rte_hash *h,
-			const void *key, hash_sig_t sig)
-{
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_lookup_with_hash(h, key, sig, NULL);
-}
+	short_sig = get_short_sig(sig);
+	for (t = 0; t < RTE_DIM(view->buckets); t++) {
+		if (view->buckets[t] == NULL)
+			break;
+		prim_bucket_idx = sig & view->bucket_bitmask[t];
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+						view->bucket_bitmask[t];
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+				&view->buckets[t][prim_bucket_idx]);
+		if (ret != -1)
+			return ret;
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+				&view->buckets[t][sec_bucket_idx]);
+		if (ret != -1)
+			return ret;
+	}
 
-int32_t
-rte_hash_lookup(const struct rte_hash *h, const void *key)
-{
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), NULL);
+	return -1;
 }
 
-int
-rte_hash_lookup_with_hash_data(const struct rte_hash *h,
-			const void *key, hash_sig_t sig, void **data)
+static inline int32_t
+__rte_hash_lookup_with_hash_resize(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
 {
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_lookup_with_hash(h, key, sig, data);
-}
+	const struct rte_hash_resize_view *view;
+	uint32_t cnt_b, cnt_a;
+	int32_t ret;
 
-int
-rte_hash_lookup_data(const struct rte_hash *h, const void *key, void **data)
-{
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), data);
-}
+	if (!h->readwrite_concur_lf_support) {
+		__hash_rw_reader_lock(h);
+		view = rte_atomic_load_explicit(&h->rsz->view,
+				rte_memory_order_relaxed);
+		ret = search_resize_view(h, key, sig, data, view);
+		__hash_rw_reader_unlock(h);
+		return ret != -1 ? ret : -ENOENT;
+	}
 
-static int
-free_slot(const struct rte_hash *h, uint32_t slot_id)
+	do {
+		/* Load the table change counter before the lookup
+		 * starts. Keys migrated from the old table to the new
+		 * one update it like cuckoo moves do.
+		 */
+		cnt_b = rte_atomic_load_explicit(h->tbl_chng_cnt,
+				rte_memory_order_acquire);
+		view = rte_atomic_load_explicit(&h->rsz->view,
+				rte_memory_order_acquire);
+
+		ret = search_resize_view(h, key, sig, data, view);
+		if (ret != -1)
+			return ret;
+
+		/* The loads of sig_current in search_one_bucket
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(rte_memory_order_acquire);
+		cnt_a = rte_atomic_load_explicit(h->tbl_chng_cnt,
+					rte_memory_order_acquire);
+	} while (cnt_b != cnt_a);
+
+	return -ENOENT;
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
 {
-	unsigned lcore_id, n_slots;
-	struct lcore_cache *cached_free_slots = NULL;
+	int32_t ret;
 
-	/* Return key indexes to free slot ring */
-	if (h->use_local_cache) {
-		lcore_id = rte_lcore_id();
-		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Cache full, need to free it. */
-		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
-			/* Need to enqueue the free slots in global ring. */
-			n_slots = rte_ring_mp_enqueue_burst_elem(h->free_slots,
-						cached_free_slots->objs,
-						sizeof(uint32_t),
-						LCORE_CACHE_SIZE, NULL);
-			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
-			cached_free_slots->len -= n_slots;
-		}
-	}
+	if (unlikely(h->resize_support))
+		ret = __rte_hash_lookup_with_hash_resize(h, key, sig, data);
+	else if (h->readwrite_concur_lf_support)
+		ret = __rte_hash_lookup_with_hash_lf(h, key, sig, data);
+	else
+		ret = __rte_hash_lookup_with_hash_l(h, key, sig, data);
+
+	if (unlikely(h->aging_support) && ret >= 0)
+		__rte_hash_age_touch(h, ret);
+
+	return ret;
+}
+
+int32_t
+rte_hash_lookup_with_hash(const struct rte_hash *h,
+			const void *key, hash_sig_t sig)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_lookup_with_hash(h, key, sig, NULL);
+}
+
+int32_t
+rte_hash_lookup(const struct rte_hash *h, const void *key)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), NULL);
+}
+
+int
+rte_hash_lookup_with_hash_data(const struct rte_hash *h,
+			const void *key, hash_sig_t sig, void **data)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_lookup_with_hash(h, key, sig, data);
+}
+
+int
+rte_hash_lookup_data(const struct rte_hash *h, const void *key, void **data)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), data);
+}
 
-	enqueue_slot_back(h, cached_free_slots, slot_id);
+static int
+free_slot(const struct rte_hash *h, uint32_t slot_id)
+{
+	/* Return key indexes to the free slot pool, through the lcore cache */
+	enqueue_slot_back(h, slot_id);
 	return 0;
 }
 
@@ -1679,8 +2157,39 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Search the table being migrated and remove the matched key.
+ * Writer is expected to hold the lock while calling this
+ * function.
+ */
 static inline int32_t
-__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+search_and_remove_old(const struct rte_hash *h, const void *key,
+			hash_sig_t sig)
+{
+	struct rte_hash_resize *rsz = h->rsz;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+	int pos;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = sig & rsz->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+					rsz->old_bucket_bitmask;
+
+	ret = search_and_remove(h, key, &rsz->old_buckets[prim_bucket_idx],
+				short_sig, &pos);
+	if (ret != -1)
+		return ret;
+
+	return search_and_remove(h, key, &rsz->old_buckets[sec_bucket_idx],
+				 short_sig, &pos);
+}
+
+/* Remove a key. Writer is expected to hold the lock while calling this
+ * function.
+ */
+static inline int32_t
+__rte_hash_del_key_cuckoo_locked(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
@@ -1697,7 +2206,6 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
 
-	__hash_rw_writer_lock(h);
 	/* look for key in primary bucket */
 	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
 	if (ret != -1) {
@@ -1720,7 +2228,13 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
+	/* Key may not be migrated yet */
+	if (h->resize_support && h->rsz->old_buckets != NULL) {
+		ret = search_and_remove_old(h, key, sig);
+		if (ret != -1)
+			goto return_key;
+	}
+
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
@@ -1780,10 +2294,31 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
 				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
 	}
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_del_key_cuckoo(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	int32_t ret;
+
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_del_key_cuckoo_locked(h, key, sig);
 	__hash_rw_writer_unlock(h);
 	return ret;
 }
 
+static inline int32_t
+__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	if (unlikely(h->resize_support))
+		__rte_hash_resize_step(h);
+
+	return __rte_hash_del_key_cuckoo(h, key, sig);
+}
+
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
@@ -1862,6 +2397,8 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	/* For match mask the first bit of every two bits indicates the match */
 	switch (sig_cmp_fn) {
 #if defined(__SSE2__)
+	case RTE_HASH_COMPARE_AVX2:
+	case RTE_HASH_COMPARE_AVX512:
 	case RTE_HASH_COMPARE_SSE:
 		/* Compare all signatures in the bucket */
 		*prim_hash_matches = _mm_movemask_epi8(_mm_cmpeq_epi16(
@@ -1907,28 +2444,51 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	}
 }
 
+/* Compare the signatures of the primary and secondary buckets of all keys */
 static inline void
-__bulk_lookup_l(const struct rte_hash *h, const void **keys,
+compare_signatures_bulk(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			const uint16_t *sig, int32_t num_keys,
+			enum rte_hash_sig_compare_function sig_cmp_fn)
+{
+	int32_t i;
+
+	switch (sig_cmp_fn) {
+#ifdef CC_HASH_AVX512_SUPPORT
+	case RTE_HASH_COMPARE_AVX512:
+		rte_hash_compare_signatures_avx512(prim_hash_matches,
+			sec_hash_matches, (const void * const *)primary_bkt,
+			(const void * const *)secondary_bkt, sig, num_keys);
+		break;
+#endif
+#ifdef CC_HASH_AVX2_SUPPORT
+	case RTE_HASH_COMPARE_AVX2:
+		rte_hash_compare_signatures_avx2(prim_hash_matches,
+			sec_hash_matches, (const void * const *)primary_bkt,
+			(const void * const *)secondary_bkt, sig, num_keys);
+		break;
+#endif
+	default:
+		for (i = 0; i < num_keys; i++)
+			compare_signatures(&prim_hash_matches[i],
+				&sec_hash_matches[i], primary_bkt[i],
+				secondary_bkt[i], sig[i], sig_cmp_fn);
+	}
+}
+
+/* Prefetch the key slot of the first signature hit of each key */
+static inline void
+__bulk_lookup_prefetch_keys(const struct rte_hash *h,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
-		uint16_t *sig, int32_t num_keys, int32_t *positions,
-		uint64_t *hit_mask, void *data[])
+		const uint32_t *prim_hitmask, const uint32_t *sec_hitmask,
+		int32_t num_keys)
 {
-	uint64_t hits = 0;
 	int32_t i;
-	int32_t ret;
-	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	struct rte_hash_bucket *cur_bkt, *next_bkt;
-
-	__hash_rw_reader_lock(h);
 
-	/* Compare signatures and prefetch key slot of first hit */
 	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-			primary_bkt[i], secondary_bkt[i],
-			sig[i], h->sig_cmp_fn);
-
 		if (prim_hitmask[i]) {
 			uint32_t first_hit =
 					rte_ctz32(prim_hitmask[i])
@@ -1956,8 +2516,25 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			rte_prefetch0(key_slot);
 		}
 	}
+}
+
+/*
+ * Compare the keys matching on signature, first hits in primary first, then
+ * search the ext buckets for the keys not found. Returns the mask of hits.
+ */
+static inline uint64_t
+__bulk_lookup_compare_keys_l(const struct rte_hash *h, const void **keys,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const uint16_t *sig, uint32_t *prim_hitmask,
+		uint32_t *sec_hitmask, int32_t num_keys, int32_t *positions,
+		void *data[])
+{
+	uint64_t hits = 0;
+	int32_t i;
+	int32_t ret;
+	struct rte_hash_bucket *cur_bkt, *next_bkt;
 
-	/* Compare keys, first hits in primary first */
 	for (i = 0; i < num_keys; i++) {
 		positions[i] = -ENOENT;
 		while (prim_hitmask[i]) {
@@ -2021,12 +2598,8 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 	}
 
 	/* all found, do not need to go through ext bkt */
-	if ((hits == ((1ULL << num_keys) - 1)) || !h->ext_table_support) {
-		if (hit_mask != NULL)
-			*hit_mask = hits;
-		__hash_rw_reader_unlock(h);
-		return;
-	}
+	if ((hits == ((1ULL << num_keys) - 1)) || !h->ext_table_support)
+		return hits;
 
 	/* need to check ext buckets for match */
 	for (i = 0; i < num_keys; i++) {
@@ -2048,12 +2621,155 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		}
 	}
 
+	return hits;
+}
+
+static inline void
+__bulk_lookup_l(const struct rte_hash *h, const void **keys,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		uint16_t *sig, int32_t num_keys, int32_t *positions,
+		uint64_t *hit_mask, void *data[])
+{
+	uint64_t hits;
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+
+	__hash_rw_reader_lock(h);
+
+	compare_signatures_bulk(prim_hitmask, sec_hitmask, primary_bkt,
+				secondary_bkt, sig, num_keys, h->sig_cmp_fn);
+
+	__bulk_lookup_prefetch_keys(h, primary_bkt, secondary_bkt,
+				    prim_hitmask, sec_hitmask, num_keys);
+
+	hits = __bulk_lookup_compare_keys_l(h, keys, primary_bkt,
+			secondary_bkt, sig, prim_hitmask, sec_hitmask,
+			num_keys, positions, data);
+
 	__hash_rw_reader_unlock(h);
 
 	if (hit_mask != NULL)
 		*hit_mask = hits;
 }
 
+/*
+ * Lock free variant of __bulk_lookup_compare_keys_l(). The hits of a
+ * previous attempt are kept in the returned mask.
+ */
+static inline uint64_t
+__bulk_lookup_compare_keys_lf(const struct rte_hash *h, const void **keys,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const uint16_t *sig, uint32_t *prim_hitmask,
+		uint32_t *sec_hitmask, int32_t num_keys, int32_t *positions,
+		uint64_t hits, void *data[])
+{
+	int32_t i;
+	int32_t ret;
+	struct rte_hash_bucket *cur_bkt, *next_bkt;
+
+	/* Compare keys, first hits in primary first */
+	for (i = 0; i < num_keys; i++) {
+		while (prim_hitmask[i]) {
+			uint32_t hit_index =
+					rte_ctz32(prim_hitmask[i])
+					>> 1;
+			uint32_t key_idx =
+			rte_atomic_load_explicit(
+				&primary_bkt[i]->key_idx[hit_index],
+				rte_memory_order_acquire);
+			const struct rte_hash_key *key_slot =
+				(const struct rte_hash_key *)(
+				(const char *)h->key_store +
+				key_idx * h->key_entry_size);
+
+			/*
+			 * If key index is 0, do not compare key,
+			 * as it is checking the dummy slot
+			 */
+			if (!!key_idx &
+				!rte_hash_cmp_eq(
+					key_slot->key, keys[i], h)) {
+				if (data != NULL)
+					data[i] = rte_atomic_load_explicit(
+						&key_slot->pdata,
+						rte_memory_order_acquire);
+
+				hits |= 1ULL << i;
+				positions[i] = key_idx - 1;
+				goto next_key;
+			}
+			prim_hitmask[i] &= ~(3ULL << (hit_index << 1));
+		}
+
+		while (sec_hitmask[i]) {
+			uint32_t hit_index =
+					rte_ctz32(sec_hitmask[i])
+					>> 1;
+			uint32_t key_idx =
+			rte_atomic_load_explicit(
+				&secondary_bkt[i]->key_idx[hit_index],
+				rte_memory_order_acquire);
+			const struct rte_hash_key *key_slot =
+				(const struct rte_hash_key *)(
+				(const char *)h->key_store +
+				key_idx * h->key_entry_size);
+
+			/*
+			 * If key index is 0, do not compare key,
+			 * as it is checking the dummy slot
+			 */
+
+			if (!!key_idx &
+				!rte_hash_cmp_eq(
+					key_slot->key, keys[i], h)) {
+				if (data != NULL)
+					data[i] = rte_atomic_load_explicit(
+						&key_slot->pdata,
+						rte_memory_order_acquire);
+
+				hits |= 1ULL << i;
+				positions[i] = key_idx - 1;
+				goto next_key;
+			}
+			sec_hitmask[i] &= ~(3ULL << (hit_index << 1));
+		}
+next_key:
+		continue;
+	}
+
+	/* all found, do not need to go through ext bkt */
+	if (hits == ((1ULL << num_keys) - 1))
+		return hits;
+
+	/* need to check ext buckets for match */
+	if (h->ext_table_support) {
+		for (i = 0; i < num_keys; i++) {
+			if ((hits & (1ULL << i)) != 0)
+				continue;
+			next_bkt = secondary_bkt[i]->next;
+			FOR_EACH_BUCKET(cur_bkt, next_bkt) {
+				if (data != NULL)
+					ret = search_one_bucket_lf(h,
+						keys[i], sig[i],
+						&data[i], cur_bkt);
+				else
+					ret = search_one_bucket_lf(h,
+							keys[i], sig[i],
+							NULL, cur_bkt);
+				if (ret != -1) {
+					positions[i] = ret;
+					hits |= 1ULL << i;
+					break;
+				}
+			}
+		}
+	}
+
+	return hits;
+}
+
 static inline void
 __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
@@ -2063,10 +2779,8 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 {
 	uint64_t hits = 0;
 	int32_t i;
-	int32_t ret;
 	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	struct rte_hash_bucket *cur_bkt, *next_bkt;
 	uint32_t cnt_b, cnt_a;
 
 	for (i = 0; i < num_keys; i++)
@@ -2080,139 +2794,21 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = rte_atomic_load_explicit(h->tbl_chng_cnt,
 					rte_memory_order_acquire);
 
-		/* Compare signatures and prefetch key slot of first hit */
-		for (i = 0; i < num_keys; i++) {
-			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				sig[i], h->sig_cmp_fn);
-
-			if (prim_hitmask[i]) {
-				uint32_t first_hit =
-						rte_ctz32(prim_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-					primary_bkt[i]->key_idx[first_hit];
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-				rte_prefetch0(key_slot);
-				continue;
-			}
-
-			if (sec_hitmask[i]) {
-				uint32_t first_hit =
-						rte_ctz32(sec_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-					secondary_bkt[i]->key_idx[first_hit];
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-				rte_prefetch0(key_slot);
-			}
-		}
+		compare_signatures_bulk(prim_hitmask, sec_hitmask,
+				primary_bkt, secondary_bkt, sig, num_keys,
+				h->sig_cmp_fn);
 
-		/* Compare keys, first hits in primary first */
-		for (i = 0; i < num_keys; i++) {
-			while (prim_hitmask[i]) {
-				uint32_t hit_index =
-						rte_ctz32(prim_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-				rte_atomic_load_explicit(
-					&primary_bkt[i]->key_idx[hit_index],
-					rte_memory_order_acquire);
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-
-				/*
-				 * If key index is 0, do not compare key,
-				 * as it is checking the dummy slot
-				 */
-				if (!!key_idx &
-					!rte_hash_cmp_eq(
-						key_slot->key, keys[i], h)) {
-					if (data != NULL)
-						data[i] = rte_atomic_load_explicit(
-							&key_slot->pdata,
-							rte_memory_order_acquire);
-
-					hits |= 1ULL << i;
-					positions[i] = key_idx - 1;
-					goto next_key;
-				}
-				prim_hitmask[i] &= ~(3ULL << (hit_index << 1));
-			}
-
-			while (sec_hitmask[i]) {
-				uint32_t hit_index =
-						rte_ctz32(sec_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-				rte_atomic_load_explicit(
-					&secondary_bkt[i]->key_idx[hit_index],
-					rte_memory_order_acquire);
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-
-				/*
-				 * If key index is 0, do not compare key,
-				 * as it is checking the dummy slot
-				 */
+		__bulk_lookup_prefetch_keys(h, primary_bkt, secondary_bkt,
+					    prim_hitmask, sec_hitmask, num_keys);
 
-				if (!!key_idx &
-					!rte_hash_cmp_eq(
-						key_slot->key, keys[i], h)) {
-					if (data != NULL)
-						data[i] = rte_atomic_load_explicit(
-							&key_slot->pdata,
-							rte_memory_order_acquire);
+		hits = __bulk_lookup_compare_keys_lf(h, keys, primary_bkt,
+				secondary_bkt, sig, prim_hitmask, sec_hitmask,
+				num_keys, positions, hits, data);
 
-					hits |= 1ULL << i;
-					positions[i] = key_idx - 1;
-					goto next_key;
-				}
-				sec_hitmask[i] &= ~(3ULL << (hit_index << 1));
-			}
-next_key:
-			continue;
-		}
+		/* all found, the table change counter is not checked */
+		if (hits == ((1ULL << num_keys) - 1))
+			break;
 
-		/* all found, do not need to go through ext bkt */
-		if (hits == ((1ULL << num_keys) - 1)) {
-			if (hit_mask != NULL)
-				*hit_mask = hits;
-			return;
-		}
-		/* need to check ext buckets for match */
-		if (h->ext_table_support) {
-			for (i = 0; i < num_keys; i++) {
-				if ((hits & (1ULL << i)) != 0)
-					continue;
-				next_bkt = secondary_bkt[i]->next;
-				FOR_EACH_BUCKET(cur_bkt, next_bkt) {
-					if (data != NULL)
-						ret = search_one_bucket_lf(h,
-							keys[i], sig[i],
-							&data[i], cur_bkt);
-					else
-						ret = search_one_bucket_lf(h,
-								keys[i], sig[i],
-								NULL, cur_bkt);
-					if (ret != -1) {
-						positions[i] = ret;
-						hits |= 1ULL << i;
-						break;
-					}
-				}
-			}
-		}
 		/* The loads of sig_current in compare_signatures
 		 * should not move below the load from tbl_chng_cnt.
 		 */
@@ -2319,17 +2915,57 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		positions, hit_mask, data);
 }
 
+/* Resizable tables are looked up one key at a time */
+static inline void
+__rte_hash_lookup_bulk_resize(const struct rte_hash *h, const void **keys,
+			const hash_sig_t *prim_hash, int32_t num_keys,
+			int32_t *positions, uint64_t *hit_mask, void *data[])
+{
+	uint64_t hits = 0;
+	hash_sig_t sig;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		sig = prim_hash != NULL ? prim_hash[i] :
+					  rte_hash_hash(h, keys[i]);
+		positions[i] = __rte_hash_lookup_with_hash_resize(h, keys[i],
+				sig, data != NULL ? &data[i] : NULL);
+		if (positions[i] >= 0)
+			hits |= 1ULL << i;
+	}
+
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
+static inline void
+__rte_hash_age_touch_bulk(const struct rte_hash *h, int32_t num_keys,
+			  const int32_t *positions)
+{
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++)
+		if (positions[i] >= 0)
+			__rte_hash_age_touch(h, positions[i]);
+}
+
 static inline void
 __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resize_support))
+		__rte_hash_lookup_bulk_resize(h, keys, NULL, num_keys,
+					      positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
 		__rte_hash_lookup_bulk_l(h, keys, num_keys, positions,
 					 hit_mask, data);
+
+	if (unlikely(h->aging_support))
+		__rte_hash_age_touch_bulk(h, num_keys, positions);
 }
 
 int
@@ -2436,12 +3072,18 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resize_support))
+		__rte_hash_lookup_bulk_resize(h, keys, prim_hash, num_keys,
+					      positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
 		__rte_hash_lookup_with_hash_bulk_l(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
+
+	if (unlikely(h->aging_support))
+		__rte_hash_age_touch_bulk(h, num_keys, positions);
 }
 
 int
@@ -2477,6 +3119,154 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return rte_popcount64(*hit_mask);
 }
 
+int
+rte_hash_lookup_stage_bkt(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *sig, uint32_t num_keys,
+		struct rte_hash_lookup_stage *stage)
+{
+	uint32_t i, prim_index, sec_index;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(stage == NULL)), -EINVAL);
+
+	stage->keys = keys;
+	stage->num_keys = num_keys;
+
+	/* Prefetch first keys */
+	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
+		rte_prefetch0(keys[i]);
+
+	for (i = 0; i < num_keys; i++) {
+		if (i + PREFETCH_OFFSET < num_keys)
+			rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+
+		stage->prim_hash[i] = (sig != NULL) ? sig[i] :
+						rte_hash_hash(h, keys[i]);
+		if (unlikely(h->resize_support))
+			continue;
+
+		stage->sig[i] = get_short_sig(stage->prim_hash[i]);
+		prim_index = get_prim_bucket_index(h, stage->prim_hash[i]);
+		sec_index = get_alt_bucket_index(h, prim_index, stage->sig[i]);
+
+		stage->prim_bkt[i] = &h->buckets[prim_index];
+		stage->sec_bkt[i] = &h->buckets[sec_index];
+
+		rte_prefetch0(stage->prim_bkt[i]);
+		rte_prefetch0(stage->sec_bkt[i]);
+	}
+
+	return 0;
+}
+
+static inline void
+__rte_hash_lookup_stage_compare_sig(const struct rte_hash *h,
+		struct rte_hash_lookup_stage *stage)
+{
+	memset(stage->prim_hitmask, 0, sizeof(uint32_t) * stage->num_keys);
+	memset(stage->sec_hitmask, 0, sizeof(uint32_t) * stage->num_keys);
+
+	compare_signatures_bulk(stage->prim_hitmask, stage->sec_hitmask,
+			stage->prim_bkt, stage->sec_bkt, stage->sig,
+			stage->num_keys, h->sig_cmp_fn);
+}
+
+int
+rte_hash_lookup_stage_sig(const struct rte_hash *h,
+		struct rte_hash_lookup_stage *stage)
+{
+	RETURN_IF_TRUE(((h == NULL) || (stage == NULL)), -EINVAL);
+
+	if (unlikely(h->resize_support))
+		return 0;
+
+	/* Load the table change counter before the signatures are compared,
+	 * it is checked again once the keys are compared.
+	 */
+	if (h->readwrite_concur_lf_support)
+		stage->tbl_chng_cnt = rte_atomic_load_explicit(h->tbl_chng_cnt,
+					rte_memory_order_acquire);
+
+	__rte_hash_lookup_stage_compare_sig(h, stage);
+
+	__bulk_lookup_prefetch_keys(h, stage->prim_bkt, stage->sec_bkt,
+			stage->prim_hitmask, stage->sec_hitmask,
+			stage->num_keys);
+
+	return 0;
+}
+
+int
+rte_hash_lookup_stage_key(const struct rte_hash *h,
+		struct rte_hash_lookup_stage *stage, int32_t *positions,
+		uint64_t *hit_mask, void *data[])
+{
+	int32_t pos[RTE_HASH_LOOKUP_BULK_MAX];
+	uint64_t hits = 0;
+	int32_t num_keys;
+	uint32_t cnt;
+	int32_t i;
+
+	RETURN_IF_TRUE(((h == NULL) || (stage == NULL)), -EINVAL);
+
+	num_keys = stage->num_keys;
+	if (positions == NULL)
+		positions = pos;
+
+	if (unlikely(h->resize_support)) {
+		__rte_hash_lookup_bulk_resize(h, stage->keys, stage->prim_hash,
+				num_keys, positions, &hits, data);
+	} else if (h->readwrite_concur_lf_support) {
+		for (i = 0; i < num_keys; i++)
+			positions[i] = -ENOENT;
+
+		for (;;) {
+			hits = __bulk_lookup_compare_keys_lf(h, stage->keys,
+					stage->prim_bkt, stage->sec_bkt,
+					stage->sig, stage->prim_hitmask,
+					stage->sec_hitmask, num_keys, positions,
+					hits, data);
+			if (hits == ((1ULL << num_keys) - 1))
+				break;
+
+			/* Same as in __bulk_lookup_lf(), re-do the search if
+			 * the table changed since the signatures were compared.
+			 */
+			__atomic_thread_fence(rte_memory_order_acquire);
+			cnt = rte_atomic_load_explicit(h->tbl_chng_cnt,
+					rte_memory_order_acquire);
+			if (cnt == stage->tbl_chng_cnt)
+				break;
+			stage->tbl_chng_cnt = cnt;
+			__rte_hash_lookup_stage_compare_sig(h, stage);
+		}
+	} else {
+		__hash_rw_reader_lock(h);
+
+		/* Signatures compared out of the lock are only used to
+		 * prefetch the keys, compare them again under the lock.
+		 */
+		if (h->readwrite_concur_support)
+			__rte_hash_lookup_stage_compare_sig(h, stage);
+
+		hits = __bulk_lookup_compare_keys_l(h, stage->keys,
+				stage->prim_bkt, stage->sec_bkt, stage->sig,
+				stage->prim_hitmask, stage->sec_hitmask,
+				num_keys, positions, data);
+
+		__hash_rw_reader_unlock(h);
+	}
+
+	if (unlikely(h->aging_support))
+		__rte_hash_age_touch_bulk(h, num_keys, positions);
+
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+
+	return rte_popcount64(hits);
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -2524,6 +3314,9 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
+	if (h->resize_support)
+		goto old_table;
+
 	/* Out of total bound or if ext bucket feature is not enabled */
 	if (*next >= total_entries || !h->ext_table_support)
 		return -ENOENT;
@@ -2551,4 +3344,143 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	/* Increment iterator */
 	(*next)++;
 	return position - 1;
+
+/* Iterate the keys not yet migrated by an ongoing resize */
+old_table:
+	if (h->rsz->old_buckets == NULL || *next - total_entries_main >=
+			h->rsz->old_num_buckets * RTE_HASH_BUCKET_ENTRIES)
+		return -ENOENT;
+
+	bucket_idx = (*next - total_entries_main) / RTE_HASH_BUCKET_ENTRIES;
+	idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+
+	while ((position = rte_atomic_load_explicit(
+			&h->rsz->old_buckets[bucket_idx].key_idx[idx],
+			rte_memory_order_acquire)) == EMPTY_SLOT) {
+		(*next)++;
+		if (*next - total_entries_main ==
+				h->rsz->old_num_buckets * RTE_HASH_BUCKET_ENTRIES)
+			return -ENOENT;
+		bucket_idx = (*next - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES;
+		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+	}
+	__hash_rw_reader_lock(h);
+	next_key = (struct rte_hash_key *) ((char *)h->key_store +
+				position * h->key_entry_size);
+	/* Return key and data */
+	*key = next_key->key;
+	*data = next_key->pdata;
+
+	__hash_rw_reader_unlock(h);
+
+	/* Increment iterator */
+	(*next)++;
+	return position - 1;
+}
+
+static inline int
+__rte_hash_aged(const struct rte_hash *h, uint32_t key_idx, uint64_t now,
+		uint64_t timeout)
+{
+	uint64_t ts = rte_atomic_load_explicit(&h->key_ts[key_idx],
+					rte_memory_order_relaxed);
+
+	/* A key hit after the clock was read is not aged */
+	return now >= ts && now - ts >= timeout;
+}
+
+/* Remove up to max_keys aged keys from a bucket and its linked buckets */
+static uint32_t
+__rte_hash_expire_bkt(const struct rte_hash *h, struct rte_hash_bucket *bkt,
+		uint64_t now, uint64_t timeout, const void **keys, void **data,
+		int32_t *positions, uint32_t max_keys)
+{
+	struct rte_hash_bucket *cur_bkt;
+	struct rte_hash_key *k;
+	const void *key;
+	uint32_t key_idx, n = 0;
+	void *pdata = NULL;
+	int32_t ret = 0;
+	int i;
+
+	while (n < max_keys) {
+		key = NULL;
+		/* Find and delete under the same writer lock, so that the key
+		 * slot can't be freed and reused by another writer in between.
+		 */
+		__hash_rw_writer_lock(h);
+		FOR_EACH_BUCKET(cur_bkt, bkt) {
+			for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+				key_idx = rte_atomic_load_explicit(
+						&cur_bkt->key_idx[i],
+						rte_memory_order_acquire);
+				if (key_idx == EMPTY_SLOT ||
+				    !__rte_hash_aged(h, key_idx, now, timeout))
+					continue;
+				k = (struct rte_hash_key *)((char *)h->key_store +
+						key_idx * h->key_entry_size);
+				key = k->key;
+				pdata = rte_atomic_load_explicit(&k->pdata,
+						rte_memory_order_acquire);
+				ret = __rte_hash_del_key_cuckoo_locked(h, key,
+						rte_hash_hash(h, key));
+				goto found;
+			}
+		}
+found:
+		__hash_rw_writer_unlock(h);
+		if (key == NULL)
+			break;
+
+		/* Deleting may move keys within the bucket chain, so the
+		 * scan restarts from the main bucket after each removal.
+		 */
+		if (ret < 0)
+			break;
+		if (keys != NULL)
+			keys[n] = key;
+		if (data != NULL)
+			data[n] = pdata;
+		if (positions != NULL)
+			positions[n] = ret;
+		n++;
+	}
+
+	return n;
+}
+
+int32_t
+rte_hash_expire(const struct rte_hash *h, uint64_t now, uint64_t timeout,
+		uint32_t nb_buckets, uint32_t *next, const void **keys,
+		void **data, int32_t *positions, uint32_t max_keys)
+{
+	uint32_t bkt_idx, i, cnt = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || !h->aging_support || (next == NULL) ||
+			(nb_buckets != 0 && max_keys == 0)), -EINVAL);
+
+	rte_atomic_store_explicit(&((struct rte_hash *)((uintptr_t)h))->age_clock,
+				  now, rte_memory_order_relaxed);
+
+	bkt_idx = *next;
+	if (bkt_idx >= h->num_buckets)
+		bkt_idx = 0;
+
+	nb_buckets = RTE_MIN(nb_buckets, h->num_buckets);
+	for (i = 0; i < nb_buckets; i++) {
+		cnt += __rte_hash_expire_bkt(h, &h->buckets[bkt_idx], now,
+				timeout, keys == NULL ? NULL : &keys[cnt],
+				data == NULL ? NULL : &data[cnt],
+				positions == NULL ? NULL : &positions[cnt],
+				max_keys - cnt);
+		/* The bucket may still hold aged keys, resume from it */
+		if (cnt == max_keys)
+			break;
+		if (++bkt_idx == h->num_buckets)
+			bkt_idx = 0;
+	}
+	*next = bkt_idx;
+
+	return cnt;
 }
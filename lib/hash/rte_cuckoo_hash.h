@@ -128,11 +128,6 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
-struct lcore_cache {
-	unsigned len; /**< Cache len */
-	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
-} __rte_cache_aligned;
-
 /* Structure that stores key-value pair */
 struct rte_hash_key {
 	union {
@@ -148,6 +143,8 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SCALAR = 0,
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_NEON,
+	RTE_HASH_COMPARE_AVX2,
+	RTE_HASH_COMPARE_AVX512,
 	RTE_HASH_COMPARE_NUM
 };
 
@@ -162,17 +159,56 @@ struct rte_hash_bucket {
 	void *next;
 } __rte_cache_aligned;
 
+/** Number of old buckets migrated on every add/delete while resizing */
+#define RTE_HASH_RESIZE_STEP		4
+/** A resizable table starts (and shrinks down to) max buckets >> this */
+#define RTE_HASH_RESIZE_MIN_SHIFT	4
+/** Number of retired bucket arrays/views waiting for the readers */
+#define RTE_HASH_RESIZE_RETIRED_MAX	8
+
+/** Bucket tables probed by the readers of a resizable hash table */
+struct rte_hash_resize_view {
+	struct rte_hash_bucket *buckets[2];
+	/**< Current table, then the table being migrated (NULL if none) */
+	uint32_t bucket_bitmask[2];
+	/**< Bitmask for getting bucket index of each table */
+};
+
+/** Memory released by a resize, freed once the readers are done with it */
+struct rte_hash_resize_retired {
+	void *ptr;
+	uint64_t token; /**< RCU QSBR token of the retirement */
+};
+
+/** Online resize state. Only accessed by the writer, except for the view. */
+struct rte_hash_resize {
+	RTE_ATOMIC(struct rte_hash_resize_view *) view;
+	/**< Tables to be probed by the readers */
+	struct rte_hash_bucket *old_buckets;
+	/**< Table being migrated to rte_hash::buckets, NULL if none */
+	uint32_t old_num_buckets;       /**< Number of buckets in old table. */
+	uint32_t old_bucket_bitmask;    /**< Bitmask of the old table. */
+	uint32_t migrate_idx;           /**< Next old bucket to migrate. */
+	uint32_t failed_buckets;        /**< Size of the last failed resize. */
+	uint8_t rollback;               /**< Migrating back to the old table. */
+	uint8_t stalled;                /**< Rollback failed, error reported. */
+	uint32_t min_buckets;           /**< Lower bound of num_buckets. */
+	uint32_t max_buckets;           /**< Upper bound of num_buckets. */
+	int socket_id;                  /**< Socket of the bucket tables. */
+	uint32_t nb_retired;            /**< Number of retired objects. */
+	struct rte_hash_resize_retired retired[RTE_HASH_RESIZE_RETIRED_MAX];
+};
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
 	uint32_t entries;               /**< Total table entries. */
 	uint32_t num_buckets;           /**< Number of buckets in table. */
 
-	struct rte_ring *free_slots;
-	/**< Ring that stores all indexes of the free slots in the key table */
-
-	struct lcore_cache *local_free_slots;
-	/**< Local cache per lcore, storing some indexes of the free slots */
+	struct rte_idpool *free_slots;
+	/**< Pool of the indexes of the free slots in the key table, with a
+	 * cache per lcore when use_local_cache is set
+	 */
 
 	/* RCU config */
 	struct rte_hash_rcu_config *hash_rcu_cfg;
@@ -202,6 +238,10 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t resize_support;
+	/**< If the bucket table grows and shrinks with the number of keys */
+	uint8_t aging_support;
+	/**< If a last-hit timestamp is kept per key */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -231,6 +271,17 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	RTE_ATOMIC(uint32_t) *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+	struct rte_hash_resize *rsz;
+	/**< Online resize state, if resize support is enabled. */
+	RTE_ATOMIC(uint64_t) *key_ts;
+	/**< Last-hit timestamp of each key slot, if aging support is enabled.
+	 * Entry zero matches the dummy key slot and is unused.
+	 */
+
+	RTE_ATOMIC(uint64_t) age_clock __rte_cache_aligned;
+	/**< Clock stored in the timestamps of the keys hit, kept away from
+	 * the timestamps written on every hit.
+	 */
 } __rte_cache_aligned;
 
 struct queue_node {
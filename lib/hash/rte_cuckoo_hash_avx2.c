@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <stdint.h>
+
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_x86.h"
+
+void
+rte_hash_compare_signatures_avx2(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches, const void * const *prim_bkt,
+		const void * const *sec_bkt, const uint16_t *sig,
+		int32_t num_keys)
+{
+	__m256i sigs, vmat;
+	uint32_t matches;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		/* Both buckets of the key in one register */
+		sigs = _mm256_inserti128_si256(_mm256_castsi128_si256(
+				_mm_load_si128((const __m128i *)prim_bkt[i])),
+				_mm_load_si128((const __m128i *)sec_bkt[i]), 1);
+		vmat = _mm256_cmpeq_epi16(sigs, _mm256_set1_epi16(sig[i]));
+		/* Extract the even-index bits only */
+		matches = _mm256_movemask_epi8(vmat) & 0x55555555;
+		prim_hash_matches[i] = matches & 0xffff;
+		sec_hash_matches[i] = matches >> 16;
+	}
+}
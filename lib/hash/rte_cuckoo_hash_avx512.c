@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <stdint.h>
+
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_x86.h"
+
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches, const void * const *prim_bkt,
+		const void * const *sec_bkt, const uint16_t *sig,
+		int32_t num_keys)
+{
+	__m512i sigs, vsig;
+	__mmask32 vmat;
+	uint64_t matches;
+	int32_t i;
+
+	/* Both buckets of two keys in one register */
+	for (i = 0; i + 1 < num_keys; i += 2) {
+		sigs = _mm512_castsi128_si512(
+				_mm_load_si128((const __m128i *)prim_bkt[i]));
+		sigs = _mm512_inserti32x4(sigs,
+				_mm_load_si128((const __m128i *)sec_bkt[i]), 1);
+		sigs = _mm512_inserti32x4(sigs,
+				_mm_load_si128((const __m128i *)prim_bkt[i + 1]), 2);
+		sigs = _mm512_inserti32x4(sigs,
+				_mm_load_si128((const __m128i *)sec_bkt[i + 1]), 3);
+		vsig = _mm512_inserti64x4(_mm512_castsi256_si512(
+				_mm256_set1_epi16(sig[i])),
+				_mm256_set1_epi16(sig[i + 1]), 1);
+		vmat = _mm512_cmpeq_epi16_mask(sigs, vsig);
+		/* Spread the match bits to the even-index bits */
+		matches = _mm512_movepi8_mask(_mm512_movm_epi16(vmat)) &
+				0x5555555555555555ULL;
+		prim_hash_matches[i] = matches & 0xffff;
+		sec_hash_matches[i] = (matches >> 16) & 0xffff;
+		prim_hash_matches[i + 1] = (matches >> 32) & 0xffff;
+		sec_hash_matches[i + 1] = matches >> 48;
+	}
+
+	if (i < num_keys) {
+		sigs = _mm512_castsi256_si512(_mm256_inserti128_si256(
+				_mm256_castsi128_si256(
+				_mm_load_si128((const __m128i *)prim_bkt[i])),
+				_mm_load_si128((const __m128i *)sec_bkt[i]), 1));
+		vmat = _mm512_mask_cmpeq_epi16_mask(0xffff, sigs,
+				_mm512_set1_epi16(sig[i]));
+		matches = _mm512_movepi8_mask(_mm512_movm_epi16(vmat)) &
+				0x5555555555555555ULL;
+		prim_hash_matches[i] = matches & 0xffff;
+		sec_hash_matches[i] = (matches >> 16) & 0xffff;
+	}
+}
@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef _RTE_CUCKOO_HASH_X86_H_
+#define _RTE_CUCKOO_HASH_X86_H_
+
+/*
+ * Signature compare of the primary and secondary buckets of a burst of keys.
+ * Buckets start with their RTE_HASH_BUCKET_ENTRIES 16-bit signatures, and
+ * match masks use the first bit of every two bits, as compare_signatures().
+ */
+
+void
+rte_hash_compare_signatures_avx2(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches, const void * const *prim_bkt,
+		const void * const *sec_bkt, const uint16_t *sig,
+		int32_t num_keys);
+
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches, const void * const *prim_bkt,
+		const void * const *sec_bkt, const uint16_t *sig,
+		int32_t num_keys);
+
+#endif /* _RTE_CUCKOO_HASH_X86_H_ */
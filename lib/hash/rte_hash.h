@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <rte_compat.h>
 #include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
@@ -55,6 +56,27 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to let the bucket table grow and shrink with the number of keys.
+ * The table starts small and is resized online, migrating a few buckets on
+ * every add/delete, while lookups probe both the old and the new table.
+ * The key store is still sized by the 'entries' parameter, which is the
+ * maximum number of keys. Cannot be combined with
+ * RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT, RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD
+ * or RTE_HASH_EXTRA_FLAGS_EXT_TABLE. When
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled, the table starts at its
+ * full size and is only resized once RCU QSBR is attached with
+ * rte_hash_rcu_qsbr_add().
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZE 0x40
+
+/**
+ * Flag to keep a last-hit timestamp per key. The timestamp is refreshed by
+ * add and lookup operations with the clock last passed to rte_hash_expire(),
+ * which removes the keys not hit within a given timeout. Cannot be combined
+ * with RTE_HASH_EXTRA_FLAGS_RESIZE.
+ */
+#define RTE_HASH_EXTRA_FLAGS_AGING 0x80
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -633,6 +655,107 @@ int
 rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 		      uint32_t num_keys, int32_t *positions);
 
+/** @internal A bucket of the hash table. */
+struct rte_hash_bucket;
+
+/**
+ * State of a staged bulk lookup, allocated by the application and carried
+ * from rte_hash_lookup_stage_bkt() to rte_hash_lookup_stage_sig() and
+ * rte_hash_lookup_stage_key(). The fields are private to the hash library.
+ */
+struct rte_hash_lookup_stage {
+	const void **keys;
+	const struct rte_hash_bucket *prim_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *sec_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t num_keys;
+	uint32_t tbl_chng_cnt;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * First stage of a staged bulk lookup: compute the hash of the keys and
+ * prefetch their buckets.
+ *
+ * A staged lookup performs the work of rte_hash_lookup_bulk_data() in three
+ * calls, so that the application can do other work, such as the stages of
+ * lookups in other tables, while the prefetched cache lines are loaded.
+ * The stages must be called in order on the same lcore, and the keys array
+ * must not be modified until the last stage. Tables created with
+ * RTE_HASH_EXTRA_FLAGS_RESIZE are looked up in the last stage only.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param keys
+ *   A pointer to a list of keys to look for.
+ * @param sig
+ *   A pointer to a list of precomputed hash values for keys, or NULL to
+ *   compute them.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param stage
+ *   Lookup state to initialize.
+ * @return
+ *   -EINVAL if there's an error, otherwise 0.
+ */
+__rte_experimental
+int
+rte_hash_lookup_stage_bkt(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *sig, uint32_t num_keys,
+		struct rte_hash_lookup_stage *stage);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Second stage of a staged bulk lookup: compare the key signatures in the
+ * buckets and prefetch the matching key slots.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param stage
+ *   Lookup state initialized by rte_hash_lookup_stage_bkt().
+ * @return
+ *   -EINVAL if there's an error, otherwise 0.
+ */
+__rte_experimental
+int
+rte_hash_lookup_stage_sig(const struct rte_hash *h,
+		struct rte_hash_lookup_stage *stage);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Last stage of a staged bulk lookup: compare the keys and return the
+ * results, as rte_hash_lookup_bulk_data() does.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param stage
+ *   Lookup state passed to rte_hash_lookup_stage_sig().
+ * @param positions
+ *   Output containing the position of each key, or -ENOENT if it was not
+ *   found. Can be NULL.
+ * @param hit_mask
+ *   Output containing a bitmask with all successful lookups. Can be NULL.
+ * @param data
+ *   Output containing array of data returned from all the successful lookups.
+ *   Can be NULL.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of successful lookups.
+ */
+__rte_experimental
+int
+rte_hash_lookup_stage_key(const struct rte_hash *h,
+		struct rte_hash_lookup_stage *stage, int32_t *positions,
+		uint64_t *hit_mask, void *data[]);
+
 /**
  * Iterate through the hash table, returning key-value pairs.
  *
@@ -674,6 +797,53 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
  */
 int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove the keys not hit within a timeout, scanning a bounded range of
+ * buckets per call. Requires RTE_HASH_EXTRA_FLAGS_AGING.
+ *
+ * The 'now' value becomes the clock stamped on keys by subsequent add and
+ * lookup operations; calling with nb_buckets set to 0 only updates the clock.
+ * The time unit is up to the application, e.g. TSC cycles or seconds.
+ * Aged keys are deleted as with rte_hash_del_key(): when internal RCU is
+ * enabled, the returned data is handed to the free_key_data_func callback
+ * once readers are done and must not be freed by the caller. Otherwise, if
+ * RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL or RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF
+ * is enabled, rte_hash_free_key_with_position() must be called with the
+ * returned positions. The returned key pointers remain valid until their key
+ * slot is reused by an add operation.
+ *
+ * @param h
+ *   Hash table to expire keys from.
+ * @param now
+ *   Current time.
+ * @param timeout
+ *   Keys not hit for at least this time are removed.
+ * @param nb_buckets
+ *   Maximum number of buckets to scan in this call.
+ * @param next
+ *   Pointer to the bucket iterator. Should be 0 to start scanning the table.
+ *   It is updated to the next bucket to scan, wrapping around at the end of
+ *   the table.
+ * @param keys
+ *   Output array of the removed keys. Can be NULL.
+ * @param data
+ *   Output array of the data associated with the removed keys. Can be NULL.
+ * @param positions
+ *   Output array of the positions of the removed keys. Can be NULL.
+ * @param max_keys
+ *   Maximum number of keys to remove, and size of the output arrays.
+ * @return
+ *   Number of keys removed, or -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int32_t
+rte_hash_expire(const struct rte_hash *h, uint64_t now, uint64_t timeout,
+		uint32_t nb_buckets, uint32_t *next, const void **keys,
+		void **data, int32_t *positions, uint32_t max_keys);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,436 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <string.h>
+#include <sys/queue.h>
+
+#include <rte_bitops.h>
+#include <rte_debug.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_string_fns.h>
+#include <rte_tailq.h>
+
+#include "rte_idpool.h"
+
+RTE_LOG_REGISTER_DEFAULT(idpool_logtype, NOTICE);
+
+#define IDPOOL_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, idpool_logtype, "%s(): " fmt "\n", \
+		__func__, ##args)
+
+#define IDPOOL_WORD_IDS 64
+
+TAILQ_HEAD(rte_idpool_list, rte_tailq_entry);
+
+static struct rte_tailq_elem rte_idpool_tailq = {
+	.name = RTE_TAILQ_IDPOOL_NAME,
+};
+EAL_REGISTER_TAILQ(rte_idpool_tailq)
+
+/* Number of IDs of a range, the last one may be partial or empty */
+static uint32_t
+idpool_seg_nb_ids(const struct rte_idpool *p, unsigned int seg)
+{
+	uint32_t first_id = p->segs[seg].first_id;
+
+	return first_id >= p->nb_ids ? 0 :
+		RTE_MIN(p->seg_ids, p->nb_ids - first_id);
+}
+
+static void
+idpool_seg_fill(struct rte_idpool *p, unsigned int seg)
+{
+	struct rte_idpool_segment *s = &p->segs[seg];
+	uint32_t nb_ids = idpool_seg_nb_ids(p, seg);
+	uint32_t w;
+
+	for (w = 0; w < s->nb_words; w++) {
+		rte_atomic_store_explicit(&s->bitmap[w],
+				nb_ids >= IDPOOL_WORD_IDS ? UINT64_MAX :
+				RTE_BIT64(nb_ids) - 1,
+				rte_memory_order_relaxed);
+		nb_ids -= RTE_MIN(nb_ids, (uint32_t)IDPOOL_WORD_IDS);
+	}
+	rte_atomic_store_explicit(&s->hint, 0, rte_memory_order_relaxed);
+}
+
+/* Take up to n free IDs from a range, lowest first in each word. */
+static unsigned int
+idpool_seg_get(struct rte_idpool_segment *s, uint32_t *ids, unsigned int n)
+{
+	uint64_t word, left, taken;
+	uint32_t start, w, i;
+	unsigned int count = 0, k;
+
+	if (s->nb_words == 0)
+		return 0;
+
+	start = rte_atomic_load_explicit(&s->hint, rte_memory_order_relaxed);
+	w = start;
+	for (i = 0; i < s->nb_words && count < n; i++) {
+		w = start + i < s->nb_words ? start + i : start + i - s->nb_words;
+		word = rte_atomic_load_explicit(&s->bitmap[w],
+				rte_memory_order_relaxed);
+		do {
+			if (word == 0)
+				break;
+			/* Clear the lowest set bits, as many as IDs missing */
+			left = 0;
+			if ((unsigned int)rte_popcount64(word) > n - count) {
+				left = word;
+				for (k = count; k < n; k++)
+					left &= left - 1;
+			}
+		} while (!rte_atomic_compare_exchange_weak_explicit(
+				&s->bitmap[w], &word, left,
+				rte_memory_order_acquire,
+				rte_memory_order_relaxed));
+		if (word == 0)
+			continue;
+
+		taken = word & ~left;
+		while (taken != 0) {
+			ids[count++] = s->first_id + w * IDPOOL_WORD_IDS +
+				rte_ctz64(taken);
+			taken &= taken - 1;
+		}
+		if (left == 0 && ++w == s->nb_words)
+			w = 0;
+	}
+
+	/* Next search starts from the last word with IDs */
+	if (w != start)
+		rte_atomic_store_explicit(&s->hint, w,
+				rte_memory_order_relaxed);
+
+	return count;
+}
+
+/* Take up to n free IDs, from the range of the lcore socket first. */
+static unsigned int
+idpool_get_ids(struct rte_idpool *p, uint32_t *ids, unsigned int n)
+{
+	unsigned int socket_id = rte_socket_id();
+	unsigned int count, seg, i;
+
+	seg = socket_id < RTE_MAX_NUMA_NODES ? p->socket_seg[socket_id] : 0;
+	count = idpool_seg_get(&p->segs[seg], ids, n);
+	for (i = 1; i < p->nb_segs && count < n; i++) {
+		if (++seg == p->nb_segs)
+			seg = 0;
+		count += idpool_seg_get(&p->segs[seg], &ids[count], n - count);
+	}
+
+	return count;
+}
+
+/* Set the bits of the IDs, a single atomic operation per word. */
+static void
+idpool_put_ids(struct rte_idpool *p, const uint32_t *ids, unsigned int n)
+{
+	struct rte_idpool_segment *s;
+	uint64_t mask, old __rte_unused;
+	uint32_t id, w;
+	unsigned int i = 0;
+
+	while (i < n) {
+		id = ids[i];
+		RTE_ASSERT(id < p->nb_ids);
+		mask = RTE_BIT64(id % IDPOOL_WORD_IDS);
+		/* The ranges are made of whole words */
+		while (++i < n &&
+		       ids[i] / IDPOOL_WORD_IDS == id / IDPOOL_WORD_IDS)
+			mask |= RTE_BIT64(ids[i] % IDPOOL_WORD_IDS);
+
+		s = &p->segs[id / p->seg_ids];
+		w = (id - s->first_id) / IDPOOL_WORD_IDS;
+		old = rte_atomic_fetch_or_explicit(&s->bitmap[w], mask,
+				rte_memory_order_release);
+		RTE_ASSERT((old & mask) == 0);
+	}
+}
+
+int
+rte_idpool_generic_get(struct rte_idpool *p, struct rte_idpool_cache *cache,
+		       uint32_t *ids, unsigned int n)
+{
+	unsigned int count;
+
+	/* No cache or too many IDs: get them from the bitmap */
+	if (cache == NULL || n > cache->size) {
+		count = idpool_get_ids(p, ids, n);
+		if (unlikely(count < n)) {
+			idpool_put_ids(p, ids, count);
+			return -ENOENT;
+		}
+		return 0;
+	}
+
+	/* Refill the cache, to half of its size or the IDs requested */
+	cache->len += idpool_get_ids(p, &cache->objs[cache->len],
+			RTE_MAX(cache->size / 2, n) - cache->len);
+	if (unlikely(cache->len < n))
+		return -ENOENT;
+
+	cache->len -= n;
+	memcpy(ids, &cache->objs[cache->len], n * sizeof(*ids));
+	return 0;
+}
+
+void
+rte_idpool_generic_put(struct rte_idpool *p, struct rte_idpool_cache *cache,
+		       const uint32_t *ids, unsigned int n)
+{
+	unsigned int excess;
+
+	/* No cache or too many IDs: put them in the bitmap */
+	if (cache == NULL || n > cache->size) {
+		idpool_put_ids(p, ids, n);
+		return;
+	}
+
+	/* Flush the coldest IDs, down to half of the cache size */
+	excess = cache->len + n - RTE_MAX(cache->size / 2, n);
+	idpool_put_ids(p, cache->objs, excess);
+	cache->len -= excess;
+	memmove(cache->objs, &cache->objs[excess],
+		cache->len * sizeof(cache->objs[0]));
+
+	memcpy(&cache->objs[cache->len], ids, n * sizeof(*ids));
+	cache->len += n;
+}
+
+static void
+idpool_free_bitmaps(struct rte_idpool *p)
+{
+	unsigned int i;
+
+	for (i = 0; i < p->nb_segs; i++)
+		rte_free((void *)(uintptr_t)p->segs[i].bitmap);
+}
+
+static int
+idpool_init(struct rte_idpool *p, uint32_t nb_ids, uint32_t cache_size,
+	    int socket_id, uint32_t flags)
+{
+	struct rte_idpool_segment *s;
+	unsigned int i, lcore_id;
+
+	p->nb_ids = nb_ids;
+	p->cache_size = cache_size;
+	p->flags = flags;
+	p->nb_segs = (flags & RTE_IDPOOL_F_NUMA) ? rte_socket_count() : 1;
+	p->seg_ids = RTE_ALIGN_CEIL((nb_ids + p->nb_segs - 1) / p->nb_segs,
+			(uint32_t)IDPOOL_WORD_IDS);
+
+	for (i = 0; i < p->nb_segs; i++) {
+		s = &p->segs[i];
+		s->first_id = i * p->seg_ids;
+		s->nb_words = (idpool_seg_nb_ids(p, i) + IDPOOL_WORD_IDS - 1) /
+			IDPOOL_WORD_IDS;
+		s->socket_id = (flags & RTE_IDPOOL_F_NUMA) ?
+			rte_socket_id_by_idx(i) : socket_id;
+		if (flags & RTE_IDPOOL_F_NUMA)
+			p->socket_seg[s->socket_id] = i;
+		if (s->nb_words == 0)
+			continue;
+
+		s->bitmap = rte_zmalloc_socket("IDPOOL_BITMAP",
+				s->nb_words * sizeof(s->bitmap[0]),
+				RTE_CACHE_LINE_SIZE, s->socket_id);
+		if (s->bitmap == NULL) {
+			IDPOOL_LOG(ERR, "Cannot allocate bitmap on socket %d",
+				   s->socket_id);
+			idpool_free_bitmaps(p);
+			return -ENOMEM;
+		}
+		idpool_seg_fill(p, i);
+	}
+
+	if (cache_size != 0) {
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			p->local_cache[lcore_id].size = cache_size;
+	}
+
+	return 0;
+}
+
+struct rte_idpool *
+rte_idpool_create(const char *name, uint32_t nb_ids, uint32_t cache_size,
+		  int socket_id, uint32_t flags)
+{
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	struct rte_idpool_list *idpool_list;
+	const struct rte_memzone *mz;
+	struct rte_tailq_entry *te;
+	struct rte_idpool *p;
+	size_t sz;
+	int ret;
+
+	if (name == NULL || nb_ids == 0 ||
+	    cache_size > RTE_IDPOOL_CACHE_MAX_SIZE ||
+	    (flags & ~RTE_IDPOOL_F_NUMA) != 0) {
+		IDPOOL_LOG(ERR, "Invalid parameters");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	sz = sizeof(*p);
+	if (cache_size != 0)
+		sz += RTE_MAX_LCORE * sizeof(p->local_cache[0]);
+
+	ret = snprintf(mz_name, sizeof(mz_name), "%s%s",
+		       RTE_IDPOOL_MZ_PREFIX, name);
+	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	te = rte_zmalloc("IDPOOL_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		IDPOOL_LOG(ERR, "Cannot reserve memory for tailq");
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	rte_mcfg_tailq_write_lock();
+
+	mz = rte_memzone_reserve_aligned(mz_name, sz, socket_id,
+					 0, __alignof__(*p));
+	if (mz == NULL) {
+		IDPOOL_LOG(ERR, "Cannot reserve ID pool memzone");
+		rte_mcfg_tailq_write_unlock();
+		rte_free(te);
+		return NULL;
+	}
+
+	p = mz->addr;
+	memset(p, 0, sz);
+	strlcpy(p->name, name, sizeof(p->name));
+	p->memzone = mz;
+
+	ret = idpool_init(p, nb_ids, cache_size, socket_id, flags);
+	if (ret < 0) {
+		rte_mcfg_tailq_write_unlock();
+		rte_errno = -ret;
+		rte_free(te);
+		rte_memzone_free(mz);
+		return NULL;
+	}
+
+	te->data = p;
+
+	idpool_list = RTE_TAILQ_CAST(rte_idpool_tailq.head, rte_idpool_list);
+
+	TAILQ_INSERT_TAIL(idpool_list, te, next);
+
+	rte_mcfg_tailq_write_unlock();
+
+	return p;
+}
+
+void
+rte_idpool_free(struct rte_idpool *p)
+{
+	struct rte_idpool_list *idpool_list;
+	struct rte_tailq_entry *te;
+
+	if (p == NULL)
+		return;
+
+	idpool_list = RTE_TAILQ_CAST(rte_idpool_tailq.head, rte_idpool_list);
+	rte_mcfg_tailq_write_lock();
+
+	/* find out tailq entry */
+	TAILQ_FOREACH(te, idpool_list, next) {
+		if (te->data == p)
+			break;
+	}
+
+	if (te == NULL) {
+		rte_mcfg_tailq_write_unlock();
+		return;
+	}
+
+	TAILQ_REMOVE(idpool_list, te, next);
+
+	rte_mcfg_tailq_write_unlock();
+
+	rte_free(te);
+
+	idpool_free_bitmaps(p);
+	rte_memzone_free(p->memzone);
+}
+
+struct rte_idpool *
+rte_idpool_lookup(const char *name)
+{
+	struct rte_idpool_list *idpool_list;
+	struct rte_tailq_entry *te;
+	struct rte_idpool *p = NULL;
+
+	if (name == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	idpool_list = RTE_TAILQ_CAST(rte_idpool_tailq.head, rte_idpool_list);
+
+	rte_mcfg_tailq_read_lock();
+
+	TAILQ_FOREACH(te, idpool_list, next) {
+		p = (struct rte_idpool *) te->data;
+		if (strncmp(name, p->name, RTE_IDPOOL_NAMESIZE) == 0)
+			break;
+	}
+
+	rte_mcfg_tailq_read_unlock();
+
+	if (te == NULL) {
+		rte_errno = ENOENT;
+		return NULL;
+	}
+
+	return p;
+}
+
+void
+rte_idpool_reset(struct rte_idpool *p)
+{
+	unsigned int i, lcore_id;
+
+	for (i = 0; i < p->nb_segs; i++)
+		idpool_seg_fill(p, i);
+
+	if (p->cache_size != 0) {
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			p->local_cache[lcore_id].len = 0;
+	}
+}
+
+unsigned int
+rte_idpool_avail_count(const struct rte_idpool *p)
+{
+	const struct rte_idpool_segment *s;
+	unsigned int count = 0, i, lcore_id;
+	uint32_t w;
+
+	for (i = 0; i < p->nb_segs; i++) {
+		s = &p->segs[i];
+		for (w = 0; w < s->nb_words; w++)
+			count += rte_popcount64(rte_atomic_load_explicit(
+					&s->bitmap[w],
+					rte_memory_order_relaxed));
+	}
+
+	if (p->cache_size != 0) {
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			count += p->local_cache[lcore_id].len;
+	}
+
+	return count;
+}
@@ -0,0 +1,331 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef _RTE_IDPOOL_H_
+#define _RTE_IDPOOL_H_
+
+/**
+ * @file rte_idpool.h
+ *
+ * RTE ID Pool.
+ *
+ * librte_idpool provides an allocator of integer identifiers, from 0 to the
+ * size of the pool minus one, such as flow, session or table slot indexes.
+ * Get and put operations are MT-safe and lock-free.
+ *
+ * The free IDs are kept in a bitmap, a set bit per free ID. Getting IDs
+ * clears up to 64 bits of a bitmap word with a single compare-and-swap, and
+ * putting back the IDs of a same word sets them with a single atomic OR,
+ * instead of one ring or stack operation per ID. Each lcore also keeps a
+ * cache of IDs, as a mempool does, so that most operations do not touch
+ * the shared bitmap at all.
+ *
+ * With the RTE_IDPOOL_F_NUMA flag, the IDs are split in one range per
+ * socket, whose bitmap is allocated on that socket. An lcore gets its IDs
+ * from the range of its socket first.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_lcore.h>
+#include <rte_memzone.h>
+#include <rte_stdatomic.h>
+
+#define RTE_TAILQ_IDPOOL_NAME "RTE_IDPOOL"
+#define RTE_IDPOOL_MZ_PREFIX "ID_"
+/** The maximum length of an ID pool name. */
+#define RTE_IDPOOL_NAMESIZE (RTE_MEMZONE_NAMESIZE - \
+			     sizeof(RTE_IDPOOL_MZ_PREFIX) + 1)
+
+/** Maximum size of the per-lcore cache of IDs. */
+#define RTE_IDPOOL_CACHE_MAX_SIZE 256
+
+/**
+ * The IDs are split in one range per socket, each served first to the
+ * lcores of its socket.
+ */
+#define RTE_IDPOOL_F_NUMA 0x0001
+
+/**
+ * @internal Range of IDs, with the bitmap of its free IDs.
+ */
+struct rte_idpool_segment {
+	RTE_ATOMIC(uint64_t) *bitmap; /**< A set bit per free ID. */
+	uint32_t first_id;            /**< First ID of the range. */
+	uint32_t nb_words;            /**< Number of words of the bitmap. */
+	RTE_ATOMIC(uint32_t) hint;    /**< Word to start searching from. */
+	int socket_id;                /**< Socket of the bitmap memory. */
+};
+
+/**
+ * @internal Per-lcore cache of free IDs.
+ */
+struct rte_idpool_cache {
+	uint32_t size; /**< Maximum number of cached IDs. */
+	uint32_t len;  /**< Number of cached IDs, the last is the hottest. */
+	uint32_t objs[RTE_IDPOOL_CACHE_MAX_SIZE]; /**< Cached IDs. */
+} __rte_cache_aligned;
+
+/**
+ * The RTE ID pool structure.
+ */
+struct rte_idpool {
+	/** Name of the ID pool. */
+	char name[RTE_IDPOOL_NAMESIZE] __rte_cache_aligned;
+	/** Memzone containing the rte_idpool structure. */
+	const struct rte_memzone *memzone;
+	uint32_t nb_ids;      /**< Number of IDs. */
+	uint32_t cache_size;  /**< Size of the per-lcore caches. */
+	uint32_t flags;       /**< Flags supplied at creation. */
+	uint32_t nb_segs;     /**< Number of ID ranges. */
+	uint32_t seg_ids;     /**< Number of IDs per range, a multiple of 64. */
+	/** Range served first, indexed by socket identifier. */
+	uint8_t socket_seg[RTE_MAX_NUMA_NODES];
+	/** Ranges of IDs. */
+	struct rte_idpool_segment segs[RTE_MAX_NUMA_NODES];
+	/** Per-lcore caches, if cache_size is not zero. */
+	struct rte_idpool_cache local_cache[] __rte_cache_aligned;
+} __rte_cache_aligned;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a new ID pool in memory, with all its IDs free.
+ *
+ * @param name
+ *   The name of the ID pool.
+ * @param nb_ids
+ *   The number of IDs, from 0 to nb_ids - 1.
+ * @param cache_size
+ *   The maximum number of IDs cached by each lcore, up to
+ *   RTE_IDPOOL_CACHE_MAX_SIZE, or zero to disable the caches. The IDs
+ *   cached by the other lcores cannot be allocated: they must be taken
+ *   into account in the number of IDs.
+ * @param socket_id
+ *   The socket identifier on which the ID pool is allocated, or
+ *   SOCKET_ID_ANY.
+ * @param flags
+ *   0, or RTE_IDPOOL_F_NUMA to split the IDs between the sockets, the
+ *   bitmap of each range being allocated on its socket.
+ * @return
+ *   On success, the pointer to the new allocated ID pool. NULL on error
+ *   with rte_errno set appropriately. Possible errno values include:
+ *    - EINVAL - invalid parameter passed to function
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - an ID pool with the same name already exists
+ *    - ENOMEM - insufficient memory to create the ID pool
+ *    - ENAMETOOLONG - name size exceeds RTE_IDPOOL_NAMESIZE
+ */
+__rte_experimental
+struct rte_idpool *
+rte_idpool_create(const char *name, uint32_t nb_ids, uint32_t cache_size,
+		  int socket_id, uint32_t flags);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free all memory used by an ID pool.
+ *
+ * @param p
+ *   The ID pool to free. If NULL then, the function does nothing.
+ */
+__rte_experimental
+void
+rte_idpool_free(struct rte_idpool *p);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Lookup an ID pool by its name.
+ *
+ * @param name
+ *   The name of the ID pool.
+ * @return
+ *   The pointer to the ID pool matching the name, or NULL if not found,
+ *   with rte_errno set appropriately. Possible rte_errno values include:
+ *    - ENOENT - Required ID pool not available.
+ *    - EINVAL - The name parameter is NULL.
+ */
+__rte_experimental
+struct rte_idpool *
+rte_idpool_lookup(const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Make all the IDs of a pool free again, including the cached ones.
+ *
+ * This function is not MT-safe: no other thread may use the pool meanwhile.
+ *
+ * @param p
+ *   A pointer to the ID pool.
+ */
+__rte_experimental
+void
+rte_idpool_reset(struct rte_idpool *p);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Return the number of free IDs of a pool, including the cached ones.
+ *
+ * When the pool is in use, the returned value is only a snapshot.
+ *
+ * @param p
+ *   A pointer to the ID pool.
+ * @return
+ *   The number of free IDs.
+ */
+__rte_experimental
+unsigned int
+rte_idpool_avail_count(const struct rte_idpool *p);
+
+/**
+ * @internal Get IDs when the lcore cache cannot serve them alone.
+ */
+int
+rte_idpool_generic_get(struct rte_idpool *p, struct rte_idpool_cache *cache,
+		       uint32_t *ids, unsigned int n);
+
+/**
+ * @internal Put IDs when the lcore cache cannot hold them all.
+ */
+void
+rte_idpool_generic_put(struct rte_idpool *p, struct rte_idpool_cache *cache,
+		       const uint32_t *ids, unsigned int n);
+
+/**
+ * @internal Get the cache of an lcore, or NULL if it has none.
+ */
+static __rte_always_inline struct rte_idpool_cache *
+__rte_idpool_cache(struct rte_idpool *p, unsigned int lcore_id)
+{
+	if (p->cache_size == 0 || lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+	return &p->local_cache[lcore_id];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get several IDs from a pool (MT-safe).
+ *
+ * The bitmap is scanned once: when nearly all the IDs are in use, the IDs
+ * put concurrently behind the scan may be missed. The IDs held in the
+ * caches of the other lcores are not available either.
+ *
+ * @param p
+ *   A pointer to the ID pool.
+ * @param ids
+ *   A pointer to a table of IDs that will be filled.
+ * @param n
+ *   The number of IDs to get.
+ * @return
+ *   - 0: Success; IDs taken.
+ *   - -ENOENT: Not enough free IDs; no ID is taken.
+ */
+__rte_experimental
+static __rte_always_inline int
+rte_idpool_get_bulk(struct rte_idpool *p, uint32_t *ids, unsigned int n)
+{
+	struct rte_idpool_cache *cache = __rte_idpool_cache(p, rte_lcore_id());
+
+	if (likely(cache != NULL && n <= RTE_IDPOOL_CACHE_MAX_SIZE &&
+		   n <= cache->len)) {
+		cache->len -= n;
+		memcpy(ids, &cache->objs[cache->len], n * sizeof(*ids));
+		return 0;
+	}
+
+	return rte_idpool_generic_get(p, cache, ids, n);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get one ID from a pool (MT-safe).
+ *
+ * @param p
+ *   A pointer to the ID pool.
+ * @param id
+ *   A pointer to the ID that will be filled.
+ * @return
+ *   - 0: Success; ID taken.
+ *   - -ENOENT: No free ID.
+ */
+__rte_experimental
+static __rte_always_inline int
+rte_idpool_get(struct rte_idpool *p, uint32_t *id)
+{
+	return rte_idpool_get_bulk(p, id, 1);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Put several IDs back in a pool (MT-safe).
+ *
+ * The IDs must have been taken from this pool, and not be put twice.
+ *
+ * @param p
+ *   A pointer to the ID pool.
+ * @param ids
+ *   A pointer to a table of IDs.
+ * @param n
+ *   The number of IDs to put.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_idpool_put_bulk(struct rte_idpool *p, const uint32_t *ids, unsigned int n)
+{
+	struct rte_idpool_cache *cache = __rte_idpool_cache(p, rte_lcore_id());
+
+	if (likely(cache != NULL && cache->len + n <= cache->size)) {
+		memcpy(&cache->objs[cache->len], ids, n * sizeof(*ids));
+		cache->len += n;
+		return;
+	}
+
+	rte_idpool_generic_put(p, cache, ids, n);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Put one ID back in a pool (MT-safe).
+ *
+ * @param p
+ *   A pointer to the ID pool.
+ * @param id
+ *   The ID to put.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_idpool_put(struct rte_idpool *p, uint32_t id)
+{
+	rte_idpool_put_bulk(p, &id, 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_IDPOOL_H_ */
@@ -363,6 +363,41 @@ rte_pktmbuf_pool_create_extbuf(const char *name, unsigned int n,
 	return mp;
 }
 
+int
+rte_pktmbuf_rearm_template_init(struct rte_mbuf_rearm_template *tmpl,
+	struct rte_mempool *mp, uint16_t port)
+{
+	struct rte_mbuf m;
+
+	/* The template must cover the fields reset by rte_pktmbuf_reset() */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, rearm_data) % 16 != 0);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_off) <
+			 offsetof(struct rte_mbuf, rearm_data));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, vlan_tci) +
+			 sizeof(m.vlan_tci) >
+			 offsetof(struct rte_mbuf, rearm_data) +
+			 sizeof(tmpl->data));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, rearm_data) +
+			 sizeof(tmpl->data) >
+			 offsetof(struct rte_mbuf, vlan_tci_outer));
+
+	if (tmpl == NULL || mp == NULL ||
+	    mp->private_data_size < sizeof(struct rte_pktmbuf_pool_private))
+		return -EINVAL;
+
+	memset(&m, 0, sizeof(m));
+	m.buf_len = rte_pktmbuf_data_room_size(mp);
+	rte_pktmbuf_reset_headroom(&m);
+	rte_mbuf_refcnt_set(&m, 1);
+	m.nb_segs = 1;
+	m.port = port;
+	if (rte_pktmbuf_priv_flags(mp) & RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF)
+		m.ol_flags = RTE_MBUF_F_EXTERNAL;
+
+	memcpy(tmpl->data, &m.rearm_data, sizeof(tmpl->data));
+	return 0;
+}
+
 /* do some sanity checks on a mbuf: panic if it fails */
 void
 rte_mbuf_sanity_check(const struct rte_mbuf *m, int is_header)
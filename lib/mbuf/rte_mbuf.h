@@ -40,6 +40,7 @@
 #include <rte_branch_prediction.h>
 #include <rte_mbuf_ptype.h>
 #include <rte_mbuf_core.h>
+#include <rte_vect.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -965,6 +966,112 @@ static inline int rte_pktmbuf_alloc_bulk(struct rte_mempool *pool,
 	return 0;
 }
 
+/**
+ * Image of the fields of a packet mbuf set on allocation by
+ * rte_pktmbuf_alloc_bulk_rearm(): the 32 bytes starting at rearm_data,
+ * that is data_off, refcnt, nb_segs, port, ol_flags, packet_type,
+ * pkt_len, data_len, vlan_tci and hash.rss.
+ */
+struct rte_mbuf_rearm_template {
+	uint64_t data[4]; /**< Values of the fields, as laid out in the mbuf. */
+} __rte_aligned(16);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize the rearm template of a packet mbuf pool.
+ *
+ * The template holds the values given by rte_pktmbuf_reset() to the
+ * fields it covers, and the given input port.
+ *
+ * @param tmpl
+ *   The template to initialize.
+ * @param mp
+ *   The packet mbuf pool the template is used with.
+ * @param port
+ *   The input port of the mbufs, or RTE_MBUF_PORT_INVALID.
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: tmpl or mp is NULL, or mp is not a packet mbuf pool.
+ */
+__rte_experimental
+int rte_pktmbuf_rearm_template_init(struct rte_mbuf_rearm_template *tmpl,
+	struct rte_mempool *mp, uint16_t port);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allocate a bulk of mbufs and initialize them with a rearm template.
+ *
+ * This is a faster alternative to rte_pktmbuf_alloc_bulk() for the receive
+ * path of drivers: the fields covered by the template are written with
+ * two 16-byte (or one 32-byte) vector stores, without reading the mbufs.
+ * As on the receive path of the vectorized drivers, tx_offload,
+ * vlan_tci_outer and the rest of the hash are not reset; next is NULL
+ * for any mbuf in a mempool.
+ *
+ * @param pool
+ *   The mempool from which mbufs are allocated.
+ * @param mbufs
+ *   Array of pointers to mbufs
+ * @param count
+ *   Array size
+ * @param tmpl
+ *   The rearm template of the pool, see rte_pktmbuf_rearm_template_init().
+ * @return
+ *   - 0: Success
+ *   - -ENOENT: Not enough entries in the mempool; no mbufs are retrieved.
+ */
+__rte_experimental
+static inline int rte_pktmbuf_alloc_bulk_rearm(struct rte_mempool *pool,
+	struct rte_mbuf **mbufs, unsigned int count,
+	const struct rte_mbuf_rearm_template *tmpl)
+{
+#if defined(RTE_ARCH_X86) && defined(__AVX__)
+	/* The template is only guaranteed to be 16-byte aligned */
+	const __m256i t = _mm256_loadu_si256((const __m256i *)tmpl->data);
+#elif defined(RTE_ARCH_X86)
+	const __m128i t0 = _mm_load_si128((const __m128i *)&tmpl->data[0]);
+	const __m128i t1 = _mm_load_si128((const __m128i *)&tmpl->data[2]);
+#elif defined(RTE_ARCH_ARM64)
+	const uint64x2_t t0 = vld1q_u64(&tmpl->data[0]);
+	const uint64x2_t t1 = vld1q_u64(&tmpl->data[2]);
+#else
+	const uint64_t t0 = tmpl->data[0], t1 = tmpl->data[1];
+	const uint64_t t2 = tmpl->data[2], t3 = tmpl->data[3];
+#endif
+	unsigned int idx;
+	void *rearm;
+	int rc;
+
+	rc = rte_mempool_get_bulk(pool, (void **)mbufs, count);
+	if (unlikely(rc))
+		return rc;
+
+	for (idx = 0; idx != count; idx++) {
+		__rte_mbuf_raw_sanity_check(mbufs[idx]);
+		/* 16-byte aligned, as mbufs are cache line aligned */
+		rearm = &mbufs[idx]->rearm_data;
+#if defined(RTE_ARCH_X86) && defined(__AVX__)
+		_mm256_storeu_si256((__m256i *)rearm, t);
+#elif defined(RTE_ARCH_X86)
+		_mm_store_si128((__m128i *)rearm, t0);
+		_mm_store_si128((__m128i *)rearm + 1, t1);
+#elif defined(RTE_ARCH_ARM64)
+		vst1q_u64((uint64_t *)rearm, t0);
+		vst1q_u64((uint64_t *)rearm + 2, t1);
+#else
+		((uint64_t *)rearm)[0] = t0;
+		((uint64_t *)rearm)[1] = t1;
+		((uint64_t *)rearm)[2] = t2;
+		((uint64_t *)rearm)[3] = t3;
+#endif
+	}
+	return 0;
+}
+
 /**
  * Initialize shared data at the end of an external buffer before attaching
  * to a mbuf by ``rte_pktmbuf_attach_extbuf()``. This is not a mandatory
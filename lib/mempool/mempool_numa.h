@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef MEMPOOL_NUMA_H
+#define MEMPOOL_NUMA_H
+
+/**
+ * @file
+ *
+ * Internal functions for mempools created with RTE_MEMPOOL_F_NUMA
+ */
+
+#include <stdio.h>
+
+#include "rte_mempool.h"
+
+/* Create a mempool backed by one sub-pool per socket. */
+struct rte_mempool *
+mempool_numa_create(const char *name, unsigned int n, unsigned int elt_size,
+	unsigned int cache_size, unsigned int private_data_size,
+	rte_mempool_ctor_t *mp_init, void *mp_init_arg,
+	rte_mempool_obj_cb_t *obj_init, void *obj_init_arg,
+	int socket_id, unsigned int flags);
+
+/* Dump the sub-pools and the cross-socket statistics. */
+void
+mempool_numa_dump(FILE *f, const struct rte_mempool *mp);
+
+#endif /* MEMPOOL_NUMA_H */
@@ -28,6 +28,7 @@
 #include <rte_eal_paging.h>
 #include <rte_telemetry.h>
 
+#include "mempool_numa.h"
 #include "mempool_trace.h"
 #include "rte_mempool.h"
 
@@ -52,6 +53,11 @@ mempool_event_callback_invoke(enum rte_mempool_event event,
 #define CALC_CACHE_FLUSHTHRESH(c)	\
 	((typeof(c))((c) * CACHE_FLUSHTHRESH_MULTIPLIER))
 
+/* Initial and minimum size of an adaptive cache */
+#define CACHE_ADAPT_MIN_SIZE 32
+/* An adaptive cache grows when more than 1/32 of its requests miss */
+#define CACHE_ADAPT_GROW_MISSES (RTE_MEMPOOL_CACHE_ADAPT_WINDOW / 32)
+
 #if defined(RTE_ARCH_X86)
 /*
  * return the greatest common divisor between a and b (fast algorithm)
@@ -743,16 +749,70 @@ rte_mempool_free(struct rte_mempool *mp)
 }
 
 static void
-mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
+mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size,
+		   bool adaptive)
 {
 	/* Check that cache have enough space for flush threshold */
 	RTE_BUILD_BUG_ON(CALC_CACHE_FLUSHTHRESH(RTE_MEMPOOL_CACHE_MAX_SIZE) >
 			 RTE_SIZEOF_FIELD(struct rte_mempool_cache, objs) /
 			 RTE_SIZEOF_FIELD(struct rte_mempool_cache, objs[0]));
+	RTE_BUILD_BUG_ON(RTE_MEMPOOL_CACHE_ADAPT_WINDOW >
+			 UINT16_MAX);
+
+	/* An adaptive cache starts small and grows up to the given size */
+	cache->max_size = adaptive ? size : 0;
+	if (adaptive)
+		size = RTE_MIN(size, (uint32_t)CACHE_ADAPT_MIN_SIZE);
 
 	cache->size = size;
 	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
 	cache->len = 0;
+	cache->adapt_ops = 0;
+	cache->adapt_misses = 0;
+	cache->adapt_low = 0;
+	cache->adapt_bulk = 0;
+}
+
+/*
+ * Resize an adaptive cache from what was observed during the last window:
+ * double it when the common pool was accessed too often, halve it when
+ * at least half of the cached objects were never used. It is not made
+ * smaller than the largest request which missed.
+ */
+void
+rte_mempool_cache_adapt(struct rte_mempool *mp,
+			struct rte_mempool_cache *cache)
+{
+	uint32_t size = cache->size;
+	uint32_t min_size, excess;
+
+	if (cache->adapt_misses > CACHE_ADAPT_GROW_MISSES)
+		size = RTE_MIN(size * 2, cache->max_size);
+	else if (RTE_MIN(cache->adapt_low, cache->len) >= size / 2)
+		size /= 2;
+
+	min_size = RTE_MAX(cache->adapt_bulk, (uint32_t)CACHE_ADAPT_MIN_SIZE);
+	size = RTE_MAX(size, RTE_MIN(min_size, cache->max_size));
+	if (size == cache->size)
+		goto reset;
+
+	cache->size = size;
+	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
+
+	/* Give the coldest objects, at the bottom of the stack, back */
+	if (cache->len > size) {
+		excess = cache->len - size;
+		rte_mempool_ops_enqueue_bulk(mp, cache->objs, excess);
+		memmove(cache->objs, &cache->objs[excess],
+			sizeof(void *) * size);
+		cache->len = size;
+	}
+
+reset:
+	cache->adapt_ops = 0;
+	cache->adapt_misses = 0;
+	cache->adapt_low = cache->len;
+	cache->adapt_bulk = 0;
 }
 
 /*
@@ -778,7 +838,7 @@ rte_mempool_cache_create(uint32_t size, int socket_id)
 		return NULL;
 	}
 
-	mempool_cache_init(cache, size);
+	mempool_cache_init(cache, size, false);
 
 	rte_mempool_trace_cache_create(size, socket_id, cache);
 	return cache;
@@ -846,6 +906,12 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		return NULL;
 	}
 
+	/* sub-pools are populated by rte_mempool_create() */
+	if (flags & RTE_MEMPOOL_F_NUMA) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
 	/*
 	 * No objects in the pool can be used for IO until it's populated
 	 * with at least some objects with valid IOVA.
@@ -941,7 +1007,8 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 	if (cache_size != 0) {
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
-					   cache_size);
+				cache_size,
+				(flags & RTE_MEMPOOL_F_CACHE_ADAPTIVE) != 0);
 	}
 
 	te->data = mp;
@@ -972,6 +1039,17 @@ rte_mempool_create(const char *name, unsigned n, unsigned elt_size,
 {
 	struct rte_mempool *mp;
 
+	if (flags & RTE_MEMPOOL_F_NUMA) {
+		mp = mempool_numa_create(name, n, elt_size, cache_size,
+			private_data_size, mp_init, mp_init_arg, obj_init,
+			obj_init_arg, socket_id, flags);
+		if (mp != NULL)
+			rte_mempool_trace_create(name, n, elt_size, cache_size,
+				private_data_size, mp_init, mp_init_arg,
+				obj_init, obj_init_arg, flags, mp);
+		return mp;
+	}
+
 	mp = rte_mempool_create_empty(name, n, elt_size, cache_size,
 		private_data_size, socket_id, flags);
 	if (mp == NULL)
@@ -1047,6 +1125,9 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		cache_count = mp->local_cache[lcore_id].len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
+		if (mp->flags & RTE_MEMPOOL_F_CACHE_ADAPTIVE)
+			fprintf(f, "    cache_size[%u]=%"PRIu32"\n", lcore_id,
+				mp->local_cache[lcore_id].size);
 		count += cache_count;
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
@@ -1069,6 +1150,10 @@ void rte_mempool_check_cookies(const struct rte_mempool *mp,
 	void *obj;
 	void **obj_table;
 
+	/* Objects are checked by the sub-pool owning them */
+	if (mp->flags & RTE_MEMPOOL_F_NUMA)
+		return;
+
 	/* Force to drop the "const" attribute. This is done only when
 	 * DEBUG is enabled */
 	tmp = (void *) obj_table_const;
@@ -1169,6 +1254,10 @@ mempool_audit_cookies(struct rte_mempool *mp)
 {
 	unsigned num;
 
+	/* Objects are audited with the sub-pool owning them */
+	if (mp->flags & RTE_MEMPOOL_F_NUMA)
+		return;
+
 	num = rte_mempool_obj_iter(mp, mempool_obj_audit, NULL);
 	if (num != mp->size) {
 		rte_panic("rte_mempool_obj_iter(mempool=%p, size=%u) "
@@ -1267,6 +1356,9 @@ rte_mempool_dump(FILE *f, struct rte_mempool *mp)
 		common_count = mp->size - cache_count;
 	fprintf(f, "  common_pool_count=%u\n", common_count);
 
+	if (mp->flags & RTE_MEMPOOL_F_NUMA)
+		mempool_numa_dump(f, mp);
+
 	/* sum and dump statistics */
 #ifdef RTE_LIBRTE_MEMPOOL_STATS
 	rte_mempool_ops_get_info(mp, &info);
@@ -1554,10 +1646,77 @@ mempool_handle_info(const char *cmd __rte_unused, const char *params,
 	return 0;
 }
 
+static void
+mempool_cache_cb(struct rte_mempool *mp, void *arg)
+{
+	struct mempool_info_cb_arg *info = (struct mempool_info_cb_arg *)arg;
+	const struct rte_mempool_cache *cache;
+	char lcore_name[RTE_TEL_MAX_STRING_LEN];
+	struct rte_tel_data *c;
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+	uint64_t ops, misses;
+#endif
+	unsigned int lcore_id;
+
+	if (strncmp(mp->name, info->pool_name, RTE_MEMZONE_NAMESIZE))
+		return;
+
+	rte_tel_data_add_dict_string(info->d, "name", mp->name);
+	rte_tel_data_add_dict_uint(info->d, "cache_size", mp->cache_size);
+	rte_tel_data_add_dict_uint(info->d, "adaptive",
+		(mp->flags & RTE_MEMPOOL_F_CACHE_ADAPTIVE) != 0);
+	if (mp->cache_size == 0)
+		return;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		cache = &mp->local_cache[lcore_id];
+		c = rte_tel_data_alloc();
+		if (c == NULL)
+			return;
+		rte_tel_data_start_dict(c);
+		rte_tel_data_add_dict_uint(c, "size", cache->size);
+		rte_tel_data_add_dict_uint(c, "flushthresh", cache->flushthresh);
+		rte_tel_data_add_dict_uint(c, "len", cache->len);
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+		/* Requests served without accessing the common pool */
+		ops = cache->stats.get_success_bulk + cache->stats.put_bulk;
+		misses = mp->stats[lcore_id].get_common_pool_bulk +
+			mp->stats[lcore_id].put_common_pool_bulk;
+		rte_tel_data_add_dict_uint(c, "ops", ops);
+		rte_tel_data_add_dict_uint(c, "hit_ratio_pct", ops == 0 ? 0 :
+			(ops - RTE_MIN(misses, ops)) * 100 / ops);
+#endif
+		snprintf(lcore_name, sizeof(lcore_name), "lcore_%u", lcore_id);
+		rte_tel_data_add_dict_container(info->d, lcore_name, c, 0);
+	}
+}
+
+static int
+mempool_handle_cache(const char *cmd __rte_unused, const char *params,
+		     struct rte_tel_data *d)
+{
+	struct mempool_info_cb_arg mp_arg;
+	char name[RTE_MEMZONE_NAMESIZE];
+
+	if (!params || strlen(params) == 0)
+		return -EINVAL;
+
+	rte_strlcpy(name, params, RTE_MEMZONE_NAMESIZE);
+
+	rte_tel_data_start_dict(d);
+	mp_arg.pool_name = name;
+	mp_arg.d = d;
+	rte_mempool_walk(mempool_cache_cb, &mp_arg);
+
+	return 0;
+}
+
 RTE_INIT(mempool_init_telemetry)
 {
 	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
 		"Returns list of available mempool. Takes no parameters");
 	rte_telemetry_register_cmd("/mempool/info", mempool_handle_info,
 		"Returns mempool info. Parameters: pool_name");
+	rte_telemetry_register_cmd("/mempool/cache", mempool_handle_cache,
+		"Returns mempool per-lcore cache occupancy. Parameters: pool_name");
 }
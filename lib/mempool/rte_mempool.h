@@ -82,6 +82,12 @@ struct rte_mempool_debug_stats {
 } __rte_cache_aligned;
 #endif
 
+/**
+ * Number of gets and puts through a cache after which an adaptive cache
+ * re-evaluates its size, see RTE_MEMPOOL_F_CACHE_ADAPTIVE.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_WINDOW 1024
+
 /**
  * A structure that stores a per-core object cache.
  */
@@ -89,6 +95,11 @@ struct rte_mempool_cache {
 	uint32_t size;	      /**< Size of the cache */
 	uint32_t flushthresh; /**< Threshold before we flush excess elements */
 	uint32_t len;	      /**< Current cache count */
+	uint32_t max_size;    /**< Upper bound of size if adaptive, else 0 */
+	uint16_t adapt_ops;   /**< Gets and puts in the adaptation window */
+	uint16_t adapt_misses; /**< Backend accesses in the adaptation window */
+	uint32_t adapt_low;   /**< Lowest cache count in the adaptation window */
+	uint32_t adapt_bulk;  /**< Largest missed request in the window */
 #ifdef RTE_LIBRTE_MEMPOOL_STATS
 	uint32_t unused;
 	/*
@@ -300,6 +311,16 @@ struct rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG	RTE_MEMPOOL_F_NO_IOVA_CONTIG
 /** Internal: no object from the pool can be used for device IO (DMA). */
 #define RTE_MEMPOOL_F_NON_IO		0x0040
+/**
+ * Objects are served by one sub-pool per socket, see rte_mempool_create().
+ * Only supported by rte_mempool_create().
+ */
+#define RTE_MEMPOOL_F_NUMA		0x0080
+/**
+ * The per-lcore caches resize themselves up to the requested cache size,
+ * see rte_mempool_create().
+ */
+#define RTE_MEMPOOL_F_CACHE_ADAPTIVE	0x0100
 
 /**
  * This macro lists all the mempool flags an application may request.
@@ -309,6 +330,8 @@ struct rte_mempool {
 	| RTE_MEMPOOL_F_SP_PUT \
 	| RTE_MEMPOOL_F_SC_GET \
 	| RTE_MEMPOOL_F_NO_IOVA_CONTIG \
+	| RTE_MEMPOOL_F_NUMA \
+	| RTE_MEMPOOL_F_CACHE_ADAPTIVE \
 	)
 
 /**
@@ -1071,6 +1094,24 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - RTE_MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - RTE_MEMPOOL_F_NUMA: If set, the *n* objects are split among one
+ *     sub-pool per socket, named after the mempool and the socket
+ *     identifier, and *socket_id* only places the mempool structure.
+ *     rte_mempool_get() serves objects from the sub-pool of the calling
+ *     lcore socket, falling back on the other sockets when it is empty,
+ *     and rte_mempool_put() returns each object to the sub-pool of its
+ *     home socket. The sub-pools have the requested cache size, while the
+ *     mempool itself has no cache. The object constructor is called with
+ *     the sub-pool owning the object, which is also returned by
+ *     rte_mempool_from_obj(). Cross-socket traffic is reported by
+ *     rte_mempool_dump().
+ *   - RTE_MEMPOOL_F_CACHE_ADAPTIVE: If set, *cache_size* is the maximum
+ *     size of the per-lcore caches rather than their fixed size. Each
+ *     cache starts small and, every RTE_MEMPOOL_CACHE_ADAPT_WINDOW gets
+ *     and puts, doubles its size when the common pool is accessed too
+ *     often, or halves it when most of its objects stayed unused, giving
+ *     the excess objects back to the common pool. The occupancy of the
+ *     caches is reported by the /mempool/cache telemetry command.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1116,7 +1157,7 @@ rte_mempool_create(const char *name, unsigned n, unsigned elt_size,
  *   constraint for the reserved zone.
  * @param flags
  *   Flags controlling the behavior of the mempool. See
- *   rte_mempool_create() for details.
+ *   rte_mempool_create() for details. RTE_MEMPOOL_F_NUMA is not supported.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. See rte_mempool_create() for details.
@@ -1352,6 +1393,54 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal Re-evaluate the size of an adaptive cache at the end of its
+ * adaptation window, and start a new window.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache structure.
+ */
+void rte_mempool_cache_adapt(struct rte_mempool *mp,
+	struct rte_mempool_cache *cache);
+
+/**
+ * @internal Account a get or put through an adaptive cache in its
+ * adaptation window. Must only be called if cache->max_size is not 0.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache structure.
+ */
+static __rte_always_inline void
+rte_mempool_cache_adapt_tick(struct rte_mempool *mp,
+			     struct rte_mempool_cache *cache)
+{
+	if (unlikely(++cache->adapt_ops == RTE_MEMPOOL_CACHE_ADAPT_WINDOW))
+		rte_mempool_cache_adapt(mp, cache);
+}
+
+/**
+ * @internal Account a request of n objects that an adaptive cache could not
+ * serve without accessing the common pool. Does nothing for other caches.
+ *
+ * @param cache
+ *   A pointer to the mempool cache structure.
+ * @param n
+ *   The number of objects requested.
+ */
+static __rte_always_inline void
+rte_mempool_cache_adapt_miss(struct rte_mempool_cache *cache, unsigned int n)
+{
+	if (likely(cache->max_size == 0))
+		return;
+	cache->adapt_misses++;
+	if (n > cache->adapt_bulk)
+		cache->adapt_bulk = n;
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1378,9 +1467,18 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_bulk, 1);
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_objs, n);
 
+	/* The count is at a low point before a put, track it for adaptation */
+	if (unlikely(cache->max_size != 0)) {
+		rte_mempool_cache_adapt_tick(mp, cache);
+		if (cache->len < cache->adapt_low)
+			cache->adapt_low = cache->len;
+	}
+
 	/* The request itself is too big for the cache */
-	if (unlikely(n > cache->flushthresh))
+	if (unlikely(n > cache->flushthresh)) {
+		rte_mempool_cache_adapt_miss(cache, n);
 		goto driver_enqueue_stats_incremented;
+	}
 
 	/*
 	 * The cache follows the following algorithm:
@@ -1393,6 +1491,7 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		cache_objs = &cache->objs[cache->len];
 		cache->len += n;
 	} else {
+		rte_mempool_cache_adapt_miss(cache, n);
 		cache_objs = &cache->objs[0];
 		rte_mempool_ops_enqueue_bulk(mp, cache_objs, cache->len);
 		cache->len = n;
@@ -1508,6 +1607,9 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		goto driver_dequeue;
 	}
 
+	if (unlikely(cache->max_size != 0))
+		rte_mempool_cache_adapt_tick(mp, cache);
+
 	/* The cache is a stack, so copy will be in reverse order. */
 	cache_objs = &cache->objs[cache->len];
 
@@ -1553,6 +1655,12 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		return 0;
 	}
 
+	/* The cache is now empty and the backend has to be accessed */
+	if (unlikely(cache->max_size != 0)) {
+		rte_mempool_cache_adapt_miss(cache, n);
+		cache->adapt_low = 0;
+	}
+
 	/* if dequeue below would overflow mem allocated for cache */
 	if (unlikely(remaining > RTE_MEMPOOL_CACHE_MAX_SIZE))
 		goto driver_dequeue;
@@ -0,0 +1,314 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+
+#include "mempool_numa.h"
+#include "rte_mempool.h"
+
+#define MEMPOOL_NUMA_OPS_NAME "numa"
+
+/* Objects moved by an lcore, split by socket of the objects */
+struct mempool_numa_stats {
+	uint64_t local_get_objs;
+	uint64_t remote_get_objs;
+	uint64_t local_put_objs;
+	uint64_t remote_put_objs;
+} __rte_cache_aligned;
+
+/* Pool data of a mempool created with RTE_MEMPOOL_F_NUMA */
+struct mempool_numa {
+	/* Sub-pools, indexed by socket identifier */
+	struct rte_mempool *pools[RTE_MAX_NUMA_NODES];
+	/* Plus one, for unregistered non-EAL threads */
+	struct mempool_numa_stats stats[RTE_MAX_LCORE + 1];
+};
+
+static inline struct mempool_numa_stats *
+mempool_numa_lcore_stats(struct mempool_numa *mn)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (unlikely(lcore_id >= RTE_MAX_LCORE))
+		lcore_id = RTE_MAX_LCORE;
+
+	return &mn->stats[lcore_id];
+}
+
+static int
+mempool_numa_alloc(struct rte_mempool *mp)
+{
+	struct mempool_numa *mn;
+
+	mn = rte_zmalloc_socket("MEMPOOL_NUMA", sizeof(*mn),
+				RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (mn == NULL)
+		return -ENOMEM;
+
+	mp->pool_data = mn;
+	return 0;
+}
+
+static void
+mempool_numa_free(struct rte_mempool *mp)
+{
+	struct mempool_numa *mn = mp->pool_data;
+	unsigned int i;
+
+	/* The pool data is not allocated yet */
+	if (mn == NULL)
+		return;
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
+		rte_mempool_free(mn->pools[i]);
+	rte_free(mn);
+}
+
+/*
+ * Objects are returned to their home sub-pool, through the cache of this
+ * lcore in that sub-pool. Consecutive objects from the same sub-pool are
+ * put at once.
+ */
+static int
+mempool_numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+		     unsigned int n)
+{
+	struct mempool_numa_stats *stats = mempool_numa_lcore_stats(mp->pool_data);
+	int socket_id = (int)rte_socket_id();
+	struct rte_mempool *home;
+	unsigned int i, j;
+
+	for (i = 0; i < n; i = j) {
+		home = rte_mempool_from_obj(obj_table[i]);
+		for (j = i + 1; j < n; j++)
+			if (rte_mempool_from_obj(obj_table[j]) != home)
+				break;
+
+		rte_mempool_put_bulk(home, &obj_table[i], j - i);
+		if (home->socket_id == socket_id)
+			stats->local_put_objs += j - i;
+		else
+			stats->remote_put_objs += j - i;
+	}
+
+	return 0;
+}
+
+/*
+ * Take what is available from each sub-pool, the local one first. Either
+ * n objects are returned or none: on shortage, the partial set is put back.
+ */
+static int
+mempool_numa_dequeue_spread(struct mempool_numa *mn,
+	struct mempool_numa_stats *stats, unsigned int socket_id,
+	void **obj_table, unsigned int n)
+{
+	unsigned int taken[RTE_MAX_NUMA_NODES] = { 0 };
+	unsigned int first = socket_id < RTE_MAX_NUMA_NODES ? socket_id : 0;
+	unsigned int got = 0, i, idx, req;
+
+	/* Start with the local socket, then walk the others in order */
+	for (i = 0; i < RTE_MAX_NUMA_NODES && got < n; i++) {
+		idx = (first + i) % RTE_MAX_NUMA_NODES;
+		if (mn->pools[idx] == NULL)
+			continue;
+
+		req = RTE_MIN(n - got, rte_mempool_avail_count(mn->pools[idx]));
+		if (req == 0 ||
+		    rte_mempool_get_bulk(mn->pools[idx], &obj_table[got], req) != 0)
+			continue;
+		taken[idx] = req;
+		got += req;
+	}
+
+	if (got < n) {
+		got = 0;
+		for (idx = 0; idx < RTE_MAX_NUMA_NODES; idx++) {
+			if (taken[idx] == 0)
+				continue;
+			rte_mempool_put_bulk(mn->pools[idx], &obj_table[got],
+					     taken[idx]);
+			got += taken[idx];
+		}
+		return -ENOBUFS;
+	}
+
+	for (idx = 0; idx < RTE_MAX_NUMA_NODES; idx++) {
+		if (idx == socket_id)
+			stats->local_get_objs += taken[idx];
+		else
+			stats->remote_get_objs += taken[idx];
+	}
+
+	return 0;
+}
+
+/*
+ * Objects are served by the sub-pool of the lcore socket, or by the other
+ * sub-pools when it does not have enough objects left.
+ */
+static int
+mempool_numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct mempool_numa *mn = mp->pool_data;
+	struct mempool_numa_stats *stats = mempool_numa_lcore_stats(mn);
+	unsigned int socket_id = rte_socket_id();
+	unsigned int i;
+
+	if (likely(socket_id < RTE_MAX_NUMA_NODES) &&
+			mn->pools[socket_id] != NULL &&
+			rte_mempool_get_bulk(mn->pools[socket_id],
+					     obj_table, n) == 0) {
+		stats->local_get_objs += n;
+		return 0;
+	}
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
+		if (i == socket_id || mn->pools[i] == NULL)
+			continue;
+		if (rte_mempool_get_bulk(mn->pools[i], obj_table, n) == 0) {
+			stats->remote_get_objs += n;
+			return 0;
+		}
+	}
+
+	/* No single socket can serve the request, gather it from all of them */
+	return mempool_numa_dequeue_spread(mn, stats, socket_id, obj_table, n);
+}
+
+static unsigned int
+mempool_numa_get_count(const struct rte_mempool *mp)
+{
+	const struct mempool_numa *mn = mp->pool_data;
+	unsigned int i, count = 0;
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
+		if (mn->pools[i] != NULL)
+			count += rte_mempool_avail_count(mn->pools[i]);
+
+	return count;
+}
+
+static const struct rte_mempool_ops ops_numa = {
+	.name = MEMPOOL_NUMA_OPS_NAME,
+	.alloc = mempool_numa_alloc,
+	.free = mempool_numa_free,
+	.enqueue = mempool_numa_enqueue,
+	.dequeue = mempool_numa_dequeue,
+	.get_count = mempool_numa_get_count,
+};
+
+RTE_MEMPOOL_REGISTER_OPS(ops_numa);
+
+struct rte_mempool *
+mempool_numa_create(const char *name, unsigned int n, unsigned int elt_size,
+	unsigned int cache_size, unsigned int private_data_size,
+	rte_mempool_ctor_t *mp_init, void *mp_init_arg,
+	rte_mempool_obj_cb_t *obj_init, void *obj_init_arg,
+	int socket_id, unsigned int flags)
+{
+	const unsigned int nb_sockets = rte_socket_count();
+	char sub_name[RTE_MEMPOOL_NAMESIZE];
+	struct rte_mempool *mp, *sub;
+	struct mempool_numa *mn;
+	bool non_io = false;
+	unsigned int i;
+	int sub_socket;
+	int ret;
+
+	flags &= ~RTE_MEMPOOL_F_NUMA;
+
+	/* The objects are in the sub-pools, cached per lcore there */
+	mp = rte_mempool_create_empty(name, n, elt_size, 0, private_data_size,
+				      socket_id, flags);
+	if (mp == NULL)
+		return NULL;
+
+	ret = rte_mempool_set_ops_byname(mp, MEMPOOL_NUMA_OPS_NAME, NULL);
+	if (ret != 0)
+		goto fail;
+	ret = rte_mempool_ops_alloc(mp);
+	if (ret != 0)
+		goto fail;
+	mp->flags |= RTE_MEMPOOL_F_POOL_CREATED | RTE_MEMPOOL_F_NUMA;
+	mn = mp->pool_data;
+
+	/* call the mempool priv initializer */
+	if (mp_init)
+		mp_init(mp, mp_init_arg);
+
+	for (i = 0; i < nb_sockets; i++) {
+		sub_socket = rte_socket_id_by_idx(i);
+		ret = snprintf(sub_name, sizeof(sub_name), "%s_%d", name,
+			       sub_socket);
+		if (ret < 0 || ret >= (int)sizeof(sub_name)) {
+			ret = -ENAMETOOLONG;
+			goto fail;
+		}
+
+		sub = rte_mempool_create(sub_name,
+				n / nb_sockets + (i < n % nb_sockets),
+				elt_size, cache_size, private_data_size,
+				mp_init, mp_init_arg, obj_init, obj_init_arg,
+				sub_socket, flags);
+		if (sub == NULL) {
+			RTE_LOG(ERR, MEMPOOL,
+				"Cannot create sub-pool of %s on socket %d\n",
+				name, sub_socket);
+			ret = -rte_errno;
+			goto fail;
+		}
+		mn->pools[sub_socket] = sub;
+		non_io |= (sub->flags & RTE_MEMPOOL_F_NON_IO) != 0;
+	}
+
+	if (!non_io)
+		mp->flags &= ~RTE_MEMPOOL_F_NON_IO;
+
+	return mp;
+
+fail:
+	rte_mempool_free(mp);
+	rte_errno = -ret;
+	return NULL;
+}
+
+void
+mempool_numa_dump(FILE *f, const struct rte_mempool *mp)
+{
+	const struct mempool_numa *mn = mp->pool_data;
+	struct mempool_numa_stats sum;
+	unsigned int i;
+
+	fprintf(f, "  numa:\n");
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
+		if (mn->pools[i] == NULL)
+			continue;
+		fprintf(f, "    pool <%s>@%p socket_id=%u size=%"PRIu32" avail=%u\n",
+			mn->pools[i]->name, mn->pools[i], i,
+			mn->pools[i]->size,
+			rte_mempool_avail_count(mn->pools[i]));
+	}
+
+	memset(&sum, 0, sizeof(sum));
+	for (i = 0; i < RTE_MAX_LCORE + 1; i++) {
+		sum.local_get_objs += mn->stats[i].local_get_objs;
+		sum.remote_get_objs += mn->stats[i].remote_get_objs;
+		sum.local_put_objs += mn->stats[i].local_put_objs;
+		sum.remote_put_objs += mn->stats[i].remote_put_objs;
+	}
+	fprintf(f, "    local_get_objs=%"PRIu64"\n", sum.local_get_objs);
+	fprintf(f, "    remote_get_objs=%"PRIu64"\n", sum.remote_get_objs);
+	fprintf(f, "    local_put_objs=%"PRIu64"\n", sum.local_put_objs);
+	fprintf(f, "    remote_put_objs=%"PRIu64"\n", sum.remote_put_objs);
+}
@@ -129,3 +129,51 @@ rte_node_eth_config(struct rte_node_ethdev_config *conf, uint16_t nb_confs,
 	ctrl.nb_graphs = nb_graphs;
 	return 0;
 }
+
+int
+rte_node_eth_rx_mq_config(const char *name,
+			  const struct rte_node_ethdev_rx_queue *queues,
+			  uint16_t nb_queues)
+{
+	struct ethdev_rx_node_main *rx_node_data;
+	struct ethdev_rx_mq_node_elem *elem;
+	struct rte_node_register *rx_node;
+	struct rte_eth_dev_info dev_info;
+	uint16_t i;
+	uint32_t id;
+
+	if (name == NULL || queues == NULL || nb_queues == 0)
+		return -EINVAL;
+
+	for (i = 0; i < nb_queues; i++) {
+		if (rte_eth_dev_info_get(queues[i].port_id, &dev_info) != 0)
+			return -EINVAL;
+		if (queues[i].queue_id >= dev_info.nb_rx_queues)
+			return -EINVAL;
+	}
+
+	/* Nodes can't be unregistered, allocate before cloning */
+	elem = calloc(1, sizeof(*elem) + nb_queues * sizeof(elem->queues[0]));
+	if (elem == NULL)
+		return -ENOMEM;
+
+	rx_node_data = ethdev_rx_get_node_data_get();
+	rx_node = ethdev_rx_mq_node_get();
+	/* Clone a new rx node with same edges as parent */
+	id = rte_node_clone(rx_node->id, name);
+	if (id == RTE_NODE_ID_INVALID) {
+		free(elem);
+		return -EIO;
+	}
+
+	/* Add it to list of multi-queue rx nodes for lookup */
+	memcpy(elem->queues, queues, nb_queues * sizeof(elem->queues[0]));
+	elem->nb_queues = nb_queues;
+	elem->nid = id;
+	elem->next = rx_node_data->mq_head;
+	rx_node_data->mq_head = elem;
+
+	node_dbg("ethdev", "Rx node %s-%s: is at %u", rx_node->name, name, id);
+
+	return 0;
+}
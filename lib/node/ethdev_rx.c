@@ -7,6 +7,7 @@
 #include <rte_ether.h>
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
+#include <rte_malloc.h>
 
 #include "ethdev_rx_priv.h"
 #include "node_private.h"
@@ -51,6 +52,46 @@ ethdev_rx_node_process(struct rte_graph *graph, struct rte_node *node,
 	return n_pkts;
 }
 
+static uint16_t
+ethdev_rx_mq_node_process(struct rte_graph *graph, struct rte_node *node,
+			  void **objs, uint16_t cnt)
+{
+	struct ethdev_rx_mq_node_ctx *ctx = (struct ethdev_rx_mq_node_ctx *)node->ctx;
+	struct ethdev_rx_mq_node_data *data = ctx->data;
+	struct rte_node_ethdev_rx_queue *q;
+	uint16_t count, nb_pkts, i;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(cnt);
+
+	/* Hand over the burst received last time, headers are in cache now */
+	nb_pkts = data->nb_ahead;
+	if (nb_pkts)
+		rte_memcpy(node->objs, data->ahead, nb_pkts * sizeof(void *));
+
+	/* Receive the next burst while the current one is being classified */
+	q = &data->queues[data->cur];
+	count = rte_eth_rx_burst(q->port_id, q->queue_id, data->ahead,
+				 RTE_GRAPH_BURST_SIZE);
+	for (i = 0; i < count; i++)
+		rte_prefetch0(rte_pktmbuf_mtod(data->ahead[i], void *));
+	data->nb_ahead = count;
+
+	/* Move to the next queue once idle or out of credit */
+	if (count == 0 || --data->credit == 0) {
+		data->cur = (data->cur + 1 == data->nb_queues) ? 0 : data->cur + 1;
+		data->credit = data->queues[data->cur].weight;
+	}
+
+	if (!nb_pkts)
+		return 0;
+	node->idx = nb_pkts;
+	/* Enqueue to next node */
+	rte_node_next_stream_move(graph, node, data->cls_next);
+
+	return nb_pkts;
+}
+
 static inline uint32_t
 l3_ptype(uint16_t etype, uint32_t ptype)
 {
@@ -198,6 +239,69 @@ ethdev_rx_node_init(const struct rte_graph *graph, struct rte_node *node)
 	return ethdev_ptype_setup(ctx->port_id, ctx->queue_id);
 }
 
+static int
+ethdev_rx_mq_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ethdev_rx_mq_node_ctx *ctx = (struct ethdev_rx_mq_node_ctx *)node->ctx;
+	struct ethdev_rx_mq_node_elem *elem = ethdev_rx_main.mq_head;
+	struct ethdev_rx_mq_node_data *data;
+	uint16_t i;
+	int rc;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ethdev_rx_mq_node_ctx) > RTE_NODE_CTX_SZ);
+
+	while (elem) {
+		if (elem->nid == node->id)
+			break;
+		elem = elem->next;
+	}
+
+	RTE_VERIFY(elem != NULL);
+
+	/* Each graph polls with its own round robin state and ahead burst */
+	data = rte_zmalloc_socket("ethdev_rx_mq", sizeof(*data) +
+				  elem->nb_queues * sizeof(elem->queues[0]),
+				  RTE_CACHE_LINE_SIZE, graph->socket);
+	if (data == NULL)
+		return -ENOMEM;
+
+	data->nb_queues = elem->nb_queues;
+	data->cls_next = ETHDEV_RX_NEXT_PKT_CLS;
+	for (i = 0; i < elem->nb_queues; i++) {
+		data->queues[i] = elem->queues[i];
+		if (data->queues[i].weight == 0)
+			data->queues[i].weight = 1;
+
+		/* Check and setup ptype */
+		rc = ethdev_ptype_setup(data->queues[i].port_id,
+					data->queues[i].queue_id);
+		if (rc < 0) {
+			rte_free(data);
+			return rc;
+		}
+	}
+	data->credit = data->queues[0].weight;
+	ctx->data = data;
+
+	return 0;
+}
+
+static void
+ethdev_rx_mq_node_fini(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ethdev_rx_mq_node_ctx *ctx = (struct ethdev_rx_mq_node_ctx *)node->ctx;
+	struct ethdev_rx_mq_node_data *data = ctx->data;
+
+	RTE_SET_USED(graph);
+
+	if (data == NULL)
+		return;
+
+	rte_pktmbuf_free_bulk(data->ahead, data->nb_ahead);
+	rte_free(data);
+	ctx->data = NULL;
+}
+
 struct ethdev_rx_node_main *
 ethdev_rx_get_node_data_get(void)
 {
@@ -216,6 +320,7 @@ static struct rte_node_register ethdev_rx_node_base = {
 		[ETHDEV_RX_NEXT_PKT_CLS] = "pkt_cls",
 		[ETHDEV_RX_NEXT_IP4_LOOKUP] = "ip4_lookup",
 		[ETHDEV_RX_NEXT_IP4_REASSEMBLY] = "ip4_reassembly",
+		[ETHDEV_RX_NEXT_IP6_REASSEMBLY] = "ip6_reassembly",
 	},
 };
 
@@ -226,3 +331,28 @@ ethdev_rx_node_get(void)
 }
 
 RTE_NODE_REGISTER(ethdev_rx_node_base);
+
+static struct rte_node_register ethdev_rx_mq_node_base = {
+	.process = ethdev_rx_mq_node_process,
+	.flags = RTE_NODE_SOURCE_F,
+	.name = "ethdev_rx_mq",
+
+	.init = ethdev_rx_mq_node_init,
+	.fini = ethdev_rx_mq_node_fini,
+
+	.nb_edges = ETHDEV_RX_NEXT_MAX,
+	.next_nodes = {
+		[ETHDEV_RX_NEXT_PKT_CLS] = "pkt_cls",
+		[ETHDEV_RX_NEXT_IP4_LOOKUP] = "ip4_lookup",
+		[ETHDEV_RX_NEXT_IP4_REASSEMBLY] = "ip4_reassembly",
+		[ETHDEV_RX_NEXT_IP6_REASSEMBLY] = "ip6_reassembly",
+	},
+};
+
+struct rte_node_register *
+ethdev_rx_mq_node_get(void)
+{
+	return &ethdev_rx_mq_node_base;
+}
+
+RTE_NODE_REGISTER(ethdev_rx_mq_node_base);
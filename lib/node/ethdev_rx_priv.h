@@ -5,6 +5,10 @@
 #define __INCLUDE_ETHDEV_RX_PRIV_H__
 
 #include <rte_common.h>
+#include <rte_graph.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_eth_api.h"
 
 struct ethdev_rx_node_elem;
 struct ethdev_rx_node_ctx;
@@ -36,10 +40,59 @@ struct ethdev_rx_node_elem {
 	/**< Node identifier of the Rx node. */
 };
 
+/**
+ * @internal
+ *
+ * Multi-queue Ethernet device Rx node list element structure.
+ */
+struct ethdev_rx_mq_node_elem {
+	struct ethdev_rx_mq_node_elem *next;
+	/**< Pointer to the next multi-queue Rx node element. */
+	rte_node_t nid;
+	/**< Node identifier of the Rx node. */
+	uint16_t nb_queues;
+	/**< Number of Rx queues polled by the node. */
+	struct rte_node_ethdev_rx_queue queues[];
+	/**< Rx queues polled by the node. */
+};
+
+/**
+ * @internal
+ *
+ * Multi-queue Ethernet device Rx node per graph data.
+ */
+struct ethdev_rx_mq_node_data {
+	uint16_t nb_queues;
+	/**< Number of Rx queues polled by the node. */
+	uint16_t cur;
+	/**< Index of the queue being polled. */
+	uint16_t credit;
+	/**< Bursts left to poll from the current queue. */
+	uint16_t cls_next;
+	/**< Next node for the received packets. */
+	uint16_t nb_ahead;
+	/**< Number of packets received ahead. */
+	struct rte_mbuf *ahead[RTE_GRAPH_BURST_SIZE] __rte_cache_aligned;
+	/**< Packets received ahead, their headers being prefetched. */
+	struct rte_node_ethdev_rx_queue queues[];
+	/**< Rx queues polled by the node. */
+};
+
+/**
+ * @internal
+ *
+ * Multi-queue Ethernet device Rx node context structure.
+ */
+struct ethdev_rx_mq_node_ctx {
+	struct ethdev_rx_mq_node_data *data;
+	/**< Per graph node data. */
+};
+
 enum ethdev_rx_next_nodes {
 	ETHDEV_RX_NEXT_IP4_LOOKUP,
 	ETHDEV_RX_NEXT_PKT_CLS,
 	ETHDEV_RX_NEXT_IP4_REASSEMBLY,
+	ETHDEV_RX_NEXT_IP6_REASSEMBLY,
 	ETHDEV_RX_NEXT_MAX,
 };
 
@@ -51,6 +104,8 @@ enum ethdev_rx_next_nodes {
 struct ethdev_rx_node_main {
 	ethdev_rx_node_elem_t *head;
 	/**< Pointer to the head Rx node element. */
+	struct ethdev_rx_mq_node_elem *mq_head;
+	/**< Pointer to the head multi-queue Rx node element. */
 };
 
 /**
@@ -73,4 +128,14 @@ struct ethdev_rx_node_main *ethdev_rx_get_node_data_get(void);
  */
 struct rte_node_register *ethdev_rx_node_get(void);
 
+/**
+ * @internal
+ *
+ * Get the multi-queue Ethernet Rx node.
+ *
+ * @return
+ *   Pointer to the multi-queue Ethernet Rx node.
+ */
+struct rte_node_register *ethdev_rx_mq_node_get(void);
+
 #endif /* __INCLUDE_ETHDEV_RX_PRIV_H__ */
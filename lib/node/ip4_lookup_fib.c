@@ -0,0 +1,249 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_fib.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+
+#include "rte_node_ip4_api.h"
+
+#include "node_private.h"
+#include "pkt_cls_priv.h"
+
+#define IP4_LOOKUP_FIB_NAMESIZE 64
+
+/* IP4 FIB lookup global data struct */
+struct ip4_lookup_fib_node_main {
+	struct rte_fib *fib[RTE_MAX_NUMA_NODES];
+};
+
+struct ip4_lookup_fib_node_ctx {
+	/* Socket's FIB table */
+	struct rte_fib *fib;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+static struct ip4_lookup_fib_node_main ip4_lookup_fib_nm;
+
+#define IP4_LOOKUP_FIB_NODE(ctx) \
+	(((struct ip4_lookup_fib_node_ctx *)ctx)->fib)
+
+#define IP4_LOOKUP_FIB_NODE_PRIV1_OFF(ctx) \
+	(((struct ip4_lookup_fib_node_ctx *)ctx)->mbuf_priv1_off)
+
+/* Next node id is embedded above the 16 bit next hop id in FIB result */
+#define IP4_LOOKUP_FIB_NH(next_node, next_hop) \
+	((((uint64_t)(next_node)) << 16) | (next_hop))
+
+static uint16_t
+ip4_lookup_fib_node_process(struct rte_graph *graph, struct rte_node *node,
+			    void **objs, uint16_t nb_objs)
+{
+	struct rte_fib *fib = IP4_LOOKUP_FIB_NODE(node->ctx);
+	const int dyn = IP4_LOOKUP_FIB_NODE_PRIV1_OFF(node->ctx);
+	uint64_t next_hop[RTE_GRAPH_BURST_SIZE];
+	uint32_t ip[RTE_GRAPH_BURST_SIZE];
+	struct rte_ipv4_hdr *ipv4_hdr;
+	uint16_t n_left, n_burst, i;
+	struct rte_mbuf **pkts;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	struct rte_mbuf *mbuf;
+	uint16_t held = 0;
+	rte_edge_t next;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP4_LOOKUP_NEXT_REWRITE;
+	pkts = (struct rte_mbuf **)objs;
+	from = objs;
+	n_left = nb_objs;
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	while (n_left > 0) {
+		n_burst = RTE_MIN(n_left, (uint16_t)RTE_GRAPH_BURST_SIZE);
+
+		for (i = 0; i < n_burst && i < 4; i++)
+			rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+						sizeof(struct rte_ether_hdr)));
+
+		/* Gather DIPs of the whole burst for a single bulk lookup */
+		for (i = 0; i < n_burst; i++) {
+			if (likely(i + 4 < n_burst))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i + 4],
+						void *, sizeof(struct rte_ether_hdr)));
+
+			mbuf = pkts[i];
+			ipv4_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv4_hdr *,
+						sizeof(struct rte_ether_hdr));
+			ip[i] = rte_be_to_cpu_32(ipv4_hdr->dst_addr);
+			/* Extract cksum, ttl as ipv4 hdr is in cache */
+			node_mbuf_priv1(mbuf, dyn)->cksum = ipv4_hdr->hdr_checksum;
+			node_mbuf_priv1(mbuf, dyn)->ttl = ipv4_hdr->time_to_live;
+		}
+
+		/* Misses resolve to the default next hop i.e. pkt_drop */
+		if (unlikely(rte_fib_lookup_bulk(fib, ip, next_hop, n_burst) < 0)) {
+			for (i = 0; i < n_burst; i++)
+				next_hop[i] = IP4_LOOKUP_FIB_NH(
+					RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP, 0);
+		}
+
+		for (i = 0; i < n_burst; i++) {
+			node_mbuf_priv1(pkts[i], dyn)->nh = (uint16_t)next_hop[i];
+			next = (rte_edge_t)(next_hop[i] >> 16);
+
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+
+		pkts += n_burst;
+		n_left -= n_burst;
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip4_fib_create(int socket, struct rte_fib_conf *conf)
+{
+	struct ip4_lookup_fib_node_main *nm = &ip4_lookup_fib_nm;
+	char s[IP4_LOOKUP_FIB_NAMESIZE];
+
+	if (conf == NULL || socket < 0 || socket >= RTE_MAX_NUMA_NODES)
+		return -EINVAL;
+
+	/* Next node id and next hop id need at least 4B FIB results */
+	if (conf->type == RTE_FIB_DIR24_8 &&
+	    conf->dir24_8.nh_sz < RTE_FIB_DIR24_8_4B)
+		return -EINVAL;
+
+	/* One FIB table per socket */
+	if (nm->fib[socket])
+		return 0;
+
+	conf->default_nh = IP4_LOOKUP_FIB_NH(RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP, 0);
+	snprintf(s, sizeof(s), "IPV4_LOOKUP_FIB_%d", socket);
+	nm->fib[socket] = rte_fib_create(s, socket, conf);
+	if (nm->fib[socket] == NULL)
+		return -rte_errno;
+
+	/* Steer IPv4 traffic from pkt_cls to this node instead of LPM */
+	pkt_cls_next_update(PKT_CLS_NEXT_IP4_LOOKUP, PKT_CLS_NEXT_IP4_LOOKUP_FIB);
+
+	return 0;
+}
+
+int
+rte_node_ip4_fib_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
+			   enum rte_node_ip4_lookup_next next_node)
+{
+	char abuf[INET6_ADDRSTRLEN];
+	struct in_addr in;
+	uint8_t socket;
+	uint64_t val;
+	int ret;
+
+	in.s_addr = htonl(ip);
+	inet_ntop(AF_INET, &in, abuf, sizeof(abuf));
+	val = IP4_LOOKUP_FIB_NH(next_node, next_hop);
+	node_dbg("ip4_lookup_fib", "FIB: Adding route %s / %d nh (0x%" PRIx64 ")",
+		 abuf, depth, val);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip4_lookup_fib_nm.fib[socket])
+			continue;
+
+		ret = rte_fib_add(ip4_lookup_fib_nm.fib[socket], ip, depth, val);
+		if (ret < 0) {
+			node_err("ip4_lookup_fib",
+				 "Unable to add entry %s / %d nh (%" PRIx64 ") to FIB table on sock %d, rc=%d\n",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int
+ip4_lookup_fib_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct rte_fib *fib = NULL;
+	static uint8_t init_once;
+	int socket;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ip4_lookup_fib_node_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+
+		init_once = 1;
+	}
+
+	/*
+	 * Use the FIB of the graph socket, else the first one created, as
+	 * applications running with NUMA off only create it on socket 0.
+	 * FIB is absent when LPM based ip4_lookup is in use, node stays idle.
+	 */
+	if (graph->socket >= 0 && graph->socket < RTE_MAX_NUMA_NODES)
+		fib = ip4_lookup_fib_nm.fib[graph->socket];
+	for (socket = 0; fib == NULL && socket < RTE_MAX_NUMA_NODES; socket++)
+		fib = ip4_lookup_fib_nm.fib[socket];
+
+	IP4_LOOKUP_FIB_NODE(node->ctx) = fib;
+	IP4_LOOKUP_FIB_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+
+	node_dbg("ip4_lookup_fib", "Initialized ip4_lookup_fib node");
+
+	return 0;
+}
+
+static struct rte_node_register ip4_lookup_fib_node = {
+	.process = ip4_lookup_fib_node_process,
+	.name = "ip4_lookup_fib",
+
+	.init = ip4_lookup_fib_node_init,
+
+	.nb_edges = RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_IP4_LOOKUP_NEXT_IP4_LOCAL] = "ip4_local",
+		[RTE_NODE_IP4_LOOKUP_NEXT_REWRITE] = "ip4_rewrite",
+		[RTE_NODE_IP4_LOOKUP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip4_lookup_fib_node);
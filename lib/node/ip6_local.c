@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <netinet/in.h>
+
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "node_private.h"
+
+static __rte_always_inline uint16_t
+ip6_local_next_get(struct rte_mbuf *mbuf)
+{
+	struct rte_ipv6_hdr *ip6_hdr;
+	uint32_t l4;
+
+	l4 = mbuf->packet_type & RTE_PTYPE_L4_MASK;
+	if (likely(l4 == RTE_PTYPE_L4_UDP))
+		return RTE_NODE_IP6_LOCAL_NEXT_UDP6_INPUT;
+	if (l4 != 0)
+		return RTE_NODE_IP6_LOCAL_NEXT_PKT_DROP;
+
+	/* L4 type not reported by Rx, check the IPv6 next header */
+	ip6_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv6_hdr *,
+					  sizeof(struct rte_ether_hdr));
+	return (ip6_hdr->proto == IPPROTO_UDP) ?
+		RTE_NODE_IP6_LOCAL_NEXT_UDP6_INPUT :
+		RTE_NODE_IP6_LOCAL_NEXT_PKT_DROP;
+}
+
+static uint16_t
+ip6_local_node_process_scalar(struct rte_graph *graph, struct rte_node *node,
+			      void **objs, uint16_t nb_objs)
+{
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	struct rte_mbuf *mbuf;
+	uint16_t held = 0;
+	int i;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP6_LOCAL_NEXT_UDP6_INPUT;
+
+	from = objs;
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	for (i = 0; i < nb_objs; i++) {
+		uint16_t next;
+
+		mbuf = (struct rte_mbuf *)objs[i];
+		next = ip6_local_next_get(mbuf);
+
+		if (unlikely(next_index != next)) {
+			/* Copy things successfully speculated till now */
+			rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+			from += last_spec;
+			to_next += last_spec;
+			held += last_spec;
+			last_spec = 0;
+
+			rte_node_enqueue_x1(graph, node, next, from[0]);
+			from += 1;
+		} else {
+			last_spec += 1;
+		}
+	}
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static struct rte_node_register ip6_local_node = {
+	.process = ip6_local_node_process_scalar,
+	.name = "ip6_local",
+
+	.nb_edges = RTE_NODE_IP6_LOCAL_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_IP6_LOCAL_NEXT_UDP6_INPUT] = "udp6_input",
+		[RTE_NODE_IP6_LOCAL_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip6_local_node);
@@ -0,0 +1,247 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell.
+ */
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_fib6.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "node_private.h"
+#include "pkt_cls_priv.h"
+
+#define IP6_LOOKUP_FIB_NAMESIZE 64
+
+/* IP6 FIB lookup global data struct */
+struct ip6_lookup_fib_node_main {
+	struct rte_fib6 *fib[RTE_MAX_NUMA_NODES];
+};
+
+struct ip6_lookup_fib_node_ctx {
+	/* Socket's FIB table */
+	struct rte_fib6 *fib;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+static struct ip6_lookup_fib_node_main ip6_lookup_fib_nm;
+
+#define IP6_LOOKUP_FIB_NODE(ctx) \
+	(((struct ip6_lookup_fib_node_ctx *)ctx)->fib)
+
+#define IP6_LOOKUP_FIB_NODE_PRIV1_OFF(ctx) \
+	(((struct ip6_lookup_fib_node_ctx *)ctx)->mbuf_priv1_off)
+
+/* Next node id is embedded above the 16 bit next hop id in FIB result */
+#define IP6_LOOKUP_FIB_NH(next_node, next_hop) \
+	((((uint64_t)(next_node)) << 16) | (next_hop))
+
+static uint16_t
+ip6_lookup_fib_node_process(struct rte_graph *graph, struct rte_node *node,
+			    void **objs, uint16_t nb_objs)
+{
+	struct rte_fib6 *fib = IP6_LOOKUP_FIB_NODE(node->ctx);
+	const int dyn = IP6_LOOKUP_FIB_NODE_PRIV1_OFF(node->ctx);
+	uint64_t next_hop[RTE_GRAPH_BURST_SIZE];
+	uint8_t ip[RTE_GRAPH_BURST_SIZE][RTE_FIB6_IPV6_ADDR_SIZE];
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t n_left, n_burst, i;
+	struct rte_mbuf **pkts;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	rte_edge_t next_index;
+	struct rte_mbuf *mbuf;
+	uint16_t held = 0;
+	rte_edge_t next;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP6_LOOKUP_NEXT_REWRITE;
+	pkts = (struct rte_mbuf **)objs;
+	from = objs;
+	n_left = nb_objs;
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	while (n_left > 0) {
+		n_burst = RTE_MIN(n_left, (uint16_t)RTE_GRAPH_BURST_SIZE);
+
+		for (i = 0; i < n_burst && i < 4; i++)
+			rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i], void *,
+						sizeof(struct rte_ether_hdr)));
+
+		/* Gather DIPs of the whole burst for a single bulk lookup */
+		for (i = 0; i < n_burst; i++) {
+			if (likely(i + 4 < n_burst))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(pkts[i + 4],
+						void *, sizeof(struct rte_ether_hdr)));
+
+			mbuf = pkts[i];
+			ipv6_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv6_hdr *,
+						sizeof(struct rte_ether_hdr));
+			rte_memcpy(ip[i], ipv6_hdr->dst_addr, RTE_FIB6_IPV6_ADDR_SIZE);
+			/* Extract hop_limits as ipv6 hdr is in cache */
+			node_mbuf_priv1(mbuf, dyn)->ttl = ipv6_hdr->hop_limits;
+		}
+
+		/* Misses resolve to the default next hop i.e. pkt_drop */
+		if (unlikely(rte_fib6_lookup_bulk(fib, ip, next_hop, n_burst) < 0)) {
+			for (i = 0; i < n_burst; i++)
+				next_hop[i] = IP6_LOOKUP_FIB_NH(
+					RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP, 0);
+		}
+
+		for (i = 0; i < n_burst; i++) {
+			node_mbuf_priv1(pkts[i], dyn)->nh = (uint16_t)next_hop[i];
+			next = (rte_edge_t)(next_hop[i] >> 16);
+
+			if (unlikely(next_index != next)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+
+		pkts += n_burst;
+		n_left -= n_burst;
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip6_fib_create(int socket, struct rte_fib6_conf *conf)
+{
+	struct ip6_lookup_fib_node_main *nm = &ip6_lookup_fib_nm;
+	char s[IP6_LOOKUP_FIB_NAMESIZE];
+
+	if (conf == NULL || socket < 0 || socket >= RTE_MAX_NUMA_NODES)
+		return -EINVAL;
+
+	/* Next node id and next hop id need at least 4B FIB results */
+	if (conf->type == RTE_FIB6_TRIE && conf->trie.nh_sz < RTE_FIB6_TRIE_4B)
+		return -EINVAL;
+
+	/* One FIB table per socket */
+	if (nm->fib[socket])
+		return 0;
+
+	conf->default_nh = IP6_LOOKUP_FIB_NH(RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP, 0);
+	snprintf(s, sizeof(s), "IPV6_LOOKUP_FIB_%d", socket);
+	nm->fib[socket] = rte_fib6_create(s, socket, conf);
+	if (nm->fib[socket] == NULL)
+		return -rte_errno;
+
+	/* Steer IPv6 traffic from pkt_cls to this node instead of LPM */
+	pkt_cls_next_update(PKT_CLS_NEXT_IP6_LOOKUP, PKT_CLS_NEXT_IP6_LOOKUP_FIB);
+
+	return 0;
+}
+
+int
+rte_node_ip6_fib_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
+			   enum rte_node_ip6_lookup_next next_node)
+{
+	char abuf[INET6_ADDRSTRLEN];
+	struct in6_addr in6;
+	uint8_t socket;
+	uint64_t val;
+	int ret;
+
+	memcpy(in6.s6_addr, ip, RTE_FIB6_IPV6_ADDR_SIZE);
+	inet_ntop(AF_INET6, &in6, abuf, sizeof(abuf));
+	val = IP6_LOOKUP_FIB_NH(next_node, next_hop);
+	node_dbg("ip6_lookup_fib", "FIB: Adding route %s / %d nh (0x%" PRIx64 ")",
+		 abuf, depth, val);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip6_lookup_fib_nm.fib[socket])
+			continue;
+
+		ret = rte_fib6_add(ip6_lookup_fib_nm.fib[socket], ip, depth, val);
+		if (ret < 0) {
+			node_err("ip6_lookup_fib",
+				 "Unable to add entry %s / %d nh (%" PRIx64 ") to FIB table on sock %d, rc=%d\n",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int
+ip6_lookup_fib_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct rte_fib6 *fib = NULL;
+	static uint8_t init_once;
+	int socket;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ip6_lookup_fib_node_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+
+		init_once = 1;
+	}
+
+	/*
+	 * Use the FIB of the graph socket, else the first one created, as
+	 * applications running with NUMA off only create it on socket 0.
+	 * FIB is absent when LPM based ip6_lookup is in use, node stays idle.
+	 */
+	if (graph->socket >= 0 && graph->socket < RTE_MAX_NUMA_NODES)
+		fib = ip6_lookup_fib_nm.fib[graph->socket];
+	for (socket = 0; fib == NULL && socket < RTE_MAX_NUMA_NODES; socket++)
+		fib = ip6_lookup_fib_nm.fib[socket];
+
+	IP6_LOOKUP_FIB_NODE(node->ctx) = fib;
+	IP6_LOOKUP_FIB_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+
+	node_dbg("ip6_lookup_fib", "Initialized ip6_lookup_fib node");
+
+	return 0;
+}
+
+static struct rte_node_register ip6_lookup_fib_node = {
+	.process = ip6_lookup_fib_node_process,
+	.name = "ip6_lookup_fib",
+
+	.init = ip6_lookup_fib_node_init,
+
+	.nb_edges = RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE] = "ip6_rewrite",
+		[RTE_NODE_IP6_LOOKUP_NEXT_IP6_LOCAL] = "ip6_local",
+		[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip6_lookup_fib_node);
@@ -0,0 +1,244 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell.
+ */
+
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+
+#include <rte_cycles.h>
+#include <rte_debug.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_telemetry.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "ip6_reassembly_priv.h"
+#include "node_private.h"
+
+struct ip6_reassembly_elem {
+	struct ip6_reassembly_elem *next;
+	struct ip6_reassembly_data *data;
+	rte_node_t node_id;
+};
+
+/* IP6 reassembly global data struct */
+struct ip6_reassembly_node_main {
+	struct ip6_reassembly_elem *head;
+};
+
+typedef struct ip6_reassembly_ctx ip6_reassembly_ctx_t;
+typedef struct ip6_reassembly_elem ip6_reassembly_elem_t;
+
+static struct ip6_reassembly_node_main ip6_reassembly_main;
+
+static __rte_always_inline struct rte_mbuf *
+ip6_reassembly_one(struct ip6_reassembly_data *data, struct rte_mbuf *mbuf,
+		   uint64_t tms)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_mbuf *mbuf_out;
+
+	ipv6_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv6_hdr *,
+					   sizeof(struct rte_ether_hdr));
+	frag_hdr = rte_ipv6_frag_get_ipv6_fragment_header(ipv6_hdr);
+	if (frag_hdr == NULL)
+		return mbuf;
+
+	/* prepare mbuf: setup l2_len/l3_len. */
+	mbuf->l2_len = sizeof(struct rte_ether_hdr);
+	mbuf->l3_len = sizeof(struct rte_ipv6_hdr) + sizeof(*frag_hdr);
+
+	data->stats.fragments++;
+	mbuf_out = rte_ipv6_frag_reassemble_packet(data->tbl, data->dr, mbuf, tms,
+						   ipv6_hdr, frag_hdr);
+	if (mbuf_out)
+		data->stats.reassembled++;
+
+	return mbuf_out;
+}
+
+static uint16_t
+ip6_reassembly_node_process(struct rte_graph *graph, struct rte_node *node, void **objs,
+			    uint16_t nb_objs)
+{
+#define PREFETCH_OFFSET 4
+	struct ip6_reassembly_data *data;
+	struct rte_ip_frag_death_row *dr;
+	struct ip6_reassembly_ctx *ctx;
+	void **to_next, **to_free;
+	struct rte_mbuf *mbuf_out;
+	uint16_t idx = 0;
+	uint32_t nb_drop;
+	uint64_t tms;
+	int i;
+
+	ctx = (struct ip6_reassembly_ctx *)node->ctx;
+
+	/* Get core specific reassembly tbl */
+	data = ctx->data;
+	dr = data->dr;
+	tms = rte_rdtsc();
+
+	for (i = 0; i < PREFETCH_OFFSET && i < nb_objs; i++) {
+		rte_prefetch0(rte_pktmbuf_mtod_offset((struct rte_mbuf *)objs[i], void *,
+						      sizeof(struct rte_ether_hdr)));
+	}
+
+	to_next = node->objs;
+	for (i = 0; i < nb_objs - PREFETCH_OFFSET; i++) {
+#if RTE_GRAPH_BURST_SIZE > 64
+		/* Prefetch next-next mbufs */
+		if (likely(i + 8 < nb_objs))
+			rte_prefetch0(objs[i + 8]);
+#endif
+		rte_prefetch0(rte_pktmbuf_mtod_offset((struct rte_mbuf *)objs[i + PREFETCH_OFFSET],
+						      void *, sizeof(struct rte_ether_hdr)));
+
+		mbuf_out = ip6_reassembly_one(data, (struct rte_mbuf *)objs[i], tms);
+		if (mbuf_out)
+			to_next[idx++] = (void *)mbuf_out;
+	}
+
+	for (; i < nb_objs; i++) {
+		mbuf_out = ip6_reassembly_one(data, (struct rte_mbuf *)objs[i], tms);
+		if (mbuf_out)
+			to_next[idx++] = (void *)mbuf_out;
+	}
+	node->idx = idx;
+	rte_node_next_stream_move(graph, node, 1);
+
+	/* Fragments put on death row while reassembling the burst */
+	nb_drop = dr->cnt;
+	data->stats.dropped += nb_drop;
+
+	/* Reap the flows which did not complete within the table timeout */
+	rte_ip_frag_table_del_expired_entries(data->tbl, dr, tms);
+	data->stats.timeout += dr->cnt - nb_drop;
+
+	if (dr->cnt) {
+		to_free = rte_node_next_stream_get(graph, node,
+						   RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP, dr->cnt);
+		rte_memcpy(to_free, dr->row, dr->cnt * sizeof(to_free[0]));
+		rte_node_next_stream_put(graph, node, RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP,
+					 dr->cnt);
+		idx += dr->cnt;
+		dr->cnt = 0;
+	}
+
+	return idx;
+}
+
+int
+rte_node_ip6_reassembly_configure(struct rte_node_ip6_reassembly_cfg *cfg, uint16_t cnt)
+{
+	ip6_reassembly_elem_t *elem;
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		elem = malloc(sizeof(ip6_reassembly_elem_t));
+		if (elem == NULL)
+			return -ENOMEM;
+		elem->data = rte_zmalloc("ip6_reassembly", sizeof(*elem->data),
+					 RTE_CACHE_LINE_SIZE);
+		if (elem->data == NULL) {
+			free(elem);
+			return -ENOMEM;
+		}
+		elem->data->dr = cfg[i].dr;
+		elem->data->tbl = cfg[i].tbl;
+		elem->node_id = cfg[i].node_id;
+		elem->next = ip6_reassembly_main.head;
+		ip6_reassembly_main.head = elem;
+	}
+
+	return 0;
+}
+
+static int
+ip6_reassembly_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	ip6_reassembly_ctx_t *ctx = (ip6_reassembly_ctx_t *)node->ctx;
+	ip6_reassembly_elem_t *elem = ip6_reassembly_main.head;
+
+	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(ip6_reassembly_ctx_t) > RTE_NODE_CTX_SZ);
+
+	while (elem) {
+		if (elem->node_id == node->id) {
+			/* Update node specific context */
+			ctx->data = elem->data;
+			break;
+		}
+		elem = elem->next;
+	}
+
+	return 0;
+}
+
+static int
+ip6_reassembly_handle_stats(const char *cmd __rte_unused,
+			    const char *params __rte_unused, struct rte_tel_data *d)
+{
+	ip6_reassembly_elem_t *elem = ip6_reassembly_main.head;
+	struct ip6_reassembly_stats *stats;
+	struct rte_tel_data *node_stats;
+	const char *name;
+
+	rte_tel_data_start_dict(d);
+	while (elem) {
+		name = rte_node_id_to_name(elem->node_id);
+		node_stats = rte_tel_data_alloc();
+		if (name == NULL || node_stats == NULL) {
+			rte_tel_data_free(node_stats);
+			elem = elem->next;
+			continue;
+		}
+
+		stats = &elem->data->stats;
+		rte_tel_data_start_dict(node_stats);
+		rte_tel_data_add_dict_uint(node_stats, "fragments", stats->fragments);
+		rte_tel_data_add_dict_uint(node_stats, "reassembled", stats->reassembled);
+		rte_tel_data_add_dict_uint(node_stats, "timeout", stats->timeout);
+		rte_tel_data_add_dict_uint(node_stats, "dropped", stats->dropped);
+		rte_tel_data_add_dict_container(d, name, node_stats, 0);
+		elem = elem->next;
+	}
+
+	return 0;
+}
+
+RTE_INIT(ip6_reassembly_init_telemetry)
+{
+	rte_telemetry_register_cmd("/node/ip6_reassembly/stats",
+		ip6_reassembly_handle_stats,
+		"Returns ip6_reassembly node fragment counters. Takes no parameters");
+}
+
+static struct rte_node_register ip6_reassembly_node = {
+	.process = ip6_reassembly_node_process,
+	.name = "ip6_reassembly",
+
+	.init = ip6_reassembly_node_init,
+
+	.nb_edges = RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+ip6_reassembly_node_get(void)
+{
+	return &ip6_reassembly_node;
+}
+
+RTE_NODE_REGISTER(ip6_reassembly_node);
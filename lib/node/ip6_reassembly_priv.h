@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2023 Marvell International Ltd.
+ */
+
+#ifndef __INCLUDE_IP6_REASSEMBLY_PRIV_H__
+#define __INCLUDE_IP6_REASSEMBLY_PRIV_H__
+
+/**
+ * @internal
+ *
+ * Ip6_reassembly per node instance statistics.
+ */
+struct ip6_reassembly_stats {
+	uint64_t fragments;
+	/**< Fragments received by the node. */
+	uint64_t reassembled;
+	/**< Packets reassembled out of fragments. */
+	uint64_t timeout;
+	/**< Fragments dropped as the reassembly timed out. */
+	uint64_t dropped;
+	/**< Fragments dropped for other reasons like table full or invalid. */
+};
+
+/**
+ * @internal
+ *
+ * Ip6_reassembly per node instance data, kept out of the node context
+ * which is too small to hold the statistics.
+ */
+struct ip6_reassembly_data {
+	struct rte_ip_frag_tbl *tbl;
+	struct rte_ip_frag_death_row *dr;
+	struct ip6_reassembly_stats stats;
+} __rte_cache_aligned;
+
+/**
+ * @internal
+ *
+ * Ip6_reassembly context structure.
+ */
+struct ip6_reassembly_ctx {
+	struct ip6_reassembly_data *data;
+};
+
+/**
+ * @internal
+ *
+ * Get the IP6 reassembly node
+ *
+ * @return
+ *   Pointer to the IP6 reassembly node.
+ */
+struct rte_node_register *ip6_reassembly_node_get(void);
+
+#endif /* __INCLUDE_IP6_REASSEMBLY_PRIV_H__ */
@@ -4,12 +4,14 @@
 
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
+#include <rte_malloc.h>
+#include <rte_vect.h>
 
 #include "pkt_cls_priv.h"
 #include "node_private.h"
 
 /* Next node for each ptype, default is '0' is "pkt_drop" */
-static const uint8_t p_nxt[256] __rte_cache_aligned = {
+static const uint8_t p_nxt_default[256] __rte_cache_aligned = {
 	[RTE_PTYPE_L3_IPV4] = PKT_CLS_NEXT_IP4_LOOKUP,
 
 	[RTE_PTYPE_L3_IPV4_EXT] = PKT_CLS_NEXT_IP4_LOOKUP,
@@ -39,6 +41,71 @@ static const uint8_t p_nxt[256] __rte_cache_aligned = {
 		PKT_CLS_NEXT_IP6_LOOKUP,
 };
 
+/* Next node replacing each next node of the default ptype table */
+static uint8_t next_redirect[PKT_CLS_NEXT_MAX] = {
+	[PKT_CLS_NEXT_PKT_DROP] = PKT_CLS_NEXT_PKT_DROP,
+	[PKT_CLS_NEXT_IP4_LOOKUP] = PKT_CLS_NEXT_IP4_LOOKUP,
+	[PKT_CLS_NEXT_IP6_LOOKUP] = PKT_CLS_NEXT_IP6_LOOKUP,
+	[PKT_CLS_NEXT_IP4_LOOKUP_FIB] = PKT_CLS_NEXT_IP4_LOOKUP_FIB,
+	[PKT_CLS_NEXT_IP6_LOOKUP_FIB] = PKT_CLS_NEXT_IP6_LOOKUP_FIB,
+};
+
+void
+pkt_cls_next_update(enum pkt_cls_next_nodes from, enum pkt_cls_next_nodes to)
+{
+	/* Control path only, applies to the graphs created afterwards */
+	next_redirect[from] = to;
+}
+
+/* Enqueue objs to the next nodes of their l2l3 types */
+static __rte_always_inline uint16_t
+pkt_cls_node_enqueue(struct rte_graph *graph, struct rte_node *node,
+		     void **objs, const uint8_t *types, uint16_t nb_objs)
+{
+	struct pkt_cls_node_ctx *ctx = (struct pkt_cls_node_ctx *)node->ctx;
+	const uint8_t *p_nxt = ctx->p_nxt;
+	uint16_t next_index, next, held = 0;
+	void **to_next;
+	uint16_t i;
+
+	/* Speculate on the next node of the first object */
+	next_index = p_nxt[types[0]];
+	ctx->l2l3_type = types[0];
+	for (i = 1; i < nb_objs; i++)
+		if (p_nxt[types[i]] != next_index)
+			break;
+
+	/* !!! Home run !!! */
+	if (likely(i == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	rte_memcpy(to_next, objs, i * sizeof(objs[0]));
+	held = i;
+	for (; i < nb_objs; i++) {
+		next = p_nxt[types[i]];
+		if (likely(next == next_index))
+			to_next[held++] = objs[i];
+		else
+			rte_node_enqueue_x1(graph, node, next, objs[i]);
+	}
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+static uint16_t pkt_cls_node_process(struct rte_graph *graph,
+				     struct rte_node *node, void **objs,
+				     uint16_t nb_objs);
+
+#if defined(__ARM_NEON)
+#include "pkt_cls_neon.h"
+#elif defined(RTE_ARCH_X86)
+#include "pkt_cls_sse.h"
+#endif
+
 static uint16_t
 pkt_cls_node_process(struct rte_graph *graph, struct rte_node *node,
 		     void **objs, uint16_t nb_objs)
@@ -49,6 +116,7 @@ pkt_cls_node_process(struct rte_graph *graph, struct rte_node *node,
 	uint16_t held = 0, last_spec = 0;
 	struct pkt_cls_node_ctx *ctx;
 	void **to_next, **from;
+	const uint8_t *p_nxt;
 	uint32_t i;
 
 	pkts = (struct rte_mbuf **)objs;
@@ -64,6 +132,7 @@ pkt_cls_node_process(struct rte_graph *graph, struct rte_node *node,
 #endif
 
 	ctx = (struct pkt_cls_node_ctx *)node->ctx;
+	p_nxt = ctx->p_nxt;
 	last_type = ctx->l2l3_type;
 	next_index = p_nxt[last_type];
 
@@ -219,17 +288,60 @@ pkt_cls_node_process(struct rte_graph *graph, struct rte_node *node,
 	return nb_objs;
 }
 
+static int
+pkt_cls_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct pkt_cls_node_ctx *ctx = (struct pkt_cls_node_ctx *)node->ctx;
+	uint8_t *p_nxt;
+	unsigned int i;
+
+	RTE_BUILD_BUG_ON(sizeof(struct pkt_cls_node_ctx) > RTE_NODE_CTX_SZ);
+
+	/* Each graph classifies with its own copy of the ptype table */
+	p_nxt = rte_malloc_socket("pkt_cls", sizeof(p_nxt_default),
+				  RTE_CACHE_LINE_SIZE, graph->socket);
+	if (p_nxt == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i < RTE_DIM(p_nxt_default); i++)
+		p_nxt[i] = next_redirect[p_nxt_default[i]];
+	ctx->p_nxt = p_nxt;
+
+#if defined(__ARM_NEON) || defined(RTE_ARCH_X86)
+	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128)
+		node->process = pkt_cls_node_process_vec;
+#endif
+
+	return 0;
+}
+
+static void
+pkt_cls_node_fini(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct pkt_cls_node_ctx *ctx = (struct pkt_cls_node_ctx *)node->ctx;
+
+	RTE_SET_USED(graph);
+
+	rte_free((void *)(uintptr_t)ctx->p_nxt);
+	ctx->p_nxt = NULL;
+}
+
 /* Packet Classification Node */
 struct rte_node_register pkt_cls_node = {
 	.process = pkt_cls_node_process,
 	.name = "pkt_cls",
 
+	.init = pkt_cls_node_init,
+	.fini = pkt_cls_node_fini,
+
 	.nb_edges = PKT_CLS_NEXT_MAX,
 	.next_nodes = {
 		/* Pkt drop node starts at '0' */
 		[PKT_CLS_NEXT_PKT_DROP] = "pkt_drop",
 		[PKT_CLS_NEXT_IP4_LOOKUP] = "ip4_lookup",
 		[PKT_CLS_NEXT_IP6_LOOKUP] = "ip6_lookup",
+		[PKT_CLS_NEXT_IP4_LOOKUP_FIB] = "ip4_lookup_fib",
+		[PKT_CLS_NEXT_IP6_LOOKUP_FIB] = "ip6_lookup_fib",
 	},
 };
 RTE_NODE_REGISTER(pkt_cls_node);
@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef __INCLUDE_PKT_CLS_NEON_H__
+#define __INCLUDE_PKT_CLS_NEON_H__
+
+/* ARM64 NEON */
+static uint16_t
+pkt_cls_node_process_vec(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t nb_objs)
+{
+	const uint32_t l2l3_mask = RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK;
+	const uint32x4_t mask = vdupq_n_u32(l2l3_mask);
+	struct pkt_cls_node_ctx *ctx = (struct pkt_cls_node_ctx *)node->ctx;
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	uint8_t types[RTE_GRAPH_BURST_SIZE];
+	uint32x4_t first, diff, t0, t1;
+	uint32_t first_type, sdiff;
+	uint64x2_t any;
+	uint16_t i;
+#if RTE_GRAPH_BURST_SIZE > 64
+	uint16_t j;
+#endif
+
+	/* Streams grown past a burst don't fit in types[] */
+	if (unlikely(nb_objs > RTE_GRAPH_BURST_SIZE))
+		return pkt_cls_node_process(graph, node, objs, nb_objs);
+
+	for (i = OBJS_PER_CLINE; i < RTE_GRAPH_BURST_SIZE; i += OBJS_PER_CLINE)
+		rte_prefetch0(&objs[i]);
+
+	first_type = pkts[0]->packet_type & l2l3_mask;
+	first = vdupq_n_u32(first_type);
+	diff = vdupq_n_u32(0);
+	sdiff = 0;
+
+	/* Extract the l2l3 types of eight objects at a time */
+	for (i = 0; i + 8 <= nb_objs; i += 8) {
+#if RTE_GRAPH_BURST_SIZE > 64
+		if (likely(i + 16 <= nb_objs)) {
+			for (j = 8; j < 16; j++)
+				rte_prefetch0(pkts[i + j]);
+		}
+#endif
+		t0 = vdupq_n_u32(pkts[i + 0]->packet_type);
+		t0 = vsetq_lane_u32(pkts[i + 1]->packet_type, t0, 1);
+		t0 = vsetq_lane_u32(pkts[i + 2]->packet_type, t0, 2);
+		t0 = vsetq_lane_u32(pkts[i + 3]->packet_type, t0, 3);
+		t1 = vdupq_n_u32(pkts[i + 4]->packet_type);
+		t1 = vsetq_lane_u32(pkts[i + 5]->packet_type, t1, 1);
+		t1 = vsetq_lane_u32(pkts[i + 6]->packet_type, t1, 2);
+		t1 = vsetq_lane_u32(pkts[i + 7]->packet_type, t1, 3);
+		t0 = vandq_u32(t0, mask);
+		t1 = vandq_u32(t1, mask);
+
+		/* Track whether any type differs from the first one */
+		diff = vorrq_u32(diff, veorq_u32(t0, first));
+		diff = vorrq_u32(diff, veorq_u32(t1, first));
+
+		/* Types fit in a byte, narrow 8 x 32 bit down to 8 x 8 bit */
+		vst1_u8(&types[i], vmovn_u16(vcombine_u16(vmovn_u32(t0),
+							  vmovn_u32(t1))));
+	}
+
+	for (; i < nb_objs; i++) {
+		types[i] = pkts[i]->packet_type & l2l3_mask;
+		sdiff |= types[i] ^ first_type;
+	}
+
+	/* Whole burst of the same type, move the stream as is */
+	any = vreinterpretq_u64_u32(diff);
+	if (likely(!sdiff && !(vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)))) {
+		ctx->l2l3_type = first_type;
+		rte_node_next_stream_move(graph, node, ctx->p_nxt[first_type]);
+		return nb_objs;
+	}
+
+	return pkt_cls_node_enqueue(graph, node, objs, types, nb_objs);
+}
+
+#endif /* __INCLUDE_PKT_CLS_NEON_H__ */
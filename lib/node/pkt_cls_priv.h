@@ -7,6 +7,8 @@
 #include <rte_common.h>
 
 struct pkt_cls_node_ctx {
+	/* Next node for each ptype, owned by the graph */
+	const uint8_t *p_nxt;
 	uint16_t l2l3_type;
 };
 
@@ -14,7 +16,14 @@ enum pkt_cls_next_nodes {
 	PKT_CLS_NEXT_PKT_DROP,
 	PKT_CLS_NEXT_IP4_LOOKUP,
 	PKT_CLS_NEXT_IP6_LOOKUP,
+	PKT_CLS_NEXT_IP4_LOOKUP_FIB,
+	PKT_CLS_NEXT_IP6_LOOKUP_FIB,
 	PKT_CLS_NEXT_MAX,
 };
 
+/* Redirect every ptype classified to 'from' towards 'to' next node, in the
+ * pkt_cls nodes of the graphs created afterwards.
+ */
+void pkt_cls_next_update(enum pkt_cls_next_nodes from, enum pkt_cls_next_nodes to);
+
 #endif /* __INCLUDE_PKT_CLS_PRIV_H__ */
@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef __INCLUDE_PKT_CLS_SSE_H__
+#define __INCLUDE_PKT_CLS_SSE_H__
+
+/* X86 SSE */
+static uint16_t
+pkt_cls_node_process_vec(struct rte_graph *graph, struct rte_node *node,
+			 void **objs, uint16_t nb_objs)
+{
+	const uint32_t l2l3_mask = RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK;
+	const __m128i mask = _mm_set1_epi32(l2l3_mask);
+	struct pkt_cls_node_ctx *ctx = (struct pkt_cls_node_ctx *)node->ctx;
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	uint8_t types[RTE_GRAPH_BURST_SIZE];
+	__m128i first, diff, t0, t1;
+	uint32_t first_type, sdiff;
+	uint16_t i;
+#if RTE_GRAPH_BURST_SIZE > 64
+	uint16_t j;
+#endif
+
+	/* Streams grown past a burst don't fit in types[] */
+	if (unlikely(nb_objs > RTE_GRAPH_BURST_SIZE))
+		return pkt_cls_node_process(graph, node, objs, nb_objs);
+
+	for (i = OBJS_PER_CLINE; i < RTE_GRAPH_BURST_SIZE; i += OBJS_PER_CLINE)
+		rte_prefetch0(&objs[i]);
+
+	first_type = pkts[0]->packet_type & l2l3_mask;
+	first = _mm_set1_epi32(first_type);
+	diff = _mm_setzero_si128();
+	sdiff = 0;
+
+	/* Extract the l2l3 types of eight objects at a time */
+	for (i = 0; i + 8 <= nb_objs; i += 8) {
+#if RTE_GRAPH_BURST_SIZE > 64
+		if (likely(i + 16 <= nb_objs)) {
+			for (j = 8; j < 16; j++)
+				rte_prefetch0(pkts[i + j]);
+		}
+#endif
+		t0 = _mm_set_epi32(pkts[i + 3]->packet_type,
+				   pkts[i + 2]->packet_type,
+				   pkts[i + 1]->packet_type,
+				   pkts[i + 0]->packet_type);
+		t1 = _mm_set_epi32(pkts[i + 7]->packet_type,
+				   pkts[i + 6]->packet_type,
+				   pkts[i + 5]->packet_type,
+				   pkts[i + 4]->packet_type);
+		t0 = _mm_and_si128(t0, mask);
+		t1 = _mm_and_si128(t1, mask);
+
+		/* Track whether any type differs from the first one */
+		diff = _mm_or_si128(diff, _mm_xor_si128(t0, first));
+		diff = _mm_or_si128(diff, _mm_xor_si128(t1, first));
+
+		/* Types fit in a byte, narrow 8 x 32 bit down to 8 x 8 bit */
+		t0 = _mm_packs_epi32(t0, t1);
+		t0 = _mm_packus_epi16(t0, t0);
+		_mm_storel_epi64((__m128i *)&types[i], t0);
+	}
+
+	for (; i < nb_objs; i++) {
+		types[i] = pkts[i]->packet_type & l2l3_mask;
+		sdiff |= types[i] ^ first_type;
+	}
+
+	/* Whole burst of the same type, move the stream as is */
+	if (likely(!sdiff && _mm_movemask_epi8(_mm_cmpeq_epi32(
+			diff, _mm_setzero_si128())) == 0xFFFF)) {
+		ctx->l2l3_type = first_type;
+		rte_node_next_stream_move(graph, node, ctx->p_nxt[first_type]);
+		return nb_objs;
+	}
+
+	return pkt_cls_node_enqueue(graph, node, objs, types, nb_objs);
+}
+
+#endif /* __INCLUDE_PKT_CLS_SSE_H__ */
@@ -57,6 +57,41 @@ struct rte_node_ethdev_config {
  */
 int rte_node_eth_config(struct rte_node_ethdev_config *cfg,
 			uint16_t cnt, uint16_t nb_graphs);
+
+/**
+ * Rx queue polled by a multi-queue ethdev_rx node.
+ */
+struct rte_node_ethdev_rx_queue {
+	uint16_t port_id;
+	/**< Port identifier. */
+	uint16_t queue_id;
+	/**< Rx queue identifier. */
+	uint16_t weight;
+	/**< Bursts polled in a row from the queue, 0 is treated as 1. */
+};
+
+/**
+ * Create a multi-queue ethdev_rx node.
+ *
+ * Clones a node named ``ethdev_rx_mq-<name>`` which polls the given Rx queues
+ * in a weighted round robin, instead of one ethdev_rx node per queue. Each
+ * burst is kept one graph walk ahead so its packet headers are prefetched
+ * while the previous burst is being processed.
+ *
+ * @param name
+ *   Suffix of the cloned node name.
+ * @param queues
+ *   Array of Rx queues to poll, the ports must be configured.
+ * @param nb_queues
+ *   Size of queues array.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_eth_rx_mq_config(const char *name,
+			      const struct rte_node_ethdev_rx_queue *queues,
+			      uint16_t nb_queues);
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,7 @@ extern "C" {
 #include <rte_common.h>
 #include <rte_compat.h>
 
+#include <rte_fib.h>
 #include <rte_graph.h>
 
 /**
@@ -85,6 +86,44 @@ struct rte_node_ip4_reassembly_cfg {
 int rte_node_ip4_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
 			   enum rte_node_ip4_lookup_next next_node);
 
+/**
+ * Create ipv4 FIB table for ip4_lookup_fib node on a given socket.
+ *
+ * Once a FIB is created, IPv4 packets classified by pkt_cls node are
+ * steered to ip4_lookup_fib node instead of LPM based ip4_lookup node.
+ * It must be called before graphs using the node are created.
+ *
+ * @param socket
+ *   NUMA socket to create the FIB table on.
+ * @param conf
+ *   FIB configuration. DIR24_8 next hop size must be at least
+ *   RTE_FIB_DIR24_8_4B. Default next hop is overridden to drop.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_fib_create(int socket, struct rte_fib_conf *conf);
+
+/**
+ * Add ipv4 route to FIB table of ip4_lookup_fib node.
+ *
+ * @param ip
+ *   IP address of route to be added.
+ * @param depth
+ *   Depth of the rule to be added.
+ * @param next_hop
+ *   Next hop id of the rule result to be added.
+ * @param next_node
+ *   Next node to redirect traffic to.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_fib_route_add(uint32_t ip, uint8_t depth, uint16_t next_hop,
+			       enum rte_node_ip4_lookup_next next_node);
+
 /**
  * Add a next hop's rewrite data.
  *
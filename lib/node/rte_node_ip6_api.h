@@ -13,7 +13,7 @@
  * All functions in this file may be changed or removed without prior notice.
  *
  * This API allows to do control path functions of ip6_* nodes
- * like ip6_lookup, ip6_rewrite.
+ * like ip6_lookup, ip6_rewrite, ip6_reassembly.
  */
 #ifdef __cplusplus
 extern "C" {
@@ -22,16 +22,52 @@ extern "C" {
 #include <rte_common.h>
 #include <rte_compat.h>
 
+#include <rte_fib6.h>
+#include <rte_graph.h>
+
 /**
  * IP6 lookup next nodes.
  */
 enum rte_node_ip6_lookup_next {
 	RTE_NODE_IP6_LOOKUP_NEXT_REWRITE,
 	/**< Rewrite node. */
+	RTE_NODE_IP6_LOOKUP_NEXT_IP6_LOCAL,
+	/**< IP6 Local node. */
 	RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP,
 	/**< Packet drop node. */
 };
 
+/**
+ * IP6 Local next nodes.
+ */
+enum rte_node_ip6_local_next {
+	RTE_NODE_IP6_LOCAL_NEXT_UDP6_INPUT,
+	/**< UDP6 input node. */
+	RTE_NODE_IP6_LOCAL_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * IP6 reassembly next nodes.
+ */
+enum rte_node_ip6_reassembly_next {
+	RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * Reassembly configure structure.
+ * @see rte_node_ip6_reassembly_configure
+ */
+struct rte_node_ip6_reassembly_cfg {
+	struct rte_ip_frag_tbl *tbl;
+	/**< Reassembly fragmentation table. */
+	struct rte_ip_frag_death_row *dr;
+	/**< Reassembly deathrow table. */
+	rte_node_t node_id;
+	/**< Node identifier to configure. */
+};
+
 /**
  * Add IPv6 route to lookup table.
  *
@@ -51,6 +87,44 @@ __rte_experimental
 int rte_node_ip6_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
 			   enum rte_node_ip6_lookup_next next_node);
 
+/**
+ * Create IPv6 FIB table for ip6_lookup_fib node on a given socket.
+ *
+ * Once a FIB is created, IPv6 packets classified by pkt_cls node are
+ * steered to ip6_lookup_fib node instead of LPM based ip6_lookup node.
+ * It must be called before graphs using the node are created.
+ *
+ * @param socket
+ *   NUMA socket to create the FIB table on.
+ * @param conf
+ *   FIB configuration. TRIE next hop size must be at least
+ *   RTE_FIB6_TRIE_4B. Default next hop is overridden to drop.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_fib_create(int socket, struct rte_fib6_conf *conf);
+
+/**
+ * Add IPv6 route to FIB table of ip6_lookup_fib node.
+ *
+ * @param ip
+ *   IPv6 address of route to be added.
+ * @param depth
+ *   Depth of the rule to be added.
+ * @param next_hop
+ *   Next hop id of the rule result to be added.
+ * @param next_node
+ *   Next node to redirect traffic to.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_fib_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
+			       enum rte_node_ip6_lookup_next next_node);
+
 /**
  * Add a next hop's rewrite data.
  *
@@ -70,6 +144,23 @@ __rte_experimental
 int rte_node_ip6_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 			     uint8_t rewrite_len, uint16_t dst_port);
 
+/**
+ * Add reassembly node configuration data.
+ *
+ * Fragments reassembled, timed out and dropped by each configured node are
+ * reported by the ``/node/ip6_reassembly/stats`` telemetry command.
+ *
+ * @param cfg
+ *   Pointer to the configuration structure.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_reassembly_configure(struct rte_node_ip6_reassembly_cfg *cfg, uint16_t cnt);
+
 #ifdef __cplusplus
 }
 #endif
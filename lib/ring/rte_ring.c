@@ -15,11 +15,14 @@
 #include <sys/queue.h>
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_log.h>
 #include <rte_memzone.h>
 #include <rte_malloc.h>
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
+#include <rte_pause.h>
+#include <rte_power_intrinsics.h>
 #include <rte_string_fns.h>
 #include <rte_tailq.h>
 
@@ -418,3 +421,64 @@ rte_ring_lookup(const char *name)
 
 	return r;
 }
+
+/* Abort the power monitor wait if the producer tail moved */
+static int
+ring_wait_monitor_cb(const uint64_t val,
+		const uint64_t opaque[RTE_POWER_MONITOR_OPAQUE_SZ])
+{
+	return val == opaque[0] ? 0 : -1;
+}
+
+static int
+ring_wait_monitor(const struct rte_power_monitor_cond *pmc, uint64_t deadline)
+{
+#ifdef RTE_EXEC_ENV_WINDOWS
+	RTE_SET_USED(pmc);
+	RTE_SET_USED(deadline);
+	return -ENOTSUP;
+#else
+	return rte_power_monitor(pmc, deadline);
+#endif
+}
+
+int
+rte_ring_wait(struct rte_ring *r, unsigned int n, uint64_t timeout)
+{
+	struct rte_power_monitor_cond pmc;
+	uint32_t prod_tail, count;
+	uint64_t now, deadline;
+	bool monitor = true;
+
+	if (r == NULL || n == 0 || n > r->capacity)
+		return -EINVAL;
+
+	now = rte_get_tsc_cycles();
+	deadline = timeout > UINT64_MAX - now ? UINT64_MAX : now + timeout;
+
+	/* The producer tail has the same location in all sync modes */
+	pmc.addr = &r->prod.tail;
+	pmc.size = sizeof(r->prod.tail);
+	pmc.fn = ring_wait_monitor_cb;
+
+	for (;;) {
+		prod_tail = rte_atomic_load_explicit(&r->prod.tail,
+				rte_memory_order_acquire);
+		count = (prod_tail - r->cons.tail) & r->mask;
+		if (count >= n && count <= r->capacity)
+			return 0;
+		if (rte_get_tsc_cycles() >= deadline)
+			return -ETIMEDOUT;
+
+		/*
+		 * The callback reads the producer tail again once the monitor
+		 * is armed: an enqueue completed since the load above aborts
+		 * the wait instead of being missed.
+		 */
+		pmc.opaque[0] = prod_tail;
+		if (monitor && ring_wait_monitor(&pmc, deadline) == -ENOTSUP)
+			monitor = false;
+		if (!monitor)
+			rte_pause();
+	}
+}
@@ -38,6 +38,7 @@
 extern "C" {
 #endif
 
+#include <rte_compat.h>
 #include <rte_ring_core.h>
 #include <rte_ring_elem.h>
 
@@ -815,6 +816,38 @@ rte_ring_dequeue_burst(struct rte_ring *r, void **obj_table,
 			n, available);
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Wait for entries to be available in a ring.
+ *
+ * Instead of busy polling an empty ring, the calling lcore monitors the
+ * producer tail of the ring with rte_power_monitor(), entering an
+ * optimized power state until a producer completes an enqueue, or until
+ * the timeout expires. Where the power monitor is not supported, the
+ * wait falls back to polling with rte_pause().
+ *
+ * The lcore may be woken up by other writes in the cache line of the
+ * producer tail, in which case it goes back to wait; the entries can
+ * also be taken by another consumer before the call returns.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of entries to wait for, between 1 and the ring capacity.
+ * @param timeout
+ *   The maximum time to wait, in TSC cycles (see rte_get_tsc_hz()).
+ *   UINT64_MAX waits without timeout.
+ * @return
+ *   - 0: at least n entries are in the ring.
+ *   - -EINVAL: r is NULL or n is out of range.
+ *   - -ETIMEDOUT: less than n entries are in the ring after the timeout.
+ */
+__rte_experimental
+int
+rte_ring_wait(struct rte_ring *r, unsigned int n, uint64_t timeout);
+
 #ifdef __cplusplus
 }
 #endif
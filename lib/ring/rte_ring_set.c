@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_common.h>
+
+#include "rte_ring_set.h"
+
+int
+rte_ring_set_init(struct rte_ring_set *set)
+{
+	if (set == NULL)
+		return -EINVAL;
+
+	memset(set, 0, sizeof(*set));
+	return 0;
+}
+
+int
+rte_ring_set_add(struct rte_ring_set *set, struct rte_ring *r,
+		unsigned int weight)
+{
+	unsigned int i;
+
+	if (set == NULL || r == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < set->nb_rings; i++)
+		if (set->rings[i].r == r)
+			return -EEXIST;
+
+	if (set->nb_rings == RTE_RING_SET_MAX_RINGS)
+		return -ENOSPC;
+
+	i = set->nb_rings;
+	set->rings[i].r = r;
+	set->rings[i].weight = weight != 0 ? weight :
+		RTE_RING_SET_DEFAULT_WEIGHT;
+	/* Not known to be empty yet, the first dequeue checks it */
+	set->rings[i].prod_tail = 0;
+	set->empty &= ~RTE_BIT64(i);
+	set->nb_rings++;
+
+	return i;
+}
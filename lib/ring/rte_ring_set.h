@@ -0,0 +1,210 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef _RTE_RING_SET_H_
+#define _RTE_RING_SET_H_
+
+/**
+ * @file
+ * RTE Ring Set
+ *
+ * A ring set lets a consumer poll many rings with a single call.
+ * rte_ring_set_dequeue_burst() first loads the producer tail of every
+ * ring of the set, so that the loads are issued back to back, and skips
+ * the rings whose producer tail did not move since they were last found
+ * empty. Only the rings with objects pay for a dequeue.
+ *
+ * The rings with objects are served in round-robin order, each of them
+ * giving at most its weight of objects per round, until the requested
+ * number of objects is reached. The next call resumes with the ring
+ * following the last one served, so that no ring is starved when the
+ * consumer cannot keep up.
+ *
+ * A ring set is not thread-safe: it is owned by one consumer thread.
+ * The rings themselves keep their own synchronization mode, and may be
+ * dequeued from outside of the set as well.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_bitops.h>
+#include <rte_compat.h>
+#include <rte_ring_elem.h>
+
+/** Maximum number of rings in a ring set. */
+#define RTE_RING_SET_MAX_RINGS 64
+
+/** Weight of a ring added with a zero weight. */
+#define RTE_RING_SET_DEFAULT_WEIGHT 32
+
+/**
+ * @internal A ring of a ring set.
+ */
+struct rte_ring_set_entry {
+	struct rte_ring *r;  /**< Ring to dequeue from. */
+	uint32_t prod_tail;  /**< Producer tail when the ring was found empty. */
+	uint32_t weight;     /**< Maximum number of objects per round. */
+};
+
+/**
+ * A set of rings polled by one consumer.
+ */
+struct rte_ring_set {
+	uint64_t empty;      /**< Bitmap of the rings found empty. */
+	uint32_t nb_rings;   /**< Number of rings in the set. */
+	uint32_t next;       /**< Ring to serve first on next dequeue. */
+	/** Rings of the set. */
+	struct rte_ring_set_entry rings[RTE_RING_SET_MAX_RINGS];
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize an empty ring set.
+ *
+ * @param set
+ *   A pointer to the ring set structure.
+ * @return
+ *   0 on success, -EINVAL if set is NULL.
+ */
+__rte_experimental
+int rte_ring_set_init(struct rte_ring_set *set);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add a ring to a ring set.
+ *
+ * All the rings of a set must have the element size given to
+ * rte_ring_set_dequeue_burst_elem().
+ *
+ * @param set
+ *   A pointer to the ring set structure.
+ * @param r
+ *   A pointer to the ring to add.
+ * @param weight
+ *   The maximum number of objects dequeued from this ring before moving
+ *   to the next ring of the set. Zero selects RTE_RING_SET_DEFAULT_WEIGHT.
+ *   Equal weights give a plain round-robin between the rings.
+ * @return
+ *   - The index of the ring in the set on success.
+ *   - -EINVAL: set or r is NULL.
+ *   - -EEXIST: the ring is already in the set.
+ *   - -ENOSPC: the set already has RTE_RING_SET_MAX_RINGS rings.
+ */
+__rte_experimental
+int rte_ring_set_add(struct rte_ring_set *set, struct rte_ring *r,
+		unsigned int weight);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue objects from the rings of a set up to a maximum number.
+ *
+ * @param set
+ *   A pointer to the ring set structure.
+ * @param obj_table
+ *   A pointer to a table of objects that will be filled.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the rings. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to dequeue from the rings to the obj_table.
+ * @return
+ *   - Number of objects dequeued
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_dequeue_burst_elem(struct rte_ring_set *set, void *obj_table,
+		unsigned int esize, unsigned int n)
+{
+	uint32_t tails[RTE_RING_SET_MAX_RINGS];
+	struct rte_ring_set_entry *e;
+	uint64_t pending, mask;
+	unsigned int i, got, avail, count;
+
+	/*
+	 * Load all the producer tails first, the dequeue re-reads the one
+	 * of the rings with objects with the required ordering.
+	 */
+	pending = 0;
+	for (i = 0; i < set->nb_rings; i++) {
+		tails[i] = rte_atomic_load_explicit(
+				&set->rings[i].r->prod.tail,
+				rte_memory_order_relaxed);
+		if ((set->empty & RTE_BIT64(i)) == 0 ||
+				tails[i] != set->rings[i].prod_tail)
+			pending |= RTE_BIT64(i);
+	}
+
+	count = 0;
+	i = set->next;
+	while (pending != 0 && count < n) {
+		/* Next ring with objects, in round-robin order */
+		mask = pending & (UINT64_MAX << i);
+		i = rte_ctz64(mask != 0 ? mask : pending);
+		e = &set->rings[i];
+
+		got = rte_ring_dequeue_burst_elem(e->r,
+				RTE_PTR_ADD(obj_table, (size_t)count * esize),
+				esize, RTE_MIN(e->weight, n - count), &avail);
+		count += got;
+
+		/*
+		 * The ring was drained up to a producer tail not older than
+		 * the one loaded above: it stays empty as long as the
+		 * producer tail does not move.
+		 */
+		if (avail == 0) {
+			pending &= ~RTE_BIT64(i);
+			set->empty |= RTE_BIT64(i);
+			e->prod_tail = tails[i];
+		} else {
+			set->empty &= ~RTE_BIT64(i);
+		}
+
+		if (++i == set->nb_rings)
+			i = 0;
+	}
+	set->next = i;
+
+	return count;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue pointers to objects from the rings of a set up to a maximum
+ * number.
+ *
+ * @param set
+ *   A pointer to the ring set structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to dequeue from the rings to the obj_table.
+ * @return
+ *   - Number of objects dequeued
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_dequeue_burst(struct rte_ring_set *set, void **obj_table,
+		unsigned int n)
+{
+	return rte_ring_set_dequeue_burst_elem(set, obj_table,
+			sizeof(void *), n);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_SET_H_ */
@@ -317,6 +317,10 @@ struct vhost_virtqueue {
 	bool			used_wrap_counter;
 	bool			avail_wrap_counter;
 
+	/* Dequeue mbufs initialization, for the last mempool used */
+	struct rte_mempool	*mbuf_tmpl_pool;
+	struct rte_mbuf_rearm_template mbuf_tmpl;
+
 	/* Physical address of used ring, for logging */
 	uint16_t		log_cache_nb_elem;
 	uint64_t		log_guest_addr;
@@ -3052,6 +3052,23 @@ virtio_dev_extbuf_alloc(struct virtio_net *dev, struct rte_mbuf *pkt, uint32_t s
 	return 0;
 }
 
+/*
+ * Allocate the mbufs of a dequeue burst, reset as rte_pktmbuf_alloc() does.
+ */
+static __rte_always_inline int
+virtio_dev_pktmbuf_alloc_bulk(struct vhost_virtqueue *vq,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint32_t count)
+{
+	if (unlikely(vq->mbuf_tmpl_pool != mbuf_pool)) {
+		if (rte_pktmbuf_rearm_template_init(&vq->mbuf_tmpl, mbuf_pool,
+				RTE_MBUF_PORT_INVALID) != 0)
+			return rte_pktmbuf_alloc_bulk(mbuf_pool, pkts, count);
+		vq->mbuf_tmpl_pool = mbuf_pool;
+	}
+
+	return rte_pktmbuf_alloc_bulk_rearm(mbuf_pool, pkts, count, &vq->mbuf_tmpl);
+}
+
 /*
  * Prepare a host supported pktmbuf.
  */
@@ -3103,7 +3120,7 @@ virtio_dev_tx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	count = RTE_MIN(count, avail_entries);
 	VHOST_LOG_DATA(dev->ifname, DEBUG, "about to dequeue %u buffers\n", count);
 
-	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts, count))
+	if (virtio_dev_pktmbuf_alloc_bulk(vq, mbuf_pool, pkts, count))
 		return 0;
 
 	for (i = 0; i < count; i++) {
@@ -3485,7 +3502,7 @@ virtio_dev_tx_packed(struct virtio_net *dev,
 {
 	uint32_t pkt_idx = 0;
 
-	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts, count))
+	if (virtio_dev_pktmbuf_alloc_bulk(vq, mbuf_pool, pkts, count))
 		return 0;
 
 	do {
@@ -3733,7 +3750,7 @@ virtio_dev_tx_async_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	count = RTE_MIN(count, avail_entries);
 	VHOST_LOG_DATA(dev->ifname, DEBUG, "about to dequeue %u buffers\n", count);
 
-	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, count))
+	if (virtio_dev_pktmbuf_alloc_bulk(vq, mbuf_pool, pkts_prealloc, count))
 		goto out;
 
 	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
@@ -4023,7 +4040,7 @@ virtio_dev_tx_async_packed(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	async_iter_reset(async);
 
-	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, count))
+	if (virtio_dev_pktmbuf_alloc_bulk(vq, mbuf_pool, pkts_prealloc, count))
 		goto out;
 
 	do {